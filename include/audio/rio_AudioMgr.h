@@ -2,9 +2,7 @@
 #define RIO_AUDIO_MANAGER_H
 
 #include <audio/rio_AudioSrc.h>
-
-#include <map>
-#include <string>
+#include <container/rio_StringMap.h>
 
 namespace rio {
 
@@ -25,11 +23,16 @@ private:
     AudioMgr& operator=(const AudioMgr&);
 
 public:
-    bool loadBgm(const char* fname, const char* key, AudioBgm::FileFormat format = AudioBgm::FORMAT_AUTO);
-    AudioBgm* getBgm(const char* key) const;
+    bool loadBgm(const char* fname, const HashedString& key, AudioBgm::FileFormat format = AudioBgm::FORMAT_AUTO);
+    AudioBgm* getBgm(const HashedString& key) const;
+    // Free the music loaded with "key" (Streamed, so not cached)
+    void unloadBgm(const HashedString& key);
 
-    bool loadSfx(const char* fname, const char* key);
-    AudioSfx* getSfx(const char* key) const;
+    // Sound effects are kept in the ResourceCache, referenced once per key they are loaded with
+    bool loadSfx(const char* fname, const HashedString& key);
+    AudioSfx* getSfx(const HashedString& key) const;
+    // Release the sound effect loaded with "key", which stays cached until it is evicted
+    void unloadSfx(const HashedString& key);
 
     void setListenerPosition(const Vector3f& pos);
     void setListenerLookAt(const Vector3f& look_at);
@@ -87,10 +90,13 @@ private:
     void calcListenerFront_();
     void calcListenerRight_();
 
+    static void destroyBgm_(AudioBgm* src);
+    static void destroySfx_(void* src);
+
 private:
     bool mIsInitialized;
-    std::map<std::string, AudioBgm*> mAudioBgmCache;
-    std::map<std::string, AudioSfx*> mAudioSfxCache;
+    StringMap<AudioBgm*> mAudioBgmCache;
+    StringMap<AudioSfx*> mAudioSfxCache;
 
     struct
     {
@@ -111,11 +117,14 @@ private:
 
 inline AudioMgr::~AudioMgr() { }
 
-inline bool AudioMgr::loadBgm(const char* fname, const char* key, AudioBgm::FileFormat format) { return false; }
-inline AudioBgm* AudioMgr::getBgm(const char* key) const { return nullptr; }
+inline bool AudioMgr::loadBgm(const char* fname, const HashedString& key, AudioBgm::FileFormat format) { return false; }
+inline AudioBgm* AudioMgr::getBgm(const HashedString& key) const { return nullptr; }
+
+inline void AudioMgr::unloadBgm(const HashedString& key) { }
 
-inline bool AudioMgr::loadSfx(const char* fname, const char* key) { return false; }
-inline AudioSfx* AudioMgr::getSfx(const char* key) const { return nullptr; }
+inline bool AudioMgr::loadSfx(const char* fname, const HashedString& key) { return false; }
+inline AudioSfx* AudioMgr::getSfx(const HashedString& key) const { return nullptr; }
+inline void AudioMgr::unloadSfx(const HashedString& key) { }
 
 inline void AudioMgr::setListenerPosition(const Vector3f& pos) { }
 inline void AudioMgr::setListenerLookAt(const Vector3f& look_at) { }
@@ -0,0 +1,168 @@
+#ifndef RIO_CNT_FIXED_VECTOR_H
+#define RIO_CNT_FIXED_VECTOR_H
+
+#include <misc/rio_Types.h>
+
+#include <new>
+#include <utility>
+
+namespace rio {
+
+template <typename T, s32 N>
+class FixedVector
+{
+    // Array of up to N objects of type T, stored inside the vector itself (No allocation)
+
+    static_assert(N > 0, "FixedVector capacity must be positive");
+
+public:
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+public:
+    FixedVector()
+        : mCount(0)
+    {
+    }
+
+    ~FixedVector()
+    {
+        clear();
+    }
+
+private:
+    // Disallow copying
+    FixedVector(const FixedVector&);
+    FixedVector& operator=(const FixedVector&);
+
+public:
+    // Is vector empty
+    bool isEmpty() const { return mCount == 0; }
+    // Is vector full
+    bool isFull() const { return mCount == N; }
+    // Get object count
+    s32 size() const { return mCount; }
+    // Get maximum object count
+    static constexpr s32 capacity() { return N; }
+
+    T* data() { return ptr_(0); }
+    const T* data() const { return ptr_(0); }
+
+    T& operator[](s32 index)
+    {
+        RIO_ASSERT(0 <= index && index < mCount);
+        return *ptr_(index);
+    }
+
+    const T& operator[](s32 index) const
+    {
+        RIO_ASSERT(0 <= index && index < mCount);
+        return *ptr_(index);
+    }
+
+    // Get object at index (Null if out of range)
+    T* at(s32 index) { return 0 <= index && index < mCount ? ptr_(index) : nullptr; }
+    const T* at(s32 index) const { return 0 <= index && index < mCount ? ptr_(index) : nullptr; }
+
+    // Get first object (Null if empty)
+    T* front() { return at(0); }
+    const T* front() const { return at(0); }
+    // Get last object (Null if empty)
+    T* back() { return at(mCount - 1); }
+    const T* back() const { return at(mCount - 1); }
+
+    // Construct an object at the back (Returns null if full)
+    template <typename... Args>
+    T* emplaceBack(Args&&... args)
+    {
+        if (isFull())
+            return nullptr;
+
+        T* obj = new (ptr_(mCount)) T(std::forward<Args>(args)...);
+        mCount++;
+        return obj;
+    }
+
+    // Push obj to back (Returns false if full)
+    bool pushBack(const T& obj) { return emplaceBack(obj) != nullptr; }
+    bool pushBack(T&& obj) { return emplaceBack(std::move(obj)) != nullptr; }
+
+    // Destroy the last object
+    void popBack()
+    {
+        RIO_ASSERT(mCount > 0);
+        mCount--;
+        ptr_(mCount)->~T();
+    }
+
+    // Insert obj at index, moving the following objects back (Returns false if full)
+    bool insert(s32 index, T obj)
+    {
+        RIO_ASSERT(0 <= index && index <= mCount);
+
+        if (isFull())
+            return false;
+
+        if (index == mCount)
+        {
+            new (ptr_(mCount)) T(std::move(obj));
+        }
+        else
+        {
+            new (ptr_(mCount)) T(std::move(*ptr_(mCount - 1)));
+            for (s32 i = mCount - 1; i > index; i--)
+                *ptr_(i) = std::move(*ptr_(i - 1));
+
+            *ptr_(index) = std::move(obj);
+        }
+
+        mCount++;
+        return true;
+    }
+
+    // Erase object at index, moving the following objects forward (Keeps the order)
+    void erase(s32 index)
+    {
+        RIO_ASSERT(0 <= index && index < mCount);
+
+        for (s32 i = index; i < mCount - 1; i++)
+            *ptr_(i) = std::move(*ptr_(i + 1));
+
+        popBack();
+    }
+
+    // Erase object at index, replacing it with the last object (Does not keep the order)
+    void eraseFast(s32 index)
+    {
+        RIO_ASSERT(0 <= index && index < mCount);
+
+        if (index != mCount - 1)
+            *ptr_(index) = std::move(*ptr_(mCount - 1));
+
+        popBack();
+    }
+
+    // Destroy all objects
+    void clear()
+    {
+        while (mCount > 0)
+            popBack();
+    }
+
+    iterator begin() { return ptr_(0); }
+    iterator end() { return ptr_(mCount); }
+    const_iterator begin() const { return ptr_(0); }
+    const_iterator end() const { return ptr_(mCount); }
+
+private:
+    T* ptr_(s32 index) { return std::launder(reinterpret_cast<T*>(mStorage)) + index; }
+    const T* ptr_(s32 index) const { return std::launder(reinterpret_cast<const T*>(mStorage)) + index; }
+
+private:
+    alignas(T) u8   mStorage[sizeof(T) * N];    // Object storage
+    s32             mCount;                     // Object count
+};
+
+}
+
+#endif // RIO_CNT_FIXED_VECTOR_H
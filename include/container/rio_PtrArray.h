@@ -0,0 +1,233 @@
+#ifndef RIO_CNT_PTR_ARRAY_H
+#define RIO_CNT_PTR_ARRAY_H
+
+#include <heap/rio_Heap.h>
+#include <misc/rio_MemUtil.h>
+
+#include <algorithm>
+
+namespace rio {
+
+template <typename T>
+class PtrArray
+{
+    // Fixed-capacity array of pointers to objects of type T, which it does not own.
+    // Its buffer is either allocated with allocBuffer() (From a given heap, or with MemUtil::alloc()), or provided
+    // with setBuffer(). Can be sorted and binary-searched by the objects' operator<, or by a given comparator.
+
+public:
+    typedef T** iterator;
+    typedef T* const* const_iterator;
+
+public:
+    PtrArray()
+        : mBuffer(nullptr)
+        , mCount(0)
+        , mCapacity(0)
+        , mOwnBuffer(false)
+    {
+    }
+
+    ~PtrArray()
+    {
+        freeBuffer();
+    }
+
+private:
+    // Disallow copying
+    PtrArray(const PtrArray&);
+    PtrArray& operator=(const PtrArray&);
+
+public:
+    // Allocate a buffer of "capacity" pointers from "heap" (Null = MemUtil::alloc())
+    bool allocBuffer(s32 capacity, Heap* heap = nullptr)
+    {
+        RIO_ASSERT(!mBuffer && capacity > 0);
+
+        const size_t size = sizeof(T*) * capacity;
+        void* buffer = heap ? heap->tryAlloc(size, alignof(T*)) : MemUtil::alloc(size, alignof(T*));
+        if (!buffer)
+            return false;
+
+        setBuffer(capacity, buffer);
+        mOwnBuffer = true;
+        return true;
+    }
+
+    // Use "buffer" (Of at least "capacity" pointers) as buffer, which the array does not free
+    void setBuffer(s32 capacity, void* buffer)
+    {
+        RIO_ASSERT(!mBuffer && capacity > 0 && buffer);
+
+        mBuffer = static_cast<T**>(buffer);
+        mCount = 0;
+        mCapacity = capacity;
+        mOwnBuffer = false;
+    }
+
+    // Release the buffer (If allocated by allocBuffer())
+    void freeBuffer()
+    {
+        if (mBuffer && mOwnBuffer)
+            MemUtil::free(mBuffer);
+
+        mBuffer = nullptr;
+        mCount = 0;
+        mCapacity = 0;
+        mOwnBuffer = false;
+    }
+
+    bool isBufferReady() const { return mBuffer != nullptr; }
+
+    // Is array empty
+    bool isEmpty() const { return mCount == 0; }
+    // Is array full
+    bool isFull() const { return mCount == mCapacity; }
+    // Get pointer count
+    s32 size() const { return mCount; }
+    // Get maximum pointer count
+    s32 capacity() const { return mCapacity; }
+
+    T* operator[](s32 index) const
+    {
+        RIO_ASSERT(0 <= index && index < mCount);
+        return mBuffer[index];
+    }
+
+    // Get pointer at index (Null if out of range)
+    T* at(s32 index) const { return 0 <= index && index < mCount ? mBuffer[index] : nullptr; }
+
+    // Get first pointer (Null if empty)
+    T* front() const { return at(0); }
+    // Get last pointer (Null if empty)
+    T* back() const { return at(mCount - 1); }
+
+    // Push ptr to back (Returns false if full)
+    bool pushBack(T* ptr)
+    {
+        if (isFull())
+            return false;
+
+        mBuffer[mCount++] = ptr;
+        return true;
+    }
+
+    // Pop pointer from back (Null if empty)
+    T* popBack()
+    {
+        if (isEmpty())
+            return nullptr;
+
+        return mBuffer[--mCount];
+    }
+
+    // Insert ptr at index, moving the following pointers back (Returns false if full)
+    bool insert(s32 index, T* ptr)
+    {
+        RIO_ASSERT(0 <= index && index <= mCount);
+
+        if (isFull())
+            return false;
+
+        std::copy_backward(mBuffer + index, mBuffer + mCount, mBuffer + mCount + 1);
+        mBuffer[index] = ptr;
+        mCount++;
+        return true;
+    }
+
+    // Erase pointer at index, moving the following pointers forward (Keeps the order)
+    void erase(s32 index)
+    {
+        RIO_ASSERT(0 <= index && index < mCount);
+
+        std::copy(mBuffer + index + 1, mBuffer + mCount, mBuffer + index);
+        mCount--;
+    }
+
+    // Erase pointer at index, replacing it with the last pointer (Does not keep the order)
+    void eraseFast(s32 index)
+    {
+        RIO_ASSERT(0 <= index && index < mCount);
+
+        mBuffer[index] = mBuffer[--mCount];
+    }
+
+    // Remove all pointers
+    void clear() { mCount = 0; }
+
+    // Get index of ptr (-1 if not in array)
+    s32 indexOf(const T* ptr) const
+    {
+        for (s32 i = 0; i < mCount; i++)
+            if (mBuffer[i] == ptr)
+                return i;
+
+        return -1;
+    }
+
+    // Sort by the objects' operator<
+    void sort()
+    {
+        sort([](const T* lhs, const T* rhs) { return *lhs < *rhs; });
+    }
+
+    // Sort by "cmp" (A strict weak ordering of two const T*)
+    template <typename Compare>
+    void sort(Compare cmp)
+    {
+        std::sort(mBuffer, mBuffer + mCount, cmp);
+    }
+
+    // Sort keeping the order of equal objects
+    template <typename Compare>
+    void stableSort(Compare cmp)
+    {
+        std::stable_sort(mBuffer, mBuffer + mCount, cmp);
+    }
+
+    // Index of the first object not less than "key" in a sorted array (size() if none)
+    s32 lowerBound(const T& key) const
+    {
+        return lowerBound(key, [](const T* lhs, const T& rhs) { return *lhs < rhs; });
+    }
+
+    // Same, with "cmp" comparing an element to the key (cmp(const T*, const Key&))
+    template <typename Key, typename Compare>
+    s32 lowerBound(const Key& key, Compare cmp) const
+    {
+        return std::lower_bound(mBuffer, mBuffer + mCount, key, cmp) - mBuffer;
+    }
+
+    // Index of an object equal to "key" in a sorted array (-1 if none)
+    s32 binarySearch(const T& key) const
+    {
+        const s32 index = lowerBound(key);
+        if (index < mCount && !(key < *mBuffer[index]))
+            return index;
+
+        return -1;
+    }
+
+    // Insert ptr after the objects not greater than it in a sorted array (Returns false if full)
+    bool insertSorted(T* ptr)
+    {
+        const s32 index = std::upper_bound(mBuffer, mBuffer + mCount, ptr,
+                                           [](const T* lhs, const T* rhs) { return *lhs < *rhs; }) - mBuffer;
+        return insert(index, ptr);
+    }
+
+    iterator begin() { return mBuffer; }
+    iterator end() { return mBuffer + mCount; }
+    const_iterator begin() const { return mBuffer; }
+    const_iterator end() const { return mBuffer + mCount; }
+
+private:
+    T**     mBuffer;        // Pointer buffer
+    s32     mCount;         // Pointer count
+    s32     mCapacity;      // Buffer capacity
+    bool    mOwnBuffer;     // Buffer allocated by allocBuffer()
+};
+
+}
+
+#endif // RIO_CNT_PTR_ARRAY_H
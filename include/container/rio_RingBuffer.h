@@ -0,0 +1,184 @@
+#ifndef RIO_CNT_RING_BUFFER_H
+#define RIO_CNT_RING_BUFFER_H
+
+#include <heap/rio_Heap.h>
+#include <misc/rio_MemUtil.h>
+
+#include <new>
+#include <utility>
+
+namespace rio {
+
+template <typename T>
+class RingBuffer
+{
+    // Fixed-capacity FIFO queue of objects of type T, stored contiguously and wrapping around its buffer.
+    // Its buffer is either allocated with allocBuffer() (From a given heap, or with MemUtil::alloc()), or provided
+    // with setBuffer(). Index 0 is the oldest object.
+
+public:
+    RingBuffer()
+        : mBuffer(nullptr)
+        , mHead(0)
+        , mCount(0)
+        , mCapacity(0)
+        , mOwnBuffer(false)
+    {
+    }
+
+    ~RingBuffer()
+    {
+        freeBuffer();
+    }
+
+private:
+    // Disallow copying
+    RingBuffer(const RingBuffer&);
+    RingBuffer& operator=(const RingBuffer&);
+
+public:
+    // Allocate a buffer of "capacity" objects from "heap" (Null = MemUtil::alloc())
+    bool allocBuffer(s32 capacity, Heap* heap = nullptr)
+    {
+        RIO_ASSERT(!mBuffer && capacity > 0);
+
+        const size_t size = sizeof(T) * capacity;
+        void* buffer = heap ? heap->tryAlloc(size, alignof(T)) : MemUtil::alloc(size, alignof(T));
+        if (!buffer)
+            return false;
+
+        setBuffer(capacity, buffer);
+        mOwnBuffer = true;
+        return true;
+    }
+
+    // Use "buffer" (Of at least "capacity" objects, aligned for T) as buffer, which the queue does not free
+    void setBuffer(s32 capacity, void* buffer)
+    {
+        RIO_ASSERT(!mBuffer && capacity > 0 && buffer);
+
+        mBuffer = static_cast<T*>(buffer);
+        mHead = 0;
+        mCount = 0;
+        mCapacity = capacity;
+        mOwnBuffer = false;
+    }
+
+    // Destroy all objects and release the buffer (If allocated by allocBuffer())
+    void freeBuffer()
+    {
+        clear();
+
+        if (mBuffer && mOwnBuffer)
+            MemUtil::free(mBuffer);
+
+        mBuffer = nullptr;
+        mCapacity = 0;
+        mOwnBuffer = false;
+    }
+
+    bool isBufferReady() const { return mBuffer != nullptr; }
+
+    // Is queue empty
+    bool isEmpty() const { return mCount == 0; }
+    // Is queue full
+    bool isFull() const { return mCount == mCapacity; }
+    // Get object count
+    s32 size() const { return mCount; }
+    // Get maximum object count
+    s32 capacity() const { return mCapacity; }
+
+    // Get object at index, from the oldest
+    T& operator[](s32 index)
+    {
+        RIO_ASSERT(0 <= index && index < mCount);
+        return mBuffer[wrap_(mHead + index)];
+    }
+
+    const T& operator[](s32 index) const
+    {
+        RIO_ASSERT(0 <= index && index < mCount);
+        return mBuffer[wrap_(mHead + index)];
+    }
+
+    // Get oldest object (Null if empty)
+    T* front() { return mCount > 0 ? &mBuffer[mHead] : nullptr; }
+    const T* front() const { return mCount > 0 ? &mBuffer[mHead] : nullptr; }
+    // Get newest object (Null if empty)
+    T* back() { return mCount > 0 ? &mBuffer[wrap_(mHead + mCount - 1)] : nullptr; }
+    const T* back() const { return mCount > 0 ? &mBuffer[wrap_(mHead + mCount - 1)] : nullptr; }
+
+    // Construct an object at the back (Returns null if full)
+    template <typename... Args>
+    T* emplaceBack(Args&&... args)
+    {
+        if (isFull())
+            return nullptr;
+
+        T* obj = new (&mBuffer[wrap_(mHead + mCount)]) T(std::forward<Args>(args)...);
+        mCount++;
+        return obj;
+    }
+
+    // Push obj to back (Returns false if full)
+    bool pushBack(const T& obj) { return emplaceBack(obj) != nullptr; }
+    bool pushBack(T&& obj) { return emplaceBack(std::move(obj)) != nullptr; }
+
+    // Push obj to back, destroying the oldest object if full
+    void forcePushBack(T obj)
+    {
+        RIO_ASSERT(mCapacity > 0);
+
+        if (isFull())
+            popFront();
+
+        emplaceBack(std::move(obj));
+    }
+
+    // Destroy the oldest object
+    void popFront()
+    {
+        RIO_ASSERT(mCount > 0);
+
+        mBuffer[mHead].~T();
+        mHead = wrap_(mHead + 1);
+        mCount--;
+    }
+
+    // Move the oldest object to "obj" and destroy it (Returns false if empty)
+    bool popFront(T* obj)
+    {
+        if (isEmpty())
+            return false;
+
+        *obj = std::move(mBuffer[mHead]);
+        popFront();
+        return true;
+    }
+
+    // Destroy all objects
+    void clear()
+    {
+        while (mCount > 0)
+            popFront();
+
+        mHead = 0;
+    }
+
+private:
+    s32 wrap_(s32 index) const
+    {
+        return index >= mCapacity ? index - mCapacity : index;
+    }
+
+private:
+    T*      mBuffer;        // Object buffer
+    s32     mHead;          // Index of the oldest object in the buffer
+    s32     mCount;         // Object count
+    s32     mCapacity;      // Buffer capacity
+    bool    mOwnBuffer;     // Buffer allocated by allocBuffer()
+};
+
+}
+
+#endif // RIO_CNT_RING_BUFFER_H
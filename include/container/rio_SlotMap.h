@@ -0,0 +1,265 @@
+#ifndef RIO_CNT_SLOT_MAP_H
+#define RIO_CNT_SLOT_MAP_H
+
+#include <heap/rio_Heap.h>
+#include <misc/rio_MemUtil.h>
+
+#include <new>
+#include <utility>
+
+namespace rio {
+
+template <typename T>
+class SlotMap
+{
+    // Fixed-capacity set of objects of type T referred to by handles, which stay valid until their object is
+    // erased (After which they are detected as stale rather than referring to another object).
+    // Objects are stored contiguously, in no particular order, so that iterating over them does not chase pointers:
+    // erasing an object moves the last object into its place.
+    // Its buffer is either allocated with allocBuffer() (From a given heap, or with MemUtil::alloc()), or provided
+    // with setBuffer() (See calcBufferSize()).
+
+public:
+    struct Handle
+    {
+        u32 index;      // Slot index
+        u32 generation; // Slot generation when the handle was created (0 = invalid handle)
+
+        bool isValid() const { return generation != 0; }
+
+        bool operator==(const Handle& rhs) const { return index == rhs.index && generation == rhs.generation; }
+        bool operator!=(const Handle& rhs) const { return !(*this == rhs); }
+    };
+
+    static constexpr Handle cInvalidHandle = { 0, 0 };
+
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+private:
+    struct Slot
+    {
+        u32 dense_index;    // Index of the object (Index of the next free slot if free)
+        u32 generation;     // Incremented when the slot's object is erased (Never 0)
+    };
+
+public:
+    SlotMap()
+        : mObjects(nullptr)
+        , mObjectSlots(nullptr)
+        , mSlots(nullptr)
+        , mCount(0)
+        , mCapacity(0)
+        , mFreeSlot(0)
+        , mOwnBuffer(false)
+    {
+    }
+
+    ~SlotMap()
+    {
+        freeBuffer();
+    }
+
+private:
+    // Disallow copying
+    SlotMap(const SlotMap&);
+    SlotMap& operator=(const SlotMap&);
+
+public:
+    // Size of the buffer of a map of "capacity" objects
+    static size_t calcBufferSize(s32 capacity)
+    {
+        return objectSlotsOffset_(capacity) + sizeof(u32) * capacity + sizeof(Slot) * capacity;
+    }
+
+    static constexpr u32 cBufferAlignment = alignof(T) > alignof(Slot) ? alignof(T) : alignof(Slot);
+
+    // Allocate a buffer of "capacity" objects from "heap" (Null = MemUtil::alloc())
+    bool allocBuffer(s32 capacity, Heap* heap = nullptr)
+    {
+        RIO_ASSERT(!mObjects && capacity > 0);
+
+        const size_t size = calcBufferSize(capacity);
+        void* buffer = heap ? heap->tryAlloc(size, cBufferAlignment) : MemUtil::alloc(size, cBufferAlignment);
+        if (!buffer)
+            return false;
+
+        setBuffer(capacity, buffer);
+        mOwnBuffer = true;
+        return true;
+    }
+
+    // Use "buffer" (Of calcBufferSize(capacity) bytes, aligned to cBufferAlignment) as buffer, which the map does not free
+    void setBuffer(s32 capacity, void* buffer)
+    {
+        RIO_ASSERT(!mObjects && capacity > 0 && buffer);
+
+        u8* const ptr = static_cast<u8*>(buffer);
+        mObjects = reinterpret_cast<T*>(ptr);
+        mObjectSlots = reinterpret_cast<u32*>(ptr + objectSlotsOffset_(capacity));
+        mSlots = reinterpret_cast<Slot*>(ptr + objectSlotsOffset_(capacity) + sizeof(u32) * capacity);
+        mCapacity = capacity;
+        mOwnBuffer = false;
+
+        for (s32 i = 0; i < capacity; i++)
+        {
+            mSlots[i].dense_index = i + 1;
+            mSlots[i].generation = 1;
+        }
+
+        mFreeSlot = 0;
+        mCount = 0;
+    }
+
+    // Destroy all objects and release the buffer (If allocated by allocBuffer())
+    void freeBuffer()
+    {
+        clear();
+
+        if (mObjects && mOwnBuffer)
+            MemUtil::free(mObjects);
+
+        mObjects = nullptr;
+        mObjectSlots = nullptr;
+        mSlots = nullptr;
+        mCapacity = 0;
+        mOwnBuffer = false;
+    }
+
+    bool isBufferReady() const { return mObjects != nullptr; }
+
+    // Is map empty
+    bool isEmpty() const { return mCount == 0; }
+    // Is map full
+    bool isFull() const { return mCount == mCapacity; }
+    // Get object count
+    s32 size() const { return mCount; }
+    // Get maximum object count
+    s32 capacity() const { return mCapacity; }
+
+    // Construct an object (Returns cInvalidHandle if full)
+    template <typename... Args>
+    Handle emplace(Args&&... args)
+    {
+        if (isFull())
+            return cInvalidHandle;
+
+        const u32 slot_index = mFreeSlot;
+        Slot& slot = mSlots[slot_index];
+        mFreeSlot = slot.dense_index;
+
+        new (&mObjects[mCount]) T(std::forward<Args>(args)...);
+        mObjectSlots[mCount] = slot_index;
+        slot.dense_index = mCount;
+        mCount++;
+
+        return { slot_index, slot.generation };
+    }
+
+    Handle insert(const T& obj) { return emplace(obj); }
+    Handle insert(T&& obj) { return emplace(std::move(obj)); }
+
+    // Get the object of "handle" (Null if erased)
+    T* get(Handle handle)
+    {
+        const Slot* slot = findSlot_(handle);
+        return slot ? &mObjects[slot->dense_index] : nullptr;
+    }
+
+    const T* get(Handle handle) const
+    {
+        const Slot* slot = findSlot_(handle);
+        return slot ? &mObjects[slot->dense_index] : nullptr;
+    }
+
+    // Does "handle" refer to an object
+    bool contains(Handle handle) const { return findSlot_(handle) != nullptr; }
+
+    // Destroy the object of "handle" (Returns false if already erased)
+    bool erase(Handle handle)
+    {
+        Slot* slot = const_cast<Slot*>(findSlot_(handle));
+        if (!slot)
+            return false;
+
+        eraseDense_(slot->dense_index);
+        return true;
+    }
+
+    // Handle of the object at "index" in iteration order
+    Handle getHandle(s32 index) const
+    {
+        RIO_ASSERT(0 <= index && index < mCount);
+
+        const u32 slot_index = mObjectSlots[index];
+        return { slot_index, mSlots[slot_index].generation };
+    }
+
+    // Destroy all objects (Invalidating all handles)
+    void clear()
+    {
+        while (mCount > 0)
+            eraseDense_(mCount - 1);
+    }
+
+    iterator begin() { return mObjects; }
+    iterator end() { return mObjects + mCount; }
+    const_iterator begin() const { return mObjects; }
+    const_iterator end() const { return mObjects + mCount; }
+
+private:
+    static size_t objectSlotsOffset_(s32 capacity)
+    {
+        // Keep the slots aligned after the objects
+        const size_t size = sizeof(T) * capacity;
+        return (size + alignof(Slot) - 1) & ~size_t(alignof(Slot) - 1);
+    }
+
+    const Slot* findSlot_(Handle handle) const
+    {
+        if (handle.index >= u32(mCapacity))
+            return nullptr;
+
+        const Slot& slot = mSlots[handle.index];
+        if (slot.generation != handle.generation || !handle.isValid())
+            return nullptr;
+
+        return &slot;
+    }
+
+    void eraseDense_(u32 dense_index)
+    {
+        const u32 slot_index = mObjectSlots[dense_index];
+        const u32 last = mCount - 1;
+
+        if (dense_index != last)
+        {
+            mObjects[dense_index] = std::move(mObjects[last]);
+            mObjectSlots[dense_index] = mObjectSlots[last];
+            mSlots[mObjectSlots[dense_index]].dense_index = dense_index;
+        }
+
+        mObjects[last].~T();
+        mCount--;
+
+        Slot& slot = mSlots[slot_index];
+        if (++slot.generation == 0)
+            slot.generation = 1;
+
+        slot.dense_index = mFreeSlot;
+        mFreeSlot = slot_index;
+    }
+
+private:
+    T*      mObjects;       // Objects, contiguous
+    u32*    mObjectSlots;   // Slot index of each object
+    Slot*   mSlots;         // Slots, indexed by handles
+    s32     mCount;         // Object count
+    s32     mCapacity;      // Buffer capacity
+    u32     mFreeSlot;      // Index of the first free slot
+    bool    mOwnBuffer;     // Buffer allocated by allocBuffer()
+};
+
+}
+
+#endif // RIO_CNT_SLOT_MAP_H
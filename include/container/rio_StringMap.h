@@ -0,0 +1,323 @@
+#ifndef RIO_CNT_STRING_MAP_H
+#define RIO_CNT_STRING_MAP_H
+
+#include <misc/rio_Hash.h>
+#include <misc/rio_MemUtil.h>
+
+#include <new>
+#include <string>
+#include <utility>
+
+namespace rio {
+
+template <typename T>
+class StringMap
+{
+    // Hash map from strings to objects of type T, with open addressing (Robin Hood hashing, backward-shift erasure).
+    // Keys are looked up as HashedString, so that looking up a string (Or a literal, whose hash can be computed at
+    // compile-time) does not allocate, and compares the stored hashes in a contiguous array before any key.
+    // The slots are allocated with MemUtil::alloc(), and grow when 7/8 full. Inserting or erasing moves entries:
+    // pointers to values are only valid until the next insertion or erasure.
+
+public:
+    struct Entry
+    {
+        std::string key;
+        T           value;
+    };
+
+private:
+    struct Slot
+    {
+        u32 hash;       // Hash of the entry's key
+        u32 dist;       // Distance from the entry's ideal slot, plus 1 (0 = empty slot)
+    };
+
+public:
+    class iterator
+    {
+    public:
+        iterator(const StringMap* map, u32 index)
+            : mMap(map)
+            , mIndex(index)
+        {
+            skip_();
+        }
+
+        iterator& operator++()
+        {
+            mIndex++;
+            skip_();
+            return *this;
+        }
+
+        Entry& operator*() const { return mMap->mEntries[mIndex]; }
+        Entry* operator->() const { return &mMap->mEntries[mIndex]; }
+
+        friend bool operator==(const iterator& it1, const iterator& it2) { return it1.mIndex == it2.mIndex; }
+        friend bool operator!=(const iterator& it1, const iterator& it2) { return it1.mIndex != it2.mIndex; }
+
+    private:
+        void skip_()
+        {
+            while (mIndex < mMap->mCapacity && mMap->mSlots[mIndex].dist == 0)
+                mIndex++;
+        }
+
+    private:
+        const StringMap*    mMap;
+        u32                 mIndex;
+    };
+
+public:
+    StringMap()
+        : mSlots(nullptr)
+        , mEntries(nullptr)
+        , mCount(0)
+        , mCapacity(0)
+    {
+    }
+
+    ~StringMap()
+    {
+        clear();
+        freeBuffers_();
+    }
+
+private:
+    // Disallow copying
+    StringMap(const StringMap&);
+    StringMap& operator=(const StringMap&);
+
+public:
+    // Is map empty
+    bool isEmpty() const { return mCount == 0; }
+    // Get entry count
+    s32 size() const { return mCount; }
+    // Get slot count
+    s32 capacity() const { return mCapacity; }
+
+    // Make room for "num" entries without growing
+    void reserve(s32 num)
+    {
+        u32 capacity = mCapacity > 0 ? mCapacity : cCapacityMin;
+        while (isOverloaded_(num, capacity))
+            capacity *= 2;
+
+        if (capacity != mCapacity)
+            rehash_(capacity);
+    }
+
+    // Get the value of "key" (Null if not found)
+    T* find(const HashedString& key)
+    {
+        const s32 index = findIndex_(key);
+        return index >= 0 ? &mEntries[index].value : nullptr;
+    }
+
+    const T* find(const HashedString& key) const
+    {
+        const s32 index = findIndex_(key);
+        return index >= 0 ? &mEntries[index].value : nullptr;
+    }
+
+    bool contains(const HashedString& key) const { return findIndex_(key) >= 0; }
+
+    // Construct the value of "key" if it is not in the map
+    // Returns the value of "key", and whether it was inserted.
+    template <typename... Args>
+    std::pair<T*, bool> tryEmplace(const HashedString& key, Args&&... args)
+    {
+        const s32 index = findIndex_(key);
+        if (index >= 0)
+            return { &mEntries[index].value, false };
+
+        if (isOverloaded_(mCount + 1, mCapacity))
+            rehash_(mCapacity > 0 ? mCapacity * 2 : cCapacityMin);
+
+        Entry entry { std::string(key.str()), T(std::forward<Args>(args)...) };
+        return { &mEntries[insert_(key.hash(), std::move(entry))].value, true };
+    }
+
+    // Erase the entry of "key" (Returns false if not found)
+    bool erase(const HashedString& key)
+    {
+        const s32 index = findIndex_(key);
+        if (index < 0)
+            return false;
+
+        eraseIndex_(index);
+        return true;
+    }
+
+    // Erase all entries (Keeps the slots)
+    void clear()
+    {
+        for (u32 i = 0; i < mCapacity; i++)
+        {
+            if (mSlots[i].dist != 0)
+            {
+                mEntries[i].~Entry();
+                mSlots[i].dist = 0;
+            }
+        }
+
+        mCount = 0;
+    }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, mCapacity); }
+
+private:
+    static constexpr u32 cCapacityMin = 8;
+
+    static bool isOverloaded_(u32 num, u32 capacity)
+    {
+        return num * 8 > capacity * 7;
+    }
+
+    s32 findIndex_(const HashedString& key) const
+    {
+        if (mCount == 0)
+            return -1;
+
+        const u32 mask = mCapacity - 1;
+        const u32 hash = key.hash();
+
+        u32 index = hash & mask;
+        for (u32 dist = 1; ; dist++)
+        {
+            const Slot& slot = mSlots[index];
+
+            // Entries are ordered by distance: an entry of "key" would have been found by now
+            if (slot.dist < dist)
+                return -1;
+
+            if (slot.hash == hash && mEntries[index].key == key.str())
+                return index;
+
+            index = (index + 1) & mask;
+        }
+    }
+
+    // Insert an entry whose key is not in the map (With room for it), returning its index
+    u32 insert_(u32 hash, Entry&& new_entry)
+    {
+        const u32 mask = mCapacity - 1;
+
+        Entry entry = std::move(new_entry);
+        u32 dist = 1;
+        u32 index = hash & mask;
+        u32 inserted_index = mCapacity;
+
+        while (true)
+        {
+            Slot& slot = mSlots[index];
+
+            if (slot.dist == 0)
+            {
+                new (&mEntries[index]) Entry(std::move(entry));
+                slot.hash = hash;
+                slot.dist = dist;
+                mCount++;
+
+                return inserted_index != mCapacity ? inserted_index : index;
+            }
+
+            // Take the slot of entries closer to their ideal slot, and carry on inserting them
+            if (slot.dist < dist)
+            {
+                std::swap(entry, mEntries[index]);
+                std::swap(hash, slot.hash);
+                std::swap(dist, slot.dist);
+
+                if (inserted_index == mCapacity)
+                    inserted_index = index;
+            }
+
+            index = (index + 1) & mask;
+            dist++;
+        }
+    }
+
+    void eraseIndex_(u32 index)
+    {
+        const u32 mask = mCapacity - 1;
+
+        mEntries[index].~Entry();
+
+        // Shift the following entries back, until one is in its ideal slot
+        u32 next = (index + 1) & mask;
+        while (mSlots[next].dist > 1)
+        {
+            new (&mEntries[index]) Entry(std::move(mEntries[next]));
+            mEntries[next].~Entry();
+
+            mSlots[index].hash = mSlots[next].hash;
+            mSlots[index].dist = mSlots[next].dist - 1;
+
+            index = next;
+            next = (next + 1) & mask;
+        }
+
+        mSlots[index].dist = 0;
+        mCount--;
+    }
+
+    void rehash_(u32 capacity)
+    {
+        RIO_ASSERT((capacity & (capacity - 1)) == 0);
+
+        Slot* const slots = mSlots;
+        Entry* const entries = mEntries;
+        const u32 prev_capacity = mCapacity;
+
+        mSlots = static_cast<Slot*>(MemUtil::alloc(sizeof(Slot) * capacity, alignof(Slot)));
+        mEntries = static_cast<Entry*>(MemUtil::alloc(sizeof(Entry) * capacity, alignof(Entry)));
+        RIO_ASSERT(mSlots && mEntries);
+
+        mCapacity = capacity;
+        mCount = 0;
+
+        for (u32 i = 0; i < capacity; i++)
+            mSlots[i].dist = 0;
+
+        for (u32 i = 0; i < prev_capacity; i++)
+        {
+            if (slots[i].dist != 0)
+            {
+                insert_(slots[i].hash, std::move(entries[i]));
+                entries[i].~Entry();
+            }
+        }
+
+        if (slots)
+        {
+            MemUtil::free(slots);
+            MemUtil::free(entries);
+        }
+    }
+
+    void freeBuffers_()
+    {
+        if (mSlots)
+        {
+            MemUtil::free(mSlots);
+            MemUtil::free(mEntries);
+        }
+
+        mSlots = nullptr;
+        mEntries = nullptr;
+        mCapacity = 0;
+    }
+
+private:
+    Slot*   mSlots;         // Hashes and distances, probed before any entry
+    Entry*  mEntries;       // Entries, at the same indices as their slots
+    u32     mCount;         // Entry count
+    u32     mCapacity;      // Slot count (A power of 2)
+};
+
+}
+
+#endif // RIO_CNT_STRING_MAP_H
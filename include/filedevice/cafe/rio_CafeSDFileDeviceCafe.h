@@ -29,9 +29,11 @@ public:
     CafeSDFileDevice();
     virtual ~CafeSDFileDevice() {}
 
-    virtual std::string getNativePath(const std::string& path) const
+protected:
+    virtual bool getNativeRoot_(std::string_view* root) const
     {
-        return mCWD + '/' + path;
+        *root = mCWD;
+        return true;
     }
 };
 
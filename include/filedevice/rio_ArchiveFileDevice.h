@@ -0,0 +1,84 @@
+#ifndef RIO_FILE_ARCHIVE_DEVICE_H
+#define RIO_FILE_ARCHIVE_DEVICE_H
+
+#include <filedevice/rio_FileDevice.h>
+
+#include <atomic>
+
+namespace rio {
+
+class ArchiveFileDevice : public FileDevice
+{
+    // Read-only file device serving the files packed in an archive (See tools/ArchivePacker).
+    // The whole archive is loaded through FileDeviceMgr by open() (Mapped, if it is on a MappedFileDevice),
+    // files are looked up by path in the archive's index, sorted by hash, and served straight from the archive's data:
+    // load() returns a pointer into the archive (need_unload not set) unless a buffer or a larger alignment is requested,
+    // or the file is compressed (See Decompressor). Such data stays valid until the archive is closed.
+    //
+    // Archive layout (Offsets from the start of the archive, endianness of the target platform):
+    //   0x00  char[8]  Magic ("rioarchv")
+    //   0x08  u16      Byte order mark (0xFEFF)
+    //   0x0A  u16      Padding
+    //   0x0C  u32      Version
+    //   0x10  u32      Archive size
+    //   0x14  u32      Number of files
+    //   0x18  u32      Offset of the entries (Entry[Number of files], sorted by hash, then by path)
+    //   0x1C  u32      Offset of the path table (Null-terminated paths)
+
+public:
+    static constexpr u32 cVersion = 0x01000000;
+
+    struct Entry
+    {
+        u32 hash;           // Hash::calcFNV1a() of the path
+        u32 path_offset;    // From the start of the path table
+        u32 data_offset;    // From the start of the archive
+        u32 data_size;
+    };
+    static_assert(sizeof(Entry) == 0x10);
+
+public:
+    ArchiveFileDevice(const std::string& drive_name);
+    virtual ~ArchiveFileDevice();
+
+    // Load the archive at "path" (Through FileDeviceMgr, so it can be on any mounted device)
+    bool open(const std::string& path);
+    // Unload the archive (Data loaded from it without copy becomes invalid)
+    void close();
+
+    bool isOpen() const { return mData != nullptr; }
+    u32 getFileNum() const { return mFileNum; }
+
+    // Find a packed file, without copy
+    // Returns a pointer to its data in the archive (Compressed, if it is a compressed file), or null if not found.
+    const u8* getFileData(std::string_view path, u32* size) const;
+
+protected:
+    virtual u8* doLoad_(LoadArg& arg);
+    virtual FileDevice* doOpen_(FileHandle* handle, std::string_view filename, FileOpenFlag flag);
+    virtual bool doClose_(FileHandle* handle);
+    virtual bool doRead_(u32* read_size, FileHandle* handle, u8* buf, u32 size);
+    virtual bool doWrite_(u32* write_size, FileHandle* handle, const u8* buf, u32 size);
+    virtual bool doSeek_(FileHandle* handle, s32 offset, SeekOrigin origin);
+    virtual bool doGetCurrentSeekPos_(u32* pos, FileHandle* handle);
+    virtual bool doGetFileSize_(u32* size, std::string_view path);
+    virtual bool doGetFileSize_(u32* size, FileHandle* handle);
+    virtual bool doIsExistFile_(bool* is_exist, std::string_view path);
+    virtual RawErrorCode doGetLastRawError_() const;
+
+private:
+    const Entry* findEntry_(std::string_view path) const;
+
+private:
+    u8*                         mData;
+    u32                         mDataSize;
+    bool                        mNeedUnload;
+    const Entry*                mEntries;
+    const char*                 mPaths;
+    u32                         mFileNum;
+    std::atomic<RawErrorCode>   mLastRawError;
+};
+
+}
+
+#endif // RIO_FILE_ARCHIVE_DEVICE_H
@@ -0,0 +1,97 @@
+#ifndef RIO_FILE_ASYNC_LOAD_H
+#define RIO_FILE_ASYNC_LOAD_H
+
+#include <filedevice/rio_FileDevice.h>
+
+#include <atomic>
+#include <memory>
+
+namespace rio {
+
+class AsyncLoad;
+
+// Handle of an asynchronous load, the load is kept alive by its handles and, until it completes, by FileDeviceMgr
+typedef std::shared_ptr<AsyncLoad> AsyncLoadHandle;
+
+class AsyncLoad
+{
+    // Asynchronous load started by FileDeviceMgr::tryLoadAsync().
+    // The file is loaded on one of FileDeviceMgr's I/O threads, then the load is completed on the main thread
+    // by FileDeviceMgr::calcLoadAsync() (Called by TaskMgr::calcPrepare()), which calls the load's callback.
+
+public:
+    enum State
+    {
+        STATE_QUEUED,       // Waiting for an I/O thread
+        STATE_LOADING,      // Being loaded by an I/O thread
+        STATE_LOADED,       // Loaded, waiting to be completed on the main thread
+        STATE_DONE,         // Completed (The callback has been called)
+        STATE_CANCELED      // Canceled before it was loaded (The callback is not called)
+    };
+
+    enum Priority
+    {
+        PRIORITY_LOW,       // Background prefetching
+        PRIORITY_NORMAL,
+        PRIORITY_HIGH       // Latency-sensitive loads, e.g., streaming audio
+    };
+
+    // Called on the main thread when the load completes
+    typedef void (*Callback)(AsyncLoad& load, void* user_data);
+
+public:
+    // Data still owned by the load when it is destroyed is unloaded
+    ~AsyncLoad();
+
+private:
+    AsyncLoad(const FileDevice::LoadArg& arg, Priority priority, Callback callback, void* user_data);
+
+    AsyncLoad(const AsyncLoad&);
+    AsyncLoad& operator=(const AsyncLoad&);
+
+public:
+    State getState() const { return mState.load(std::memory_order_acquire); }
+
+    // Has the load been completed or canceled
+    bool isDone() const
+    {
+        const State state = getState();
+        return state == STATE_DONE || state == STATE_CANCELED;
+    }
+
+    // Was the file loaded successfully (Valid once done)
+    bool isSuccess() const { return getState() == STATE_DONE && mData != nullptr; }
+
+    Priority getPriority() const { return mPriority; }
+
+    // Argument of the load, its output members (read_size, etc.) are valid once done
+    const FileDevice::LoadArg& getArg() const { return mArg; }
+
+    // Loaded data, owned by the load
+    u8* getData() const { return mData; }
+
+    // Take ownership of the loaded data (To be released with FileDeviceMgr::unload() if getArg().need_unload is set)
+    u8* takeData()
+    {
+        u8* data = mData;
+        mData = nullptr;
+        return data;
+    }
+
+private:
+    FileDevice::LoadArg mArg;
+    FileDevice*         mDevice;
+    std::string         mDevicePath;    // Path without drive
+    Priority            mPriority;
+    Callback            mCallback;
+    void*               mUserData;
+    std::atomic<State>  mState;
+    u8*                 mData;
+    AsyncLoadHandle     mSelf;          // Keeps the load alive until it is completed or canceled
+
+    friend class FileDeviceMgr;
+};
+
+}
+
+#endif // RIO_FILE_ASYNC_LOAD_H
@@ -0,0 +1,98 @@
+#ifndef RIO_FILE_BUFFERED_FILE_HANDLE_H
+#define RIO_FILE_BUFFERED_FILE_HANDLE_H
+
+#include <filedevice/rio_FileDevice.h>
+
+namespace rio {
+
+class BufferedFileHandle
+{
+    // Read-ahead buffer over a FileHandle opened for reading, for parsers reading many small records.
+    // Reads are served from a window of the file read ahead of time, so that most calls do not reach the device.
+    // While the file is read sequentially, every refill of the window doubles its size (Up to the maximum size),
+    // a seek outside the window shrinks it back to its initial size.
+    // Reads go to buffers of any alignment (Devices requiring aligned buffers are only ever passed the window,
+    // or a caller's buffer that is aligned), and peek() gives access to the window itself without any copy.
+    // The handle must not be used directly while it is buffered.
+
+public:
+    static constexpr u32 cWindowSizeDefault = 0x4000;
+    static constexpr u32 cWindowSizeMaxDefault = 0x40000;
+
+public:
+    // Parameters:
+    // - handle: Handle to buffer, which may be opened later (But before the first read)
+    // - window_size: Initial size of the read-ahead window
+    // - window_size_max: Size up to which the window grows while the file is read sequentially
+    // Buffering starts at the start of the file.
+    BufferedFileHandle(FileHandle* handle, u32 window_size = cWindowSizeDefault, u32 window_size_max = cWindowSizeMaxDefault);
+    ~BufferedFileHandle();
+
+private:
+    BufferedFileHandle(const BufferedFileHandle&);
+    BufferedFileHandle& operator=(const BufferedFileHandle&);
+
+public:
+    FileHandle* getHandle() const { return mHandle; }
+
+    u32 read(u8* buf, u32 size)
+    {
+        u32 read_size = 0;
+        [[maybe_unused]] bool success = tryRead(&read_size, buf, size);
+        RIO_ASSERT(success);
+        return read_size;
+    }
+
+    // Read up to "size" bytes into "buf" (Of any alignment), fewer only at the end of the file
+    bool tryRead(u32* read_size, u8* buf, u32 size);
+
+    // Get the next "size" bytes of the file without consuming them (Nor copying them)
+    // Parameters:
+    // - size: Number of bytes to access, at most the maximum window size
+    // - available: Number of bytes actually available (Less than "size" only at the end of the file)
+    // Returns a pointer into the window, valid until the next call to any other method, or null on failure.
+    const u8* peek(u32 size, u32* available);
+
+    // Consume "size" bytes (e.g., after peek())
+    bool trySkip(u32 size);
+
+    // Seeks within the window do not reach the device
+    bool trySeek(s32 offset, FileDevice::SeekOrigin origin);
+
+    u32 getCurrentSeekPos() const { return mWindowPos + mOffset; }
+    bool tryGetFileSize(u32* size);
+
+    u32 getWindowSize() const { return mWindowSize; }
+
+    // Drop the window (e.g., after the handle is reopened or used directly)
+    void invalidate();
+
+private:
+    // Read the next window of the file after the data not consumed yet
+    bool fill_();
+    // Move to "pos" in the file, dropping the window if "pos" is outside it
+    void seekTo_(u32 pos);
+    // Position the handle at "pos", if it is not there
+    bool seekHandle_(u32 pos);
+
+    static constexpr u32 cPosUnknown = 0xFFFFFFFF;
+
+private:
+    FileHandle* mHandle;
+    u8*         mBuffer;
+    u32         mCapacity;          // Size of mBuffer
+    u32         mBegin;             // Start of the window's data in mBuffer (Data is read right after it, aligned)
+    u32         mSize;              // Size of the window's data, from mBegin
+    u32         mOffset;            // Position in the window's data
+    u32         mWindowPos;         // Position of the window's data in the file
+    u32         mHandlePos;         // Position of the handle in the file (cPosUnknown if unknown)
+    u32         mWindowSize;        // Current read-ahead size
+    u32         mWindowSizeMin;
+    u32         mWindowSizeMax;
+    u32         mFileSize;          // cPosUnknown if not queried yet
+    bool        mSequential;        // Has the file been read sequentially since the last refill
+};
+
+}
+
+#endif // RIO_FILE_BUFFERED_FILE_HANDLE_H
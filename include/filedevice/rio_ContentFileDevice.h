@@ -11,14 +11,16 @@ public:
     ContentFileDevice();
     virtual ~ContentFileDevice() {}
 
-    virtual std::string getNativePath(const std::string& path) const
+    const std::string& getContentNativePath() const
     {
-        return mContentPath + '/' + path;
+        return mContentPath;
     }
 
-    const std::string& getContentNativePath() const
+protected:
+    virtual bool getNativeRoot_(std::string_view* root) const
     {
-        return mContentPath;
+        *root = mContentPath;
+        return true;
     }
 
 private:
@@ -0,0 +1,88 @@
+#ifndef RIO_FILE_DECOMPRESSOR_H
+#define RIO_FILE_DECOMPRESSOR_H
+
+#include <filedevice/rio_FileDevice.h>
+
+#include <atomic>
+
+namespace rio {
+
+class JobSystem;
+
+class Decompressor
+{
+    // Decompression of compressed files (See tools/AssetCompressor), used by FileDevice::doLoad_()
+    // (And the devices overriding it) so that compressed files are loaded transparently.
+    // A compressed file is split into chunks compressed independently (LZ4 block format),
+    // which are decompressed as soon as they are read, in parallel on the job system if enabled.
+    //
+    // Layout (Offsets from the start of the file, endianness of the target platform):
+    //   0x00  char[8]  Magic ("riocmprs")
+    //   0x08  u16      Byte order mark (0xFEFF)
+    //   0x0A  u16      Codec (CODEC_LZ4)
+    //   0x0C  u32      Version
+    //   0x10  u32      Decompressed size
+    //   0x14  u32      Chunk size (Decompressed size of every chunk, except the last)
+    //   0x18  u32      Number of chunks
+    //   0x1C  u32      Padding
+    //   0x20  u32[]    Compressed size of each chunk (cChunkStored set if the chunk is stored uncompressed)
+    //   ....  Chunks, one after the other
+
+public:
+    static constexpr u32 cVersion = 0x01000000;
+
+    enum Codec
+    {
+        CODEC_LZ4 = 1
+    };
+
+    struct Header
+    {
+        char    magic[8];
+        u16     bom;
+        u16     codec;
+        u32     version;
+        u32     decompressed_size;
+        u32     chunk_size;
+        u32     chunk_num;
+        u32     _pad;
+    };
+    static_assert(sizeof(Header) == 0x20);
+
+    static constexpr u32 cChunkStored = 0x80000000;
+
+    // Size of the reads of compressed files, the chunks read by each are decompressed while the next is read
+    static constexpr u32 cReadSize = 0x40000;
+
+public:
+    // Is "data" the start of a compressed file (Of either endianness, load() fails on the wrong one)
+    static bool isCompressed(const u8* data, u32 size);
+
+    // Decompress chunks in parallel on the job system, off by default (See InitializeArg::job_system).
+    // Must be enabled after the job system is created, which must then outlive every load that can use it.
+    static void setParallel(bool parallel) { sParallel.store(parallel, std::memory_order_release); }
+    static bool isParallel() { return sParallel.load(std::memory_order_acquire); }
+
+    // Load the compressed file in "src" (e.g., a mapped file) into arg.buffer, or an allocated buffer
+    // (Fills arg's output members as FileDevice::doLoad_() does)
+    static u8* load(FileDevice::LoadArg& arg, const u8* src, u32 src_size);
+    // Load the compressed file opened by "handle", whose header has already been read
+    static u8* load(FileDevice::LoadArg& arg, FileHandle* handle, const Header& header, u32 file_size);
+
+    // Decompress a single LZ4 block, which must fill "dst" exactly
+    static bool decompressLZ4(u8* dst, u32 dst_size, const u8* src, u32 src_size);
+
+private:
+    class Context;
+
+    static bool isValidHeader_(const Header& header, u32 file_size);
+    static JobSystem* getJobSystem_(const Header& header);
+    static u8* allocBuffer_(FileDevice::LoadArg& arg, const Header& header, bool* need_unload);
+
+private:
+    static std::atomic<bool> sParallel;
+};
+
+}
+
+#endif // RIO_FILE_DECOMPRESSOR_H
@@ -2,9 +2,12 @@
 #define RIO_FILE_DEVICE_H
 
 #include <container/rio_TList.h>
+#include <filedevice/rio_FileDeviceStats.h>
+#include <misc/rio_Hash.h>
 #include <misc/rio_MemUtil.h>
 
 #include <string>
+#include <string_view>
 
 namespace rio {
 
@@ -81,6 +84,7 @@ public:
     FileDevice(const std::string& drive_name)
         : TListNode<FileDevice*>(this)
         , mDriveName(drive_name)
+        , mDriveNameHash(Hash::calcFNV1a(drive_name.c_str(), drive_name.length()))
     {
     }
 
@@ -91,11 +95,27 @@ public:
         return mDriveName;
     }
 
-    void setDriveName(const std::string& drive_name)
+    // FNV-1a hash of the drive name, by which FileDeviceMgr looks devices up
+    u32 getDriveNameHash() const
     {
-        mDriveName = drive_name;
+        return mDriveNameHash;
     }
 
+    void setDriveName(const std::string& drive_name);
+
+    // I/O statistics of the try*() methods (And of the methods calling them)
+    // Opens and reads done by a load through FileHandles are counted as well.
+    const FileDeviceStats& getStats() const
+    {
+        return mStats;
+    }
+
+    void resetStats()
+    {
+        mStats.reset();
+    }
+
+    // Compressed files (See Decompressor) are decompressed, arg.read_size then being the decompressed size
     u8* load(LoadArg& arg)
     {
         u8* ret = tryLoad(arg);
@@ -107,18 +127,22 @@ public:
         return ret;
     }
 
-    static void unload(u8* data)
-    {
-        RIO_ASSERT(data);
-        MemUtil::free(data);
-    }
+    // Release data returned by load() or tryLoad() with need_unload set
+    static void unload(u8* data);
 
-    FileDevice* open(FileHandle* handle, const std::string& filename, FileOpenFlag flag)
+    // Load several files at once, which some devices overlap (See OverlappedFileDevice)
+    // The data of each file is stored in "data" (Null if the file failed to load), and its output members in "args".
+    // Returns the number of files loaded.
+    u32 tryLoadMultiple(LoadArg* args, u8** data, u32 num);
+
+    typedef void (*UnloadFunc)(u8* data);
+
+    FileDevice* open(FileHandle* handle, std::string_view filename, FileOpenFlag flag)
     {
         FileDevice* device = tryOpen(handle, filename, flag);
         if (!device)
         {
-            RIO_LOG("FileDevice::open(): Failure. [%s]\n", filename.c_str());
+            RIO_LOG("FileDevice::open(): Failure. [%.*s]\n", int(filename.length()), filename.data());
             RIO_ASSERT(false);
         }
         return device;
@@ -160,7 +184,7 @@ public:
         return pos;
     }
 
-    u32 getFileSize(const std::string& path)
+    u32 getFileSize(std::string_view path)
     {
         u32 size = 0;
         [[maybe_unused]] bool success = tryGetFileSize(&size, path);
@@ -176,13 +200,13 @@ public:
         return size;
     }
 
-    bool isExistFile(const std::string& path)
+    bool isExistFile(std::string_view path)
     {
         bool is_exist = false;
         bool success = tryIsExistFile(&is_exist, path);
         if (!success)
         {
-            RIO_LOG("FileDevice::isExistFile(): Failure. [%s]\n", path.c_str());
+            RIO_LOG("FileDevice::isExistFile(): Failure. [%.*s]\n", int(path.length()), path.data());
             RIO_ASSERT(false);
         }
         return is_exist;
@@ -191,35 +215,55 @@ public:
     RawErrorCode getLastRawError() const;
 
     u8* tryLoad(LoadArg& arg);
-    FileDevice* tryOpen(FileHandle* handle, const std::string& filename, FileOpenFlag flag);
+    FileDevice* tryOpen(FileHandle* handle, std::string_view filename, FileOpenFlag flag);
     bool tryClose(FileHandle* handle);
     bool tryRead(u32* read_size, FileHandle* handle, u8* buf, u32 size);
     bool tryWrite(u32* write_size, FileHandle* handle, const u8* buf, u32 size);
     bool trySeek(FileHandle* handle, s32 offset, SeekOrigin origin);
     bool tryGetCurrentSeekPos(u32* pos, FileHandle* handle);
-    bool tryGetFileSize(u32* size, const std::string& path);
+    bool tryGetFileSize(u32* size, std::string_view path);
     bool tryGetFileSize(u32* size, FileHandle* handle);
-    bool tryIsExistFile(bool* is_exist, const std::string& path);
+    bool tryIsExistFile(bool* is_exist, std::string_view path);
+
+    // Size of the data load() returns for the file at "path": its size, or its decompressed size if it is compressed
+    bool tryGetLoadSize(u32* size, std::string_view path);
 
 protected:
     virtual u8* doLoad_(LoadArg& arg);
-    virtual FileDevice* doOpen_(FileHandle* handle, const std::string& filename, FileOpenFlag flag) = 0;
+    // Load each file with doLoad_() by default
+    virtual void doLoadMultiple_(LoadArg* args, u8** data, u32 num);
+    virtual FileDevice* doOpen_(FileHandle* handle, std::string_view filename, FileOpenFlag flag) = 0;
     virtual bool doClose_(FileHandle* handle) = 0;
     virtual bool doRead_(u32* read_size, FileHandle* handle, u8* buf, u32 size) = 0;
     virtual bool doWrite_(u32* write_size, FileHandle* handle, const u8* buf, u32 size) = 0;
     virtual bool doSeek_(FileHandle* handle, s32 offset, SeekOrigin origin) = 0;
     virtual bool doGetCurrentSeekPos_(u32* pos, FileHandle* handle) = 0;
-    virtual bool doGetFileSize_(u32* size, const std::string& path) = 0;
+    virtual bool doGetFileSize_(u32* size, std::string_view path) = 0;
     virtual bool doGetFileSize_(u32* size, FileHandle* handle) = 0;
-    virtual bool doIsExistFile_(bool* is_exist, const std::string& path) = 0;
+    virtual bool doIsExistFile_(bool* is_exist, std::string_view path) = 0;
     virtual RawErrorCode doGetLastRawError_() const = 0;
 
-public:
-    virtual std::string getNativePath(const std::string& path) const
+    // Make unload() release "data" with "func" instead of MemUtil::free()
+    // (For data returned by doLoad_() that is not allocated through MemUtil, e.g., a file mapping)
+    static void registerUnload_(u8* data, UnloadFunc func);
+
+    // Native path of the directory the device's paths are relative to (Empty = native paths)
+    // Returns false if the device has no native paths (The default).
+    virtual bool getNativeRoot_(std::string_view* root) const
     {
-        return "";
+        return false;
     }
 
+public:
+    // Maximum size of a native path built by getNativePath() into a buffer (Null terminator included)
+    static constexpr size_t cNativePathMax = 1024;
+
+    // Native path of "path" (Empty if the device has no native paths)
+    std::string getNativePath(std::string_view path) const;
+    // Build the native path of "path" into "buf", of "size" bytes (Null-terminated), without allocating
+    // Returns false if the device has no native paths, or if the path does not fit.
+    bool getNativePath(char* buf, size_t size, std::string_view path) const;
+
 protected:
     struct FileHandleInner
     {
@@ -230,7 +274,9 @@ protected:
     static FileHandleInner* getFileHandleInner_(FileHandle* handle);
 
 protected:
-    std::string mDriveName;
+    std::string     mDriveName;
+    u32             mDriveNameHash;
+    FileDeviceStats mStats;
 
     friend class FileHandle;
     friend class FileDeviceMgr;
@@ -252,7 +298,8 @@ private:
 public:
     virtual ~FileHandle()
     {
-        FileDevice* device = mOriginalDevice;
+        // Closed by the device holding it, which may not be the device it was opened through (See OverlayFileDevice)
+        FileDevice* device = mDevice;
         if (device)
             device->tryClose(this);
     }
@@ -1,29 +1,45 @@
 #ifndef RIO_FILE_DEVICE_MANAGER_H
 #define RIO_FILE_DEVICE_MANAGER_H
 
+#include <filedevice/rio_AsyncLoad.h>
 #include <filedevice/rio_MainFileDevice.h>
 #include <filedevice/rio_NativeFileDevice.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #if RIO_IS_CAFE
 #include <coreinit/filesystem.h>
 #endif // RIO_IS_CAFE
 
 namespace rio {
 
+class LoadBatch;
+class WorkQueue;
+
 class FileDeviceMgr
 {
 private:
     typedef TList<FileDevice*> DeviceList;
 
 public:
-    static bool createSingleton();
+    // Default number of I/O threads running asynchronous loads, preloads and StreamReader reads
+    static constexpr u32 cLoadThreadNumDefault = 2;
+
+public:
+    // Parameters:
+    // - load_thread_num: Number of I/O threads (At least 1), started by the first asynchronous load, preload or stream
+    static bool createSingleton(u32 load_thread_num = cLoadThreadNumDefault);
     static void destroySingleton();
     static FileDeviceMgr* instance() { return sInstance; }
 
 private:
     static FileDeviceMgr* sInstance;
 
-    FileDeviceMgr();
+    FileDeviceMgr(u32 load_thread_num);
     ~FileDeviceMgr();
 
     FileDeviceMgr(const FileDeviceMgr&);
@@ -31,6 +47,8 @@ private:
 
 public:
     FileDevice* findDeviceFromPath(const std::string& path, std::string* no_drive_path) const;
+    // Same as above, without allocating ("no_drive_path" points into "path")
+    FileDevice* findDeviceFromPath(std::string_view path, std::string_view* no_drive_path) const;
 
     u8* load(FileDevice::LoadArg& arg)
     {
@@ -48,19 +66,34 @@ public:
         FileDevice::unload(data);
     }
 
-    FileDevice* open(FileHandle* handle, const std::string& filename, FileDevice::FileOpenFlag flag)
+    FileDevice* open(FileHandle* handle, std::string_view filename, FileDevice::FileOpenFlag flag)
     {
         FileDevice* device = tryOpen(handle, filename, flag);
         if (!device)
         {
-            RIO_LOG("FileDeviceMgr::open(): Failure. [%s]\n", filename.c_str());
+            RIO_LOG("FileDeviceMgr::open(): Failure. [%.*s]\n", int(filename.length()), filename.data());
             RIO_ASSERT(false);
         }
         return device;
     }
 
     u8* tryLoad(FileDevice::LoadArg& arg);
-    FileDevice* tryOpen(FileHandle* handle, const std::string& filename, FileDevice::FileOpenFlag flag);
+    // Load several files at once, each device loading its files in a single batch (See FileDevice::tryLoadMultiple())
+    u32 tryLoadMultiple(FileDevice::LoadArg* args, u8** data, u32 num);
+
+    // Load the files added to "batch" into its arena (See LoadBatch)
+    // Returns false if any file failed to load (The others are still loaded, until the batch is unloaded).
+    bool tryLoadBatch(LoadBatch* batch);
+
+    void loadBatch(LoadBatch* batch)
+    {
+        if (!tryLoadBatch(batch))
+        {
+            RIO_LOG("FileDeviceMgr::loadBatch(): Failure.\n");
+            RIO_ASSERT(false);
+        }
+    }
+    FileDevice* tryOpen(FileHandle* handle, std::string_view filename, FileDevice::FileOpenFlag flag);
 
     void mount(FileDevice* device, const std::string& drive_name = "");
     void unmount(const std::string& drive);
@@ -86,7 +119,56 @@ public:
         return mNativeFileDevice;
     }
 
-    FileDevice* findDevice(const std::string& drive) const;
+    // Mounted devices are looked up by the hash of their drive name
+    FileDevice* findDevice(std::string_view drive) const;
+
+    // Incremented every time a device is mounted, unmounted or renamed (Can be read from any thread),
+    // so that caches of lookups across devices can tell when to invalidate themselves (See OverlayFileDevice)
+    u32 getMountGeneration() const
+    {
+        return mMountGeneration.load(std::memory_order_acquire);
+    }
+
+    // Start loading a file on an I/O thread (Can be called from any thread).
+    // The load is completed on the main thread by the first calcLoadAsync() after the file is loaded,
+    // which calls "callback" (If not null). The device is resolved by this call.
+    // If arg.buffer is set, it must stay valid until the load is done.
+    // Returns a null handle if the path's device was not found.
+    AsyncLoadHandle tryLoadAsync(const FileDevice::LoadArg& arg,
+                                 AsyncLoad::Priority priority = AsyncLoad::PRIORITY_NORMAL,
+                                 AsyncLoad::Callback callback = nullptr, void* user_data = nullptr);
+    // Cancel a load that has not started loading yet, its callback is then not called (Can be called from any thread)
+    bool cancelLoadAsync(const AsyncLoadHandle& load);
+    // Block until "load" is loaded and complete it immediately (Main thread only).
+    // If no I/O thread has started it yet, it is loaded on the calling thread.
+    void waitLoadAsync(const AsyncLoadHandle& load);
+    // Complete every loaded asynchronous load, calling their callbacks (Main thread only, called by TaskMgr::calcPrepare())
+    void calcLoadAsync();
+    // Number of asynchronous loads that have not been completed or canceled yet
+    u32 getLoadAsyncNum() const;
+
+    // Start loading a file on an I/O thread. The next tryLoad() of the exact same path
+    // takes the loaded data (Waiting for it if it is still loading) instead of reading the file again.
+    // The device is resolved by this call, so the path's drive must already be mounted.
+    // Parameters:
+    // - path: Path of the file, as it will be passed to tryLoad()
+    void preload(const std::string& path);
+    // Wait for every preload (And every asynchronous load) to be loaded (Preloaded data stays available to tryLoad())
+    void waitPreloads();
+    // Cancel pending preloads and free all preloaded data that has not been taken by tryLoad()
+    void clearPreloads();
+    // Number of preloaded files that have not been taken by tryLoad() yet
+    u32 getPreloadNum() const;
+
+    // Get the I/O statistics of "op" on the device mounted at "drive" (See FileDevice::getStats())
+    bool getStats(std::string_view drive, FileDeviceStats::Op op, FileDeviceStats::OpStats* stats) const;
+    // Write the I/O statistics of every mounted device as a JSON object to "json", of the form:
+    // {"bucket_min_ns":[...],"devices":{"content":{"open":{"calls":...,"histogram":[...]},...},...}}
+    void getStatsJson(std::string* json) const;
+    // Write getStatsJson() to the file at "path" (Goes through FileDeviceMgr)
+    bool dumpStatsJson(const std::string& path);
+    void printStats() const;
+    void resetStats();
 
 #if RIO_IS_CAFE
     FSClient* getFSClient() { return &mFSClient; }
@@ -98,16 +180,72 @@ public:
     }
 #endif // RIO_IS_CAFE
 
+private:
+    struct DeviceIndexEntry
+    {
+        u32             hash;           // FileDevice::getDriveNameHash()
+        FileDevice*     device;
+    };
+
+    // Rebuild mDeviceIndex from mDeviceList
+    void updateDeviceIndex_();
+
+    struct Preload
+    {
+        FileDevice*     device;
+        std::string     path;           // Without drive
+        u8*             data;
+        u32             read_size;
+        u32             roundup_size;
+        bool            need_unload;
+        bool            done;
+    };
+
+    typedef std::unordered_map<std::string, Preload*> PreloadMap;
+
+    static void preloadMain_(void* arg);
+    u8* takePreload_(FileDevice::LoadArg& arg);
+
+    WorkQueue* getLoadQueue_();
+    WorkQueue* peekLoadQueue_() const;
+
+    static void loadAsyncMain_(void* arg);
+    void completeLoadAsync_(const AsyncLoadHandle& load);
+    void removeLoadAsync_(AsyncLoad* load);
+
 private:
     DeviceList          mDeviceList;
+    std::vector<DeviceIndexEntry>
+                        mDeviceIndex;       // Mounted devices sorted by hash (In mount order for equal hashes)
+    std::atomic<u32>    mMountGeneration;
     FileDevice*         mDefaultFileDevice;
     MainFileDevice*     mMainFileDevice;
     NativeFileDevice*   mNativeFileDevice;
 
+    const u32           mLoadThreadNum;
+    WorkQueue*          mLoadQueue;         // I/O threads, created by the first asynchronous load, preload or stream
+    mutable std::mutex  mLoadQueueCS;
+
+    std::vector<AsyncLoad*>
+                        mAsyncLoads;        // Loads not completed or canceled yet
+    std::vector<AsyncLoad*>
+                        mLoadedAsyncLoads;  // Loads waiting for calcLoadAsync()
+    mutable std::mutex  mAsyncLoadCS;
+    std::condition_variable
+                        mAsyncLoadCond;
+
+    PreloadMap          mPreloads;
+    mutable std::mutex  mPreloadCS;
+    std::condition_variable
+                        mPreloadCond;
+
 #if RIO_IS_CAFE
     FSClient            mFSClient;
     ContentFileDevice*  mCafeContentFileDevice;
 #endif // RIO_IS_CAFE
+
+    friend class FileDevice;
+    friend class StreamReader;
 };
 
 }
@@ -0,0 +1,92 @@
+#ifndef RIO_FILE_DEVICE_STATS_H
+#define RIO_FILE_DEVICE_STATS_H
+
+#include <misc/rio_Types.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace rio {
+
+class FileDeviceStats
+{
+    // I/O statistics of a file device: for each operation, the number of calls and failures, the number of bytes
+    // transferred, and a histogram of the latency of its calls, with logarithmic buckets.
+    // Recording a call costs a few relaxed atomic additions and two clock reads, so statistics are always on.
+    // Can be recorded from any thread, a snapshot of statistics being recorded may be slightly inconsistent.
+
+public:
+    enum Op
+    {
+        OP_OPEN,
+        OP_READ,
+        OP_WRITE,
+        OP_SEEK,
+        OP_LOAD,
+        OP_LOAD_MULTIPLE,   // One call per batch, size being the total size of its files
+        OP_NUM
+    };
+
+    // Bucket 0 holds calls shorter than 1024 ns (~1 us), bucket i (i > 0) calls of [2^(i + 9), 2^(i + 10)) ns,
+    // and the last bucket every longer call (~4.3 s and more)
+    static constexpr u32 cBucketNum = 24;
+
+    struct OpStats
+    {
+        u64 call_num;
+        u64 error_num;              // Calls that failed
+        u64 size;                   // Bytes transferred
+        u64 total_ns;               // Sum of the latency of all calls (avg = total_ns / call_num)
+        u64 max_ns;
+        u64 buckets[cBucketNum];    // Number of calls per latency bucket
+    };
+
+public:
+    FileDeviceStats();
+
+private:
+    FileDeviceStats(const FileDeviceStats&);
+    FileDeviceStats& operator=(const FileDeviceStats&);
+
+public:
+    static u64 now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    // Record a call of "op" which started at "begin_ns" (See now()) and ended now
+    void record(Op op, u64 begin_ns, u64 size, bool success);
+
+    void get(Op op, OpStats* stats) const;
+    void reset();
+
+    // Append the statistics as a JSON object (See FileDeviceMgr::getStatsJson())
+    void appendJson(std::string* json) const;
+
+    static u32 getBucket(u64 ns);
+    // Lower bound of the latency of the calls in "bucket"
+    static u64 getBucketMinNs(u32 bucket);
+
+    static const char* getOpName(Op op);
+
+private:
+    struct Counters
+    {
+        std::atomic<u64>    call_num;
+        std::atomic<u64>    error_num;
+        std::atomic<u64>    size;
+        std::atomic<u64>    total_ns;
+        std::atomic<u64>    max_ns;
+        std::atomic<u64>    buckets[cBucketNum];
+    };
+
+private:
+    Counters    mCounters[OP_NUM];
+};
+
+}
+
+#endif // RIO_FILE_DEVICE_STATS_H
@@ -0,0 +1,62 @@
+#ifndef RIO_FILE_LOAD_BATCH_H
+#define RIO_FILE_LOAD_BATCH_H
+
+#include <filedevice/rio_FileDevice.h>
+
+#include <vector>
+
+namespace rio {
+
+class LoadBatch
+{
+    // Files loaded together by FileDeviceMgr::tryLoadBatch() (e.g., the files of a level), into a single allocation
+    // (The arena) released all at once by unload(), instead of one allocation per file.
+    // The load sizes of all files are queried first, to lay them out in the arena with their own alignment,
+    // then the files are read in (Approximate) on-disk order: by device, then by path.
+
+public:
+    LoadBatch();
+    // Unloads the files
+    ~LoadBatch();
+
+private:
+    LoadBatch(const LoadBatch&);
+    LoadBatch& operator=(const LoadBatch&);
+
+public:
+    // Add a file to load (Before the batch is loaded), returns its index
+    u32 add(const std::string& path, u32 alignment = FileDevice::cBufferMinAlignment);
+
+    // Release the arena, and remove all files
+    void unload();
+
+    bool isLoaded() const { return mArena != nullptr; }
+
+    u32 getFileNum() const { return mFiles.size(); }
+    const std::string& getPath(u32 index) const { return mFiles[index].path; }
+    // Null if the file failed to load
+    u8* getData(u32 index) const { return mFiles[index].data; }
+    u32 getSize(u32 index) const { return mFiles[index].size; }
+
+    // Size of the arena
+    u32 getArenaSize() const { return mArenaSize; }
+
+private:
+    struct File
+    {
+        std::string path;
+        u32         alignment;
+        u8*         data;
+        u32         size;
+    };
+
+    std::vector<File>   mFiles;
+    void*               mArena;
+    u32                 mArenaSize;
+
+    friend class FileDeviceMgr;
+};
+
+}
+
+#endif // RIO_FILE_LOAD_BATCH_H
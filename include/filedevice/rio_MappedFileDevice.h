@@ -0,0 +1,51 @@
+#ifndef RIO_FILE_MAPPED_DEVICE_H
+#define RIO_FILE_MAPPED_DEVICE_H
+
+#include <filedevice/rio_NativeFileDevice.h>
+
+namespace rio {
+
+class MappedFileDevice : public NativeFileDevice
+{
+    // Read-mostly file device whose load() maps the file into memory instead of copying it into a buffer.
+    // The returned data points straight into a copy-on-write view of the file: pages are shared with the OS
+    // file cache (and other processes) until written to, and unload() unmaps the view.
+    // Loads into a caller-provided buffer, or with an alignment above the system's allocation granularity,
+    // are read as usual. Compressed files are decompressed from the view into a buffer.
+    // All other operations behave like NativeFileDevice.
+    // On Wii U, files cannot be mapped, so every load is read as usual.
+
+public:
+    // Parameters:
+    // - drive_name: Drive name to mount the device with
+    // - root: Native path of the directory the device's paths are relative to (Empty = native paths)
+    MappedFileDevice(const std::string& drive_name, const std::string& root);
+    virtual ~MappedFileDevice() {}
+
+    const std::string& getRoot() const
+    {
+        return mRoot;
+    }
+
+protected:
+    virtual bool getNativeRoot_(std::string_view* root) const
+    {
+        *root = mRoot;
+        return true;
+    }
+
+#if RIO_IS_WIN
+protected:
+    virtual u8* doLoad_(LoadArg& arg);
+
+private:
+    static void unmap_(u8* data);
+#endif // RIO_IS_WIN
+
+private:
+    std::string mRoot;
+};
+
+}
+
+#endif // RIO_FILE_MAPPED_DEVICE_H
@@ -9,6 +9,8 @@
 #include <filedevice/rio_FileDevice.h>
 #endif // RIO_IS_WIN
 
+#include <atomic>
+
 namespace rio {
 
 #if RIO_IS_WIN
@@ -21,25 +23,27 @@ public:
     NativeFileDevice();
     virtual ~NativeFileDevice() {}
 
-    virtual std::string getNativePath(const std::string& path) const
-    {
-        return path;
-    }
-
 protected:
     NativeFileDevice(const std::string& drive_name);
 
+    // Native paths
+    virtual bool getNativeRoot_(std::string_view* root) const
+    {
+        *root = std::string_view();
+        return true;
+    }
+
 #if !RIO_IS_WIN
 private:
-    virtual FileDevice* doOpen_(FileHandle* handle, const std::string& filename, FileOpenFlag flag);
+    virtual FileDevice* doOpen_(FileHandle* handle, std::string_view filename, FileOpenFlag flag);
     virtual bool doClose_(FileHandle* handle);
     virtual bool doRead_(u32* read_size, FileHandle* handle, u8* buf, u32 size);
     virtual bool doWrite_(u32* write_size, FileHandle* handle, const u8* buf, u32 size);
     virtual bool doSeek_(FileHandle* handle, s32 offset, SeekOrigin origin);
     virtual bool doGetCurrentSeekPos_(u32* pos, FileHandle* handle);
-    virtual bool doGetFileSize_(u32* size, const std::string& path);
+    virtual bool doGetFileSize_(u32* size, std::string_view path);
     virtual bool doGetFileSize_(u32* size, FileHandle* handle);
-    virtual bool doIsExistFile_(bool* is_exist, const std::string& path);
+    virtual bool doIsExistFile_(bool* is_exist, std::string_view path);
     virtual RawErrorCode doGetLastRawError_() const;
 
 public:
@@ -50,7 +54,8 @@ public:
 
 private:
     std::string     mCWD;
-    RawErrorCode    mLastRawError;
+    std::atomic<RawErrorCode>
+                    mLastRawError;  // Loads can run on several threads at once
 #endif
 };
 
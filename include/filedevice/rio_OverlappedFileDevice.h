@@ -0,0 +1,80 @@
+#ifndef RIO_FILE_OVERLAPPED_DEVICE_H
+#define RIO_FILE_OVERLAPPED_DEVICE_H
+
+#include <filedevice/rio_NativeFileDevice.h>
+
+namespace rio {
+
+class OverlappedFileDevice : public NativeFileDevice
+{
+    // File device for bulk loading, whose loads are issued as overlapped reads completed through an I/O completion
+    // port. tryLoadMultiple() keeps up to "queue_depth" reads in flight across all of its files (Large files are read
+    // in several reads at once), so that loading many files is limited by the storage device rather than by
+    // the cost of each blocking read. If the completion port cannot be created, files are read as usual.
+    // With "unbuffered" set, files are read bypassing the OS file cache (FILE_FLAG_NO_BUFFERING), into buffers
+    // allocated with VirtualAlloc() (Which honor any LoadArg::alignment up to the allocation granularity) and rounded
+    // up to cUnbufferedAlignment, released by unload(). Loads into a caller-provided buffer that is not aligned to
+    // cUnbufferedAlignment (Or too small to round the file size up), or with a larger alignment, are read through the cache.
+    // All other operations behave like NativeFileDevice.
+    // On Wii U, every load is read as usual.
+
+public:
+    // Alignment of unbuffered reads (At least the sector size of the storage device)
+    static constexpr u32 cUnbufferedAlignment = 0x1000;
+    // Size of each read of large files
+    static constexpr u32 cReadSize = 0x100000;
+
+    static constexpr u32 cQueueDepthDefault = 32;
+
+public:
+    // Parameters:
+    // - drive_name: Drive name to mount the device with
+    // - root: Native path of the directory the device's paths are relative to (Empty = native paths)
+    // - queue_depth: Maximum number of reads in flight
+    // - unbuffered: Bypass the OS file cache
+    OverlappedFileDevice(const std::string& drive_name, const std::string& root,
+                         u32 queue_depth = cQueueDepthDefault, bool unbuffered = false);
+    virtual ~OverlappedFileDevice() {}
+
+    const std::string& getRoot() const
+    {
+        return mRoot;
+    }
+
+    u32 getQueueDepth() const
+    {
+        return mQueueDepth;
+    }
+
+    bool isUnbuffered() const
+    {
+        return mUnbuffered;
+    }
+
+protected:
+    virtual bool getNativeRoot_(std::string_view* root) const
+    {
+        *root = mRoot;
+        return true;
+    }
+
+#if RIO_IS_WIN
+protected:
+    virtual u8* doLoad_(LoadArg& arg);
+    virtual void doLoadMultiple_(LoadArg* args, u8** data, u32 num);
+
+private:
+    class Batch;
+
+    static void virtualFree_(u8* data);
+#endif // RIO_IS_WIN
+
+private:
+    std::string mRoot;
+    u32         mQueueDepth;
+    bool        mUnbuffered;
+};
+
+}
+
+#endif // RIO_FILE_OVERLAPPED_DEVICE_H
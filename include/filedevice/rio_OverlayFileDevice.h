@@ -0,0 +1,81 @@
+#ifndef RIO_FILE_OVERLAY_DEVICE_H
+#define RIO_FILE_OVERLAY_DEVICE_H
+
+#include <filedevice/rio_FileDevice.h>
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace rio {
+
+class OverlayFileDevice : public FileDevice
+{
+    // File device stacking other devices (Layers), e.g., a patch over the base content.
+    // Every path resolves to the topmost layer that has the file, which then serves it: handles are opened
+    // on that layer, and batches of loads are split between layers, so each layer still batches its own files.
+    // Lookups are cached, whether they found a layer or not, so a path is only ever looked up on the layers once.
+    // The cache is dropped whenever a device is mounted, unmounted or renamed (See FileDeviceMgr::getMountGeneration()),
+    // when the layers change, and by clearCache() (e.g., after files were added to a layer).
+    // Files opened for writing are created on the topmost layer that has them, or on the top layer.
+    // Layers must not be changed while the device is in use on other threads, nor be deleted before they are removed.
+
+public:
+    OverlayFileDevice(const std::string& drive_name);
+    virtual ~OverlayFileDevice() {}
+
+    // Add a layer on top of the others
+    void pushLayer(FileDevice* device);
+    bool removeLayer(FileDevice* device);
+    void clearLayers();
+
+    u32 getLayerNum() const { return mLayers.size(); }
+    // Layer 0 is the top layer
+    FileDevice* getLayer(u32 index) const { return mLayers[index]; }
+
+    // Topmost layer that has the file at "path" (Null if none)
+    FileDevice* findLayer(std::string_view path);
+
+    void clearCache();
+    u32 getCacheSize() const;
+
+protected:
+    virtual u8* doLoad_(LoadArg& arg);
+    virtual void doLoadMultiple_(LoadArg* args, u8** data, u32 num);
+    virtual FileDevice* doOpen_(FileHandle* handle, std::string_view filename, FileOpenFlag flag);
+    virtual bool doClose_(FileHandle* handle);
+    virtual bool doRead_(u32* read_size, FileHandle* handle, u8* buf, u32 size);
+    virtual bool doWrite_(u32* write_size, FileHandle* handle, const u8* buf, u32 size);
+    virtual bool doSeek_(FileHandle* handle, s32 offset, SeekOrigin origin);
+    virtual bool doGetCurrentSeekPos_(u32* pos, FileHandle* handle);
+    virtual bool doGetFileSize_(u32* size, std::string_view path);
+    virtual bool doGetFileSize_(u32* size, FileHandle* handle);
+    virtual bool doIsExistFile_(bool* is_exist, std::string_view path);
+    virtual RawErrorCode doGetLastRawError_() const;
+
+private:
+    static constexpr s32 cLayerNone = -1;
+
+    // Index of the topmost layer that has the file at "path" (cLayerNone if none)
+    s32 findLayerIndex_(std::string_view path);
+    // Drop the cache and start a new epoch (mCacheCS must be locked)
+    void clearCache_();
+
+    static u32 getMountGeneration_();
+
+private:
+    std::vector<FileDevice*>    mLayers;
+    std::unordered_map<std::string_view, s32>
+                                mCache;             // Path -> Layer index (cLayerNone if no layer has it)
+    std::deque<std::string>     mCachePaths;        // Storage of the paths in mCache (Never moved)
+    u32                         mCacheGeneration;   // Mount generation mCache was filled in
+    u32                         mCacheEpoch;        // Incremented whenever mCache is dropped
+    mutable std::mutex          mCacheCS;
+    std::atomic<RawErrorCode>   mLastRawError;
+};
+
+}
+
+#endif // RIO_FILE_OVERLAY_DEVICE_H
@@ -4,6 +4,7 @@
 #include <misc/rio_Types.h>
 
 #include <string>
+#include <string_view>
 
 namespace rio {
 
@@ -14,6 +15,10 @@ public:
     static bool getDriveName(std::string* dst, const std::string& src);
     // Removes the drive name from the path specified in "src" and stores it in "dst".
     static void getPathExceptDrive(std::string* dst, const std::string& src);
+
+    // Same as above, without allocating ("dst" and the returned path point into "src")
+    static bool getDriveName(std::string_view* dst, std::string_view src);
+    static std::string_view getPathExceptDrive(std::string_view src);
 };
 
 }
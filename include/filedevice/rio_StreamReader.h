@@ -0,0 +1,105 @@
+#ifndef RIO_FILE_STREAM_READER_H
+#define RIO_FILE_STREAM_READER_H
+
+#include <filedevice/rio_AsyncLoad.h>
+
+#include <condition_variable>
+#include <mutex>
+
+namespace rio {
+
+class StreamReader
+{
+    // Streams a large file (e.g., movies, audio banks, world data) in fixed-size chunks, so that it never
+    // has to be resident as a whole: chunks are read ahead into a ring of buffers on FileDeviceMgr's I/O threads,
+    // and the consumer processes each chunk as it arrives, handing its buffer back to be refilled.
+    // Memory used is the size of the ring, whatever the size of the file.
+    // A stream may start at any offset a FileDevice can seek to (Up to 0x7FFFFFFF), and is read to the end of the file.
+    // Files are streamed as they are stored (Compressed files are not decompressed).
+    // A reader can be used from any single thread.
+
+public:
+    static constexpr u32 cChunkSizeDefault = 0x40000;
+    static constexpr u32 cChunkNumDefault = 4;
+
+    struct Chunk
+    {
+        const u8*   data;
+        u32         size;       // Equal to the chunk size, except for the last chunk of the file
+        u64         offset;     // Offset of the chunk in the file
+    };
+
+public:
+    // Parameters:
+    // - chunk_size: Size of each chunk (Rounded up to FileDevice::cBufferMinAlignment)
+    // - chunk_num: Number of buffers in the ring (At least 2, so that a chunk is read while another is processed)
+    // - priority: Priority of the reads on the I/O threads
+    StreamReader(u32 chunk_size = cChunkSizeDefault, u32 chunk_num = cChunkNumDefault,
+                 AsyncLoad::Priority priority = AsyncLoad::PRIORITY_HIGH);
+    ~StreamReader();
+
+private:
+    StreamReader(const StreamReader&);
+    StreamReader& operator=(const StreamReader&);
+
+public:
+    // Open the file at "path" (Through FileDeviceMgr) and start reading it ahead from "offset"
+    // Fails if "offset" is larger than 0x7FFFFFFF, or if the ring cannot be allocated.
+    bool tryOpen(const std::string& path, u64 offset = 0);
+    // Stop reading (Waiting for the read in progress, if any) and close the file
+    void close();
+
+    bool isOpen() const { return mHandle.isOpen(); }
+
+    // Get the next chunk, which stays valid until release()
+    // Parameters:
+    // - wait: Block until the chunk has been read, if it has not yet
+    // Returns false at the end of the file, on a read error, or if "wait" is false and the chunk is not read yet.
+    bool acquire(Chunk* chunk, bool wait = true);
+    // Hand the acquired chunk back, so that its buffer is refilled
+    void release();
+
+    // Have all chunks been acquired
+    bool isEnd() const;
+    bool isError() const;
+
+    u32 getChunkSize() const { return mChunkSize; }
+    u32 getChunkNum() const { return mChunkNum; }
+
+private:
+    // Queue the read of the next chunk, if a buffer is free (mCS must be locked)
+    void startRead_();
+    static void readMain_(void* arg);
+
+    // Seek the handle to "offset" (Devices seek by signed 32-bit offsets)
+    bool seekTo_(u64 offset);
+
+private:
+    struct Slot
+    {
+        u32     size;
+        u64     offset;
+    };
+
+private:
+    FileHandle              mHandle;            // Only used by the thread reading
+    const u32               mChunkSize;
+    const u32               mChunkNum;
+    const s32               mPriority;
+    u8*                     mBuffer;            // mChunkNum chunks
+    Slot*                   mSlots;
+    u32                     mFirstIndex;        // Slot of the next chunk to acquire
+    u32                     mReadyNum;          // Slots read, from mFirstIndex
+    u64                     mReadOffset;        // Offset of the next chunk to read
+    bool                    mAcquired;          // Is the chunk at mFirstIndex acquired
+    bool                    mReading;           // Is a read queued or in progress
+    bool                    mReadEnd;           // Has the end of the file been read
+    bool                    mError;
+    bool                    mClosing;
+    mutable std::mutex      mCS;
+    std::condition_variable mCond;
+};
+
+}
+
+#endif // RIO_FILE_STREAM_READER_H
@@ -1,7 +1,7 @@
 #ifndef RIO_GFX_LYR_DRAWABLE_H
 #define RIO_GFX_LYR_DRAWABLE_H
 
-#include <misc/rio_Types.h>
+#include <math/rio_MathTypes.h>
 
 namespace rio { namespace lyr {
 
@@ -9,13 +9,17 @@ class Layer;
 
 struct DrawInfo
 {
-    const Layer&    parent_layer;       // Reference to the layer the drawable object's draw method belongs to.
-    u32             render_step_idx;    // Current render step of the layer the drawable object's draw method belongs to.
+    const Layer&        parent_layer;       // Reference to the layer the drawable object's draw method belongs to.
+    u32                 render_step_idx;    // Current render step of the layer the drawable object's draw method belongs to.
+    const BaseMtx34f&   view_mtx;           // View matrix of the layer's camera, for the frame being rendered.
+    const BaseMtx44f&   proj_mtx;           // Projection matrix of the layer's projection, for the frame being rendered.
 };
 
 class IDrawable
 {
     // Base interface for a drawable object, that is, an object with "draw methods".
+    // When the main loop is pipelined, a drawable must only be destroyed while nothing is rendered
+    // (e.g., in a task's exit_(), see Renderer::setPipelined()).
 
 public:
     // Draw method function pointer type.
@@ -42,7 +46,7 @@ public:
 private:
     IDrawable*              mObjPtr;    // Draw method owner object pointer.
     IDrawable::DrawMethod   mFuncPtr;   // Draw method function pointer.
-    const s32               mPriority;  // Priority of this draw method. (Smaller value = drawn later)
+    s32                     mPriority;  // Priority of this draw method. (Smaller value = drawn later)
 
     friend class Renderer;
 };
@@ -0,0 +1,91 @@
+#ifndef RIO_GFX_LYR_FRAME_BUFFERED_H
+#define RIO_GFX_LYR_FRAME_BUFFERED_H
+
+#include <container/rio_TList.h>
+
+namespace rio { namespace lyr {
+
+class Renderer;
+
+class IFrameBuffered
+{
+    // Base class of FrameBuffered<T>, registers every instance with the Renderer's publish step.
+
+public:
+    typedef TListNode<IFrameBuffered*> ListNode;
+    typedef TList<IFrameBuffered*> List;
+
+protected:
+    IFrameBuffered();
+    virtual ~IFrameBuffered();
+
+private:
+    IFrameBuffered(const IFrameBuffered&);
+    IFrameBuffered& operator=(const IFrameBuffered&);
+
+protected:
+    // Is the Renderer running in pipelined mode (See Renderer::setPipelined())
+    static bool isPipelined_() { return sPipelined; }
+
+private:
+    // Copy the current value to the published value
+    virtual void publish_() = 0;
+
+    // Publish all instances (Called by the Renderer)
+    static void publishAll_();
+
+private:
+    ListNode    mListNode;
+
+    static bool sPipelined;
+
+    friend class Renderer;
+};
+
+template <typename T>
+class FrameBuffered : public IFrameBuffered
+{
+    // Per-frame state of a drawable object, written by tasks and read by draw methods.
+    //
+    // When the main loop is pipelined, draw methods of frame N run on the render thread
+    // while tasks already calculate frame N+1, so they must not read state that calc_() writes.
+    // Such state is kept in a FrameBuffered<T> instead: tasks write it through get(),
+    // draw methods read it through read(), which returns a copy made when the frame was published.
+    // When the main loop is not pipelined, read() returns the current value, without any copy.
+    //
+    // T must be copy-assignable.
+
+public:
+    FrameBuffered()
+        : mValue()
+        , mPublished()
+    {
+    }
+
+    explicit FrameBuffered(const T& value)
+        : mValue(value)
+        , mPublished(value)
+    {
+    }
+
+    // Current value (For tasks)
+    T& get() { return mValue; }
+    const T& get() const { return mValue; }
+
+    // Value of the frame being rendered (For draw methods)
+    const T& read() const { return isPipelined_() ? mPublished : mValue; }
+
+private:
+    void publish_() override
+    {
+        mPublished = mValue;
+    }
+
+private:
+    T   mValue;
+    T   mPublished;
+};
+
+} }
+
+#endif // RIO_GFX_LYR_FRAME_BUFFERED_H
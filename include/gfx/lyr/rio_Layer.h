@@ -29,9 +29,13 @@ public:
     {
     }
 
+private:
+    // Insert a draw method after those of higher or equal priority
+    void insert_(const DrawMethod& draw_method);
+
 private:
     const char* mName;
-    std::multiset<DrawMethod> mDrawMethods;
+    std::vector<DrawMethod> mDrawMethods;   // Sorted by priority, contiguous for the renderer to iterate over
 
     friend class Layer;
     friend class Renderer;
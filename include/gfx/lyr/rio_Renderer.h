@@ -1,8 +1,11 @@
 #ifndef RIO_GFX_LYR_RENDERER_H
 #define RIO_GFX_LYR_RENDERER_H
 
+#include <gfx/lyr/rio_FrameBuffered.h>
 #include <gfx/lyr/rio_Layer.h>
 
+#include <vector>
+
 namespace rio { namespace lyr {
 
 class Renderer
@@ -34,27 +37,75 @@ public:
     }
 
     // Remove layer
+    // (When pipelined, the layer is deleted by the next publish(), as it may still be rendered until then)
     void removeLayer(Layer::iterator it)
     {
         Layer* p_layer = Layer::peelIterator(it);
         mLayers.erase(it);
-        delete p_layer;
+        destroyLayer_(p_layer);
     }
 
     // Remove all layers
     void clearLayers()
     {
         for (Layer* p_layer : mLayers)
-            delete p_layer;
+            destroyLayer_(p_layer);
 
         mLayers.clear();
     }
 
+    // Set whether the main loop is pipelined, i.e., whether layers are rendered on a render thread
+    // while tasks calculate the next frame (See rio::InitializeArg).
+    // In pipelined mode, render() draws the frame captured by the last publish(),
+    // and draw methods must read per-frame state through FrameBuffered<T>::read(),
+    // and the layer's camera and projection through DrawInfo::view_mtx and DrawInfo::proj_mtx
+    // (The layer's camera and projection objects may already be updated for the next frame).
+    // Drawables are still called by the render thread after being removed from their layer, until the next publish():
+    // they must not be destroyed in a task's calc_(), but in its exit_() (Which runs while nothing is rendered).
+    void setPipelined(bool pipelined);
+    bool isPipelined() const { return mPipelined; }
+
+    // Capture the layers, their settings, camera and projection matrices and draw methods,
+    // and all FrameBuffered<T> values, for the next render()
+    // (Must not be called while rendering; called by render() itself when not pipelined)
+    void publish();
+
     // Render all layers
-    void render() const;
+    void render();
+
+private:
+    void destroyLayer_(Layer* p_layer);
+
+    void render_() const;
 
 private:
-     Layer::List mLayers; // List of all layers
+    struct LayerState
+    {
+        const Layer*                    p_layer;
+        Color4f                         clear_color;
+        f32                             clear_depth;
+        u8                              clear_stencil;
+        decltype(Layer::mViewport)      viewport;
+        decltype(Layer::mScissor)       scissor;
+        BitFlag8                        flags;
+        BaseMtx34f                      view_mtx;
+        BaseMtx44f                      proj_mtx;
+        u32                             draw_call_begin;    // Range of the layer's draw calls in mDrawCalls
+        u32                             draw_call_end;
+    };
+
+    struct DrawCall
+    {
+        IDrawable*              p_obj;
+        IDrawable::DrawMethod   p_func;
+        u32                     render_step_idx;
+    };
+
+    Layer::List                mLayers;            // List of all layers
+    std::vector<LayerState>    mLayerStates;       // Layers captured by publish()
+    std::vector<DrawCall>      mDrawCalls;         // Draw methods captured by publish(), in drawing order
+    std::vector<Layer*>        mDestroyedLayers;   // Layers removed while pipelined, deleted by publish()
+    bool                       mPipelined;
 };
 
 } }
@@ -1,10 +1,7 @@
 #ifndef RIO_GFX_MDL_RES_MODEL_CACHER_H
 #define RIO_GFX_MDL_RES_MODEL_CACHER_H
 
-#include <misc/rio_Types.h>
-
-#include <unordered_map>
-#include <string>
+#include <container/rio_StringMap.h>
 
 namespace rio { namespace mdl { namespace res {
 
@@ -13,7 +10,8 @@ class Model;
 class ModelCacher
 {
     // Model resource cache manager class
-    // TODO: Reference counter + unload
+    // Model files are kept in the ResourceCache, referenced once per key they are loaded with:
+    // unloadModel() releases that reference, after which the file stays cached until it is evicted.
 
 public:
     static bool createSingleton();
@@ -30,11 +28,18 @@ private:
     ModelCacher& operator=(const ModelCacher&);
 
 public:
-    Model* loadModel(const char* base_fname, const char* key);
-    Model* get(const char* key) const;
+    Model* loadModel(const char* base_fname, const HashedString& key);
+    Model* get(const HashedString& key) const;
+
+    // Release the model loaded with "key" (Which must not be used afterwards)
+    void unloadModel(const HashedString& key);
+
+private:
+    static void destroyFile_(void* file);
+    static void keepFile_(void* file);
 
 private:
-    std::unordered_map<std::string, Model*> mModelCache;
+    StringMap<Model*> mModelCache;
 };
 
 } } }
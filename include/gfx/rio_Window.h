@@ -23,15 +23,22 @@ public:
     // - resizable: Should window be resizable
     // - gl_major: OpenGL Context Major Version
     // - gl_minor: OpenGL Context Minor Version
+    // - visible: Should window be shown (A hidden window can still be rendered to, e.g., for headless runs)
     static bool createSingleton(
         u32 width = 1280, u32 height = 720
 #if RIO_IS_WIN
         , bool resizable = false
         , u32 gl_major = 4
         , u32 gl_minor = 0
+        , bool visible = true
 #endif // RIO_IS_WIN
     );
 
+    // Create window singleton instance without a native window or graphics context (Null graphics).
+    // Only the size can be queried, and the window is always running.
+    // Nothing must be rendered, and no other function may be called.
+    static bool createSingletonNull(u32 width = 1280, u32 height = 720);
+
     // Destroy window singleton instance
     static void destroySingleton();
 
@@ -45,6 +52,9 @@ public:
     // Get window current height
     u32 getHeight() const { return mHeight; }
 
+    // Check if window was created by createSingletonNull()
+    bool isNull() const { return mIsNull; }
+
     // Get the native window instance
     const NativeWindow& getNativeWindow() const
     {
@@ -95,6 +105,19 @@ public:
         return sInstance->mNativeWindow.mpGLFWwindow;
     }
 
+    // Process pending window events (Must be called from the main thread)
+    void pollEvents();
+
+    // Set whether swapBuffers() processes pending window events (Default: true)
+    // Should be disabled when buffers are swapped from a thread other than the main thread
+    void setPollEventsOnSwap(bool enable)
+    {
+        mNativeWindow.mPollEventsOnSwap = enable;
+    }
+
+    // Release the context from the calling thread, so that it can be made current on another thread
+    void releaseContext() const;
+
 #endif // RIO_IS_WIN
 
     NativeTexture2DHandle getWindowColorBufferTexture() const
@@ -149,6 +172,7 @@ private:
 
         mWidth  = width;
         mHeight = height;
+        mIsNull = false;
     }
 
     Window(const Window&);
@@ -160,6 +184,7 @@ private:
         bool resizable
         , u32 gl_major
         , u32 gl_minor
+        , bool visible
 #endif // RIO_IS_WIN
     );
     // Terminate the window
@@ -194,6 +219,7 @@ private:
 
     u32             mWidth;         // Current width
     u32             mHeight;        // Current height
+    bool            mIsNull;        // Created without a native window
     NativeWindow    mNativeWindow;  // Native window instance
 };
 
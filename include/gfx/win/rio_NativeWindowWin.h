@@ -32,6 +32,7 @@ public:
         , mDepthBufferTextureFormat(TEXTURE_FORMAT_INVALID)
         , mDepthBufferCopyFramebufferSrc(GL_NONE)
         , mDepthBufferCopyFramebufferDst(GL_NONE)
+        , mPollEventsOnSwap(true)
     {
         setSwapInterval_(1);
     }
@@ -94,6 +95,8 @@ private:
     Duration mFrameDuration;
     mutable TimePoint mFrameEndTarget;
 
+    bool mPollEventsOnSwap;
+
     friend class Window;
 };
 
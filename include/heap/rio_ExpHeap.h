@@ -0,0 +1,72 @@
+#ifndef RIO_EXP_HEAP_H
+#define RIO_EXP_HEAP_H
+
+#include <heap/rio_Heap.h>
+
+namespace rio {
+
+class ExpHeap : public Heap
+{
+    // General-purpose heap: allocations of any size and alignment, freed in any order.
+    // Free blocks are kept in a list sorted by address, allocations take the smallest free block they fit in
+    // (Best fit), and freed blocks are merged with their free neighbors.
+    // Each allocation is preceded by a header of cHeaderSize bytes.
+
+public:
+    static constexpr size_t cHeaderSize = 16;
+
+public:
+    // Parameters:
+    // - size: Size of the heap's block, headers included
+    // - name: Name of the heap (For reports)
+    // - parent: Heap to allocate the block from (Null = system)
+    // Returns null if the block could not be allocated.
+    static ExpHeap* create(size_t size, const char* name, Heap* parent = nullptr);
+
+    virtual const char* getKindName() const { return "ExpHeap"; }
+
+    // Size of an allocation (At least the size it was allocated with)
+    size_t getAllocSize(const void* ptr) const;
+
+protected:
+    ExpHeap(const char* name, Heap* parent, void* start, size_t size);
+    virtual ~ExpHeap() {}
+
+    virtual void* doAlloc_(size_t size, u32 alignment);
+    virtual void doFree_(void* ptr);
+    virtual void doFreeAll_();
+    virtual size_t doGetFreeSize_() const;
+    virtual size_t doGetMaxAllocatableSize_(u32 alignment) const;
+    virtual u32 doGetFreeBlockNum_() const;
+    virtual f32 doGetFragmentation_() const;
+
+private:
+    struct FreeBlock
+    {
+        size_t      size;           // Including this header
+        FreeBlock*  next;           // Next free block by address
+    };
+
+    struct UsedBlock
+    {
+        u32         magic;
+        u32         padding;        // Unused bytes before this header (Alignment)
+        size_t      size;           // Size available after this header
+    };
+    static_assert(sizeof(UsedBlock) <= cHeaderSize);
+
+    static constexpr u32 cUsedMagic = 0x55534544; // USED
+    static constexpr size_t cMinFreeBlockSize = (sizeof(FreeBlock) + cMinAlignment - 1) & ~size_t(cMinAlignment - 1);
+
+    static UsedBlock* getUsedBlock_(const void* ptr);
+
+    // Address of an allocation of "alignment" in "block" (The allocation may not fit)
+    static u8* getAllocAddress_(const FreeBlock* block, u32 alignment);
+
+private:
+    FreeBlock*  mFreeList;
+};
+
+}
+
+#endif // RIO_EXP_HEAP_H
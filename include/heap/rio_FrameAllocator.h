@@ -0,0 +1,139 @@
+#ifndef RIO_FRAME_ALLOCATOR_H
+#define RIO_FRAME_ALLOCATOR_H
+
+#include <misc/rio_Types.h>
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace rio {
+
+class FrameAllocator
+{
+    // Linear allocator for transient data that is only used until the end of the frame after the one it is
+    // allocated in (e.g., sorted draw lists, temporary vertex data, formatted strings).
+    // An allocation is a pointer bump in the current frame's buffer, and is never freed individually: the main loop
+    // calls flip() once per frame, after Window::swapBuffers(), which makes the other buffer current and resets it.
+    // Data allocated during frame N therefore stays valid while frame N is rendered, even on the render thread of
+    // the pipelined main loop, which renders frame N while frame N + 1 is calculated.
+    // Allocations that do not fit in the current buffer fall back to MemUtil::alloc(), and are freed when the buffer
+    // is reset. alloc() can be called from any thread, but not concurrently with flip().
+
+public:
+    // Parameters:
+    // - size: Size of each of the two buffers (Allocated with MemUtil::alloc())
+    static bool createSingleton(size_t size);
+    static void destroySingleton();
+    static FrameAllocator* instance() { return sInstance; }
+
+private:
+    static FrameAllocator* sInstance;
+
+    FrameAllocator(size_t size);
+    ~FrameAllocator();
+
+    FrameAllocator(const FrameAllocator&);
+    FrameAllocator& operator=(const FrameAllocator&);
+
+public:
+    static constexpr u32 cMinAlignment = 8;
+
+    struct Stats
+    {
+        size_t  size;               // Size of each buffer
+        size_t  used_size;          // Size used by the current frame so far (Including overflow)
+        size_t  high_water_mark;    // Largest size used by a single frame (Including overflow)
+        u32     overflow_num;       // Number of allocations that did not fit in their frame's buffer
+        size_t  overflow_size;      // Total size of these allocations
+        u32     frame_num;          // Number of frames since the allocator was created
+    };
+
+public:
+    // Allocate "size" bytes valid until the end of the next frame (Null only if an overflow allocation fails)
+    void* alloc(size_t size, u32 alignment = cMinAlignment);
+
+    template <typename T>
+    T* allocArray(size_t num)
+    {
+        return static_cast<T*>(alloc(sizeof(T) * num, alignof(T) > cMinAlignment ? alignof(T) : cMinAlignment));
+    }
+
+    // printf()-like formatting into frame memory (Returns an empty string on failure)
+    const char* format(const char* fmt, ...);
+
+    // End the current frame (Called by the main loop)
+    void flip();
+
+    size_t getSize() const { return mSize; }
+    size_t getUsedSize() const;
+    size_t getHighWaterMark() const { return mHighWaterMark; }
+
+    void getStats(Stats* stats) const;
+    void printStats() const;
+
+private:
+    struct Buffer
+    {
+        u8*                 start;
+        std::atomic<size_t> offset;         // End of the last allocation, relative to "start"
+        std::vector<void*>  overflow;       // Allocations that did not fit, freed when the buffer is reset
+        size_t              overflow_size;
+    };
+
+    void* allocOverflow_(Buffer& buffer, size_t size, u32 alignment);
+    void reset_(Buffer& buffer);
+
+private:
+    Buffer              mBuffers[2];
+    u32                 mCurrent;           // Index of the current frame's buffer
+    size_t              mSize;
+    size_t              mHighWaterMark;
+    u32                 mOverflowNum;
+    size_t              mOverflowSize;
+    u32                 mFrameNum;
+    mutable std::mutex  mOverflowCS;
+};
+
+template <typename T>
+class FrameStlAllocator
+{
+    // STL allocator allocating from FrameAllocator, e.g., for building a draw list during a frame:
+    //   std::vector<T, FrameStlAllocator<T>> (Or FrameVector<T>)
+    // deallocate() does nothing, and containers using it must not outlive the end of the next frame.
+
+public:
+    typedef T value_type;
+
+    FrameStlAllocator() = default;
+
+    template <typename U>
+    FrameStlAllocator(const FrameStlAllocator<U>&)
+    {
+    }
+
+    T* allocate(size_t num)
+    {
+        T* const ptr = FrameAllocator::instance()->allocArray<T>(num);
+        RIO_ASSERT(ptr);
+        return ptr;
+    }
+
+    void deallocate(T*, size_t)
+    {
+    }
+
+    template <typename U>
+    bool operator==(const FrameStlAllocator<U>&) const { return true; }
+
+    template <typename U>
+    bool operator!=(const FrameStlAllocator<U>&) const { return false; }
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+
+}
+
+#endif // RIO_FRAME_ALLOCATOR_H
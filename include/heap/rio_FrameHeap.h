@@ -0,0 +1,54 @@
+#ifndef RIO_FRAME_HEAP_H
+#define RIO_FRAME_HEAP_H
+
+#include <heap/rio_Heap.h>
+
+namespace rio {
+
+class FrameHeap : public Heap
+{
+    // Stack heap: allocations are taken one after the other from the start of the heap, without any header,
+    // and are only freed all at once (freeAll()), or back to a recorded state (restoreState()).
+    // free() of a single allocation does nothing.
+    // Suited to data with a common lifetime, e.g., a level's data or the temporary data of a load.
+
+public:
+    // Position in the heap, to free every allocation made after it
+    struct State
+    {
+        u8* head;
+        u32 alloc_num;
+    };
+
+public:
+    // Parameters:
+    // - size: Size of the heap's block
+    // - name: Name of the heap (For reports)
+    // - parent: Heap to allocate the block from (Null = system)
+    // Returns null if the block could not be allocated.
+    static FrameHeap* create(size_t size, const char* name, Heap* parent = nullptr);
+
+    virtual const char* getKindName() const { return "FrameHeap"; }
+
+    State recordState() const;
+    // Free every allocation made since "state" was recorded
+    void restoreState(const State& state);
+
+protected:
+    FrameHeap(const char* name, Heap* parent, void* start, size_t size);
+    virtual ~FrameHeap() {}
+
+    virtual void* doAlloc_(size_t size, u32 alignment);
+    virtual void doFree_(void* ptr);
+    virtual void doFreeAll_();
+    virtual size_t doGetFreeSize_() const;
+    virtual size_t doGetMaxAllocatableSize_(u32 alignment) const;
+    virtual u32 doGetFreeBlockNum_() const;
+
+private:
+    u8*     mHead;          // Start of the free space
+};
+
+}
+
+#endif // RIO_FRAME_HEAP_H
@@ -0,0 +1,98 @@
+#ifndef RIO_HEAP_H
+#define RIO_HEAP_H
+
+#include <misc/rio_Types.h>
+
+#include <mutex>
+#include <string>
+
+namespace rio {
+
+class Heap
+{
+    // Base class of heaps, each managing a contiguous block of memory (See ExpHeap, FrameHeap and UnitHeap).
+    // A heap's block is allocated from its parent heap or, if it has none, from the system.
+    // Heaps are registered to HeapMgr, through which MemUtil::free() finds the heap owning any pointer,
+    // and can be made the heap MemUtil::alloc() allocates from (See HeapMgr::setCurrentHeap()).
+    // Every heap can be used from any thread.
+
+public:
+    // Minimum alignment of every allocation (And of the size of every block)
+    static constexpr u32 cMinAlignment = 8;
+
+    struct Stats
+    {
+        size_t  size;                   // Size of the heap's block
+        size_t  free_size;              // Total free size
+        size_t  max_allocatable_size;   // Largest allocation that can succeed (Minimum alignment)
+        u32     free_block_num;         // Number of free blocks
+        u32     alloc_num;              // Number of live allocations
+        f32     fragmentation;          // 1 - max_allocatable_size / free_size for most heaps (0 = a single free block)
+    };
+
+public:
+    // Destroy the heap, releasing its block to its parent (The heap must no longer be in use, nor have child heaps)
+    void destroy();
+
+protected:
+    Heap(const char* name, Heap* parent, void* start, size_t size);
+    virtual ~Heap();
+
+private:
+    Heap(const Heap&);
+    Heap& operator=(const Heap&);
+
+public:
+    // Returns null if the heap does not have enough free memory
+    void* tryAlloc(size_t size, u32 alignment = cMinAlignment);
+    void free(void* ptr);
+    // Free every allocation
+    void freeAll();
+
+    size_t getFreeSize() const;
+    // Largest allocation of the given alignment that can succeed
+    size_t getMaxAllocatableSize(u32 alignment = cMinAlignment) const;
+    void getStats(Stats* stats) const;
+    void printStats() const;
+
+    bool isInclude(const void* ptr) const
+    {
+        return mStart <= ptr && ptr < mStart + mSize;
+    }
+
+    const char* getName() const { return mName.c_str(); }
+    Heap* getParent() const { return mParent; }
+    u8* getStartAddress() const { return mStart; }
+    size_t getSize() const { return mSize; }
+
+    // Kind of heap (For reports)
+    virtual const char* getKindName() const = 0;
+
+protected:
+    // mCS is locked while the following are called
+    virtual void* doAlloc_(size_t size, u32 alignment) = 0;
+    virtual void doFree_(void* ptr) = 0;
+    virtual void doFreeAll_() = 0;
+    virtual size_t doGetFreeSize_() const = 0;
+    virtual size_t doGetMaxAllocatableSize_(u32 alignment) const = 0;
+    virtual u32 doGetFreeBlockNum_() const = 0;
+    // 1 - (Largest allocation) / (Free size) by default
+    virtual f32 doGetFragmentation_() const;
+
+    // Allocate the block of a heap from "parent" (Or from the system, if null)
+    static void* allocBlock_(Heap* parent, size_t size, u32 alignment);
+    // Register a newly created heap to HeapMgr
+    static void register_(Heap* heap);
+
+protected:
+    std::string         mName;
+    Heap*               mParent;
+    u8*                 mStart;
+    size_t              mSize;
+    u32                 mAllocNum;
+    mutable std::mutex  mCS;
+};
+
+}
+
+#endif // RIO_HEAP_H
@@ -0,0 +1,90 @@
+#ifndef RIO_HEAP_MGR_H
+#define RIO_HEAP_MGR_H
+
+#include <heap/rio_Heap.h>
+
+#include <mutex>
+#include <vector>
+
+namespace rio {
+
+class ExpHeap;
+
+class HeapMgr
+{
+    // Keeps track of every heap, and of the heap MemUtil::alloc() allocates from on each thread (The current heap).
+    // The current heap of a thread is the one last set on it with setCurrentHeap() (Or ScopedCurrentHeapSetter),
+    // or the root heap if none was set; with no root heap, MemUtil::alloc() allocates from the system.
+    // MemUtil::free() releases memory to the heap that contains it, whichever heap is current.
+    // In debug builds, the manager also owns MemTracker, whose leak report is printed when it is destroyed.
+
+public:
+    // Parameters:
+    // - root_heap_size: Size of the root heap (An ExpHeap allocated from the system), 0 = no root heap
+    static bool createSingleton(size_t root_heap_size = 0);
+    static void destroySingleton();
+    static HeapMgr* instance() { return sInstance; }
+
+private:
+    static HeapMgr* sInstance;
+
+    HeapMgr();
+    ~HeapMgr();
+
+    HeapMgr(const HeapMgr&);
+    HeapMgr& operator=(const HeapMgr&);
+
+public:
+    ExpHeap* getRootHeap() const { return mRootHeap; }
+
+    // Current heap of the calling thread (Null = system)
+    static Heap* getCurrentHeap();
+    // Set the current heap of the calling thread (Null = the root heap)
+    // Returns the previous current heap set on the thread (Null if none was set).
+    static Heap* setCurrentHeap(Heap* heap);
+
+    // Innermost heap containing "ptr" (Null if no heap contains it)
+    Heap* findContainHeap(const void* ptr) const;
+
+    u32 getHeapNum() const;
+    // Print the statistics of every heap, including their fragmentation (See Heap::printStats())
+    void printStats() const;
+
+private:
+    void registerHeap_(Heap* heap);
+    void unregisterHeap_(Heap* heap);
+
+private:
+    ExpHeap*            mRootHeap;
+    std::vector<Heap*>  mHeaps;
+    mutable std::mutex  mCS;
+
+    friend class Heap;
+};
+
+class ScopedCurrentHeapSetter
+{
+    // Makes a heap the current heap of the calling thread for its lifetime (See HeapMgr::setCurrentHeap())
+
+public:
+    ScopedCurrentHeapSetter(Heap* heap)
+        : mPrevHeap(HeapMgr::setCurrentHeap(heap))
+    {
+    }
+
+    ~ScopedCurrentHeapSetter()
+    {
+        HeapMgr::setCurrentHeap(mPrevHeap);
+    }
+
+private:
+    ScopedCurrentHeapSetter(const ScopedCurrentHeapSetter&);
+    ScopedCurrentHeapSetter& operator=(const ScopedCurrentHeapSetter&);
+
+private:
+    Heap*   mPrevHeap;
+};
+
+}
+
+#endif // RIO_HEAP_MGR_H
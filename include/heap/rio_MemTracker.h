@@ -0,0 +1,153 @@
+#ifndef RIO_MEM_TRACKER_H
+#define RIO_MEM_TRACKER_H
+
+#include <misc/rio_Types.h>
+
+#ifdef RIO_DEBUG
+    #define RIO_MEM_TRACKING 1
+#else
+    #define RIO_MEM_TRACKING 0
+#endif // RIO_DEBUG
+
+#if RIO_MEM_TRACKING
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#endif // RIO_MEM_TRACKING
+
+namespace rio {
+
+#if RIO_MEM_TRACKING
+
+class MemTracker
+{
+    // Records every allocation of MemUtil::alloc() under the tag of the calling thread (See ScopedMemTag), to report
+    // the live and peak size used by each subsystem, the allocations made during each frame, and the allocations
+    // still alive when HeapMgr is destroyed at rio::Exit() (Leaks).
+    // Tags are names that must outlive the tracker (e.g., string literals), compared by content.
+    // Created and destroyed along with HeapMgr. Debug builds only (RIO_MEM_TRACKING): in release builds, this class
+    // does not exist and ScopedMemTag does nothing.
+
+public:
+    static bool createSingleton();
+    static void destroySingleton();
+    static MemTracker* instance() { return sInstance; }
+
+private:
+    static MemTracker* sInstance;
+
+    MemTracker();
+    ~MemTracker();
+
+    MemTracker(const MemTracker&);
+    MemTracker& operator=(const MemTracker&);
+
+public:
+    // Tag of allocations made outside of any ScopedMemTag
+    static constexpr const char* cUntagged = "Untagged";
+
+    struct TagStats
+    {
+        const char* name;
+        size_t      live_size;          // Size of the live allocations
+        u32         live_num;           // Number of live allocations
+        size_t      peak_size;          // Largest live size so far
+        u64         total_alloc_num;    // Number of allocations since the tracker was created
+        u32         frame_alloc_num;    // Number of allocations during the last frame
+        size_t      frame_alloc_size;   // Their total size
+    };
+
+public:
+    // Current tag of the calling thread
+    static const char* getCurrentTag();
+    // Set the current tag of the calling thread (Null = cUntagged)
+    // Returns the previous one.
+    static const char* setCurrentTag(const char* tag);
+
+    // Called by MemUtil
+    void recordAlloc(const void* ptr, size_t size);
+    void recordFree(const void* ptr);
+
+    // Account memory allocated outside of MemUtil (e.g., by third-party libraries) to "tag"
+    void recordExternalAlloc(const char* tag, size_t size);
+    void recordExternalFree(const char* tag, size_t size);
+
+    // End the current frame (Called by the main loop)
+    void endFrame();
+
+    // Returns false if no allocation was ever made with "tag"
+    bool getTagStats(const char* tag, TagStats* stats) const;
+    void getAllTagStats(std::vector<TagStats>* stats) const;
+
+    size_t getLiveSize() const;
+    size_t getPeakSize() const;
+
+    void printStats() const;
+    // Print the allocations that are still alive, by tag (Returns their number)
+    u32 reportLeaks() const;
+
+private:
+    struct Tag
+    {
+        TagStats    stats;
+        u32         frame_alloc_num;    // Allocations during the current frame
+        size_t      frame_alloc_size;
+    };
+
+    struct Record
+    {
+        size_t  size;
+        u32     tag;                    // Index in mTags
+        u32     frame;                  // Frame the allocation was made in
+    };
+
+    u32 findTag_(const char* name);
+    void addAlloc_(u32 tag, size_t size);
+    void removeAlloc_(u32 tag, size_t size);
+
+private:
+    std::vector<Tag>                            mTags;
+    std::unordered_map<const void*, Record>     mRecords;
+    size_t                                      mLiveSize;
+    size_t                                      mPeakSize;
+    u32                                         mFrame;
+    mutable std::mutex                          mCS;
+};
+
+#endif // RIO_MEM_TRACKING
+
+class ScopedMemTag
+{
+    // Tags the allocations of the calling thread for its lifetime (See MemTracker)
+    // Compiled out in release builds.
+
+public:
+#if RIO_MEM_TRACKING
+    ScopedMemTag(const char* tag)
+        : mPrevTag(MemTracker::setCurrentTag(tag))
+    {
+    }
+
+    ~ScopedMemTag()
+    {
+        MemTracker::setCurrentTag(mPrevTag);
+    }
+#else
+    ScopedMemTag(const char*)
+    {
+    }
+#endif // RIO_MEM_TRACKING
+
+private:
+    ScopedMemTag(const ScopedMemTag&);
+    ScopedMemTag& operator=(const ScopedMemTag&);
+
+#if RIO_MEM_TRACKING
+private:
+    const char* mPrevTag;
+#endif // RIO_MEM_TRACKING
+};
+
+}
+
+#endif // RIO_MEM_TRACKER_H
@@ -0,0 +1,60 @@
+#ifndef RIO_UNIT_HEAP_H
+#define RIO_UNIT_HEAP_H
+
+#include <heap/rio_Heap.h>
+
+namespace rio {
+
+class UnitHeap : public Heap
+{
+    // Heap of fixed-size units: every allocation takes one unit, in constant time and without any header,
+    // and the heap never fragments. Suited to many objects of the same size (e.g., nodes, handles, particles).
+    // Allocations larger than the unit size, or of a larger alignment than the unit alignment, fail.
+
+public:
+    // Parameters:
+    // - unit_size: Size of each unit (Rounded up to the unit alignment)
+    // - unit_num: Number of units
+    // - name: Name of the heap (For reports)
+    // - parent: Heap to allocate the block from (Null = system)
+    // - alignment: Alignment of every unit
+    // Returns null if the block could not be allocated.
+    static UnitHeap* create(size_t unit_size, u32 unit_num, const char* name, Heap* parent = nullptr, u32 alignment = cMinAlignment);
+
+    virtual const char* getKindName() const { return "UnitHeap"; }
+
+    size_t getUnitSize() const { return mUnitSize; }
+    u32 getUnitNum() const { return mUnitNum; }
+    u32 getUnitAlignment() const { return mUnitAlignment; }
+    u32 getFreeUnitNum() const;
+
+protected:
+    UnitHeap(const char* name, Heap* parent, void* start, size_t size, size_t unit_size, u32 unit_num, u32 alignment);
+    virtual ~UnitHeap() {}
+
+    virtual void* doAlloc_(size_t size, u32 alignment);
+    virtual void doFree_(void* ptr);
+    virtual void doFreeAll_();
+    virtual size_t doGetFreeSize_() const;
+    virtual size_t doGetMaxAllocatableSize_(u32 alignment) const;
+    virtual u32 doGetFreeBlockNum_() const;
+    // Units never fragment
+    virtual f32 doGetFragmentation_() const { return 0.0f; }
+
+private:
+    struct FreeUnit
+    {
+        FreeUnit*   next;
+    };
+
+private:
+    const size_t    mUnitSize;
+    const u32       mUnitNum;
+    const u32       mUnitAlignment;
+    FreeUnit*       mFreeList;
+    u32             mFreeUnitNum;
+};
+
+}
+
+#endif // RIO_UNIT_HEAP_H
@@ -25,14 +25,14 @@ inline void* MemUtil::set(void* ptr, u8 val, size_t size)
     return OSBlockSet(ptr, val, size);
 }
 
-inline void* MemUtil::alloc(size_t size, u32 alignment)
+inline void* MemUtil::allocSystem(size_t size, u32 alignment)
 {
     RIO_ASSERT(size && alignment);
 
     return MEMAllocFromDefaultHeapEx(size, alignment);
 }
 
-inline void MemUtil::free(void* ptr)
+inline void MemUtil::freeSystem(void* ptr)
 {
     RIO_ASSERT(ptr);
 
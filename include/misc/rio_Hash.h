@@ -0,0 +1,71 @@
+#ifndef RIO_HASH_H
+#define RIO_HASH_H
+
+#include <misc/rio_Types.h>
+
+#include <string>
+#include <string_view>
+
+namespace rio {
+
+class Hash
+{
+public:
+    // 32-bit FNV-1a (Must match tools that generate hashed data, e.g., tools/ArchivePacker)
+    static constexpr u32 cFNV1aOffsetBasis = 0x811C9DC5;
+    static constexpr u32 cFNV1aPrime       = 0x01000193;
+
+    static constexpr u32 calcFNV1a(const char* str, size_t len, u32 hash = cFNV1aOffsetBasis)
+    {
+        for (size_t i = 0; i < len; i++)
+            hash = (hash ^ u8(str[i])) * cFNV1aPrime;
+
+        return hash;
+    }
+
+    static constexpr u32 calcFNV1a(const char* str)
+    {
+        u32 hash = cFNV1aOffsetBasis;
+        for (; *str != '\0'; str++)
+            hash = (hash ^ u8(*str)) * cFNV1aPrime;
+
+        return hash;
+    }
+};
+
+class HashedString
+{
+    // String view along with its FNV-1a hash, computed once (At compile-time for constexpr instances), to look up
+    // maps keyed by strings without hashing or allocating on each lookup (See StringMap), e.g.:
+    //   static constexpr HashedString cKey = "title";
+    // The viewed string must outlive the instance.
+
+public:
+    constexpr HashedString(const char* str)
+        : mStr(str)
+        , mHash(Hash::calcFNV1a(mStr.data(), mStr.size()))
+    {
+    }
+
+    constexpr HashedString(std::string_view str)
+        : mStr(str)
+        , mHash(Hash::calcFNV1a(mStr.data(), mStr.size()))
+    {
+    }
+
+    HashedString(const std::string& str)
+        : HashedString(std::string_view(str))
+    {
+    }
+
+    constexpr std::string_view str() const { return mStr; }
+    constexpr u32 hash() const { return mHash; }
+
+private:
+    std::string_view    mStr;
+    u32                 mHash;
+};
+
+}
+
+#endif // RIO_HASH_H
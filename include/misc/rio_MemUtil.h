@@ -11,8 +11,15 @@ public:
     static void* copy(void* dst, const void* src, size_t size);
     static void* set(void* ptr, u8 val, size_t size);
 
+    // Allocate from the current heap of the calling thread, or from the system if there is none (See HeapMgr)
+    // The alignment (A power of 2) is honored on every platform. Returns null on failure.
     static void* alloc(size_t size, u32 alignment);
+    // Free memory returned by alloc(), to whichever heap it was allocated from
     static void free(void* ptr);
+
+    // Allocate from the system directly
+    static void* allocSystem(size_t size, u32 alignment);
+    static void freeSystem(void* ptr);
 };
 
 }
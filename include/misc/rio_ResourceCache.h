@@ -0,0 +1,149 @@
+#ifndef RIO_MISC_RESOURCE_CACHE_H
+#define RIO_MISC_RESOURCE_CACHE_H
+
+#include <container/rio_TList.h>
+#include <misc/rio_Types.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rio {
+
+class ResourceCache
+{
+    // Cache of loaded resources (Models, textures, shaders, sounds, ...) keyed by path, shared by all loaders.
+    // Every acquire() or add() of a resource references it, and every release() dereferences it.
+    // Resources that are no longer referenced stay cached, so that loading them again is free, until the total
+    // size of the cache exceeds its budget: the least recently released of them are then destroyed.
+    // With a budget of 0 (The default), resources are destroyed as soon as they are no longer referenced.
+    // Referenced resources are never destroyed, so the cache may stay over budget while they are in use.
+    // Can be used from any thread, resources are destroyed on the thread whose call evicted them.
+
+public:
+    // Function destroying an evicted resource
+    typedef void (*DestroyFunc)(void* resource);
+
+    struct Stats
+    {
+        u32     hit_num;            // acquire() calls that found their resource
+        u32     miss_num;           // acquire() calls that did not
+        u32     eviction_num;       // Resources destroyed to stay within the budget (Or by purge())
+        u32     resource_num;       // Cached resources
+        u32     unreferenced_num;   // Cached resources that are not referenced (Evictable)
+        size_t  size;               // Total size of the cached resources
+        size_t  budget;
+    };
+
+    static constexpr size_t cBudgetUnlimited = size_t(-1);
+
+public:
+    static bool createSingleton(size_t budget = 0);
+    static void destroySingleton();
+    static ResourceCache* instance() { return sInstance; }
+
+private:
+    static ResourceCache* sInstance;
+
+    ResourceCache(size_t budget);
+    ~ResourceCache();
+
+    ResourceCache(const ResourceCache&);
+    ResourceCache& operator=(const ResourceCache&);
+
+public:
+    // Find the resource cached at "path" and reference it
+    // Returns null if it is not cached, in which case the caller is expected to load it and add() it.
+    void* acquire(const std::string& path);
+
+    template <typename T>
+    T* acquire(const std::string& path)
+    {
+        return static_cast<T*>(acquire(path));
+    }
+
+    // Cache a newly loaded resource at "path", referenced once
+    // Parameters:
+    // - size: Memory used by the resource, counted against the budget
+    // - destroy_func: Function destroying the resource once evicted
+    // If a resource is already cached at "path" (e.g., loaded concurrently), "resource" is destroyed right away,
+    // and the cached resource is referenced and returned instead.
+    void* add(const std::string& path, void* resource, size_t size, DestroyFunc destroy_func);
+
+    // Cache a resource destroyed with delete
+    template <typename T>
+    T* add(const std::string& path, T* resource, size_t size)
+    {
+        return static_cast<T*>(add(path, resource, size, &ResourceCache::delete_<T>));
+    }
+
+    // Dereference a resource returned by acquire() or add()
+    // If "evict" is true and this was its last reference, the resource is destroyed right away
+    // (e.g., if it must not outlive the system it was created with).
+    void release(const void* resource, bool evict = false);
+
+    // Find the resource cached at "path" without referencing it (Nor counting a hit or a miss)
+    void* find(const std::string& path) const;
+
+    void setBudget(size_t budget);
+    size_t getBudget() const;
+
+    // Destroy every resource that is not referenced
+    void purge();
+    // Destroy every resource destroyed by "destroy_func" that is not referenced
+    // (e.g., before shutting down the system these resources were created with)
+    void purge(DestroyFunc destroy_func);
+
+    void getStats(Stats* stats) const;
+    void printStats() const;
+    void resetStats();
+
+private:
+    struct Entry
+    {
+        Entry()
+            : lru_node(this)
+        {
+        }
+
+        const std::string*  path;       // Key in mEntries
+        void*               resource;
+        size_t              size;
+        DestroyFunc         destroy_func;
+        u32                 ref_num;
+        TListNode<Entry*>   lru_node;   // In mLRUList while not referenced
+    };
+
+    typedef std::vector<Entry*> EntryArray;
+
+    // Remove the least recently released entries until the cache fits in "budget" (mCS must be locked)
+    void evict_(size_t budget, EntryArray* evicted);
+    // Remove an unreferenced entry (mCS must be locked)
+    void remove_(Entry* entry, EntryArray* evicted);
+    // Destroy removed entries (mCS must not be locked, since destroying a resource may release others)
+    static void destroy_(const EntryArray& entries);
+
+    template <typename T>
+    static void delete_(void* resource)
+    {
+        delete static_cast<T*>(resource);
+    }
+
+private:
+    std::unordered_map<std::string, Entry*>
+                                mEntries;       // By path
+    std::unordered_map<const void*, Entry*>
+                                mResources;     // By resource
+    TList<Entry*>               mLRUList;       // Unreferenced entries, least recently released first
+    size_t                      mSize;
+    size_t                      mBudget;
+    u32                         mHitNum;
+    u32                         mMissNum;
+    u32                         mEvictionNum;
+    mutable std::mutex          mCS;
+};
+
+}
+
+#endif // RIO_MISC_RESOURCE_CACHE_H
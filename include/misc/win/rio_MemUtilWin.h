@@ -5,6 +5,7 @@
 //#include <misc/rio_MemUtil.h>
 
 #include <cstring>
+#include <malloc.h>
 
 namespace rio {
 
@@ -24,18 +25,18 @@ inline void* MemUtil::set(void* ptr, u8 val, size_t size)
     return std::memset(ptr, val, size);
 }
 
-inline void* MemUtil::alloc(size_t size, u32 alignment)
+inline void* MemUtil::allocSystem(size_t size, u32 alignment)
 {
     RIO_ASSERT(size && alignment);
 
-    return new u8[size];
+    return _aligned_malloc(size, alignment);
 }
 
-inline void MemUtil::free(void* ptr)
+inline void MemUtil::freeSystem(void* ptr)
 {
     RIO_ASSERT(ptr);
 
-    delete[] (u8*)ptr;
+    _aligned_free(ptr);
 }
 
 }
@@ -8,8 +8,26 @@ namespace rio {
 // The created root task
 extern ITask* sRootTask;
 
+enum HeadlessMode
+{
+    HEADLESS_MODE_NONE,         // Normal window
+    HEADLESS_MODE_OFFSCREEN,    // Hidden window, everything is rendered as usual (Requires a GPU, but no display)
+    HEADLESS_MODE_NULL          // No window and no graphics context: layers are published, but not rendered
+};
+
 struct InitializeArg
 {
+    struct
+    {
+        // Size of the root heap, the default heap of MemUtil::alloc() (0 = allocate from the system, see HeapMgr)
+        size_t root_size = 0;
+        size_t frame_size = 0x100000;   // Size of each of the two buffers of FrameAllocator (0 = no FrameAllocator)
+    } heap;
+    struct
+    {
+        // Number of I/O threads running asynchronous loads, preloads and StreamReader reads (At least 1)
+        u32 load_thread_num = 2;
+    } file_device_mgr;
     struct
     {
         u32 width = 1280;
@@ -24,6 +42,48 @@ struct InitializeArg
     {
         const char* shader_path = "primitive_renderer";
     } primitive_renderer;
+    struct
+    {
+        u32 worker_num = 0xFFFFFFFF;    // Number of worker threads (0xFFFFFFFF = one per hardware thread, minus the main thread)
+        bool parallel_decompression = false;    // Decompress the chunks of compressed files in parallel (See Decompressor)
+    } job_system;
+    struct
+    {
+        u32 loader_thread_num = 1;      // Number of threads running asynchronous ITask::prepare_() (0 = always prepare synchronously)
+    } task_mgr;
+    struct
+    {
+        // Render each frame on a render thread while tasks calculate the next one (Windows only, ignored otherwise).
+        // Tasks' calc_() must then neither use the GPU nor destroy drawables, and draw methods must read the state
+        // written by tasks through lyr::FrameBuffered<T> (See lyr::Renderer::setPipelined()).
+        bool pipelined = false;
+    } main_loop;
+    struct
+    {
+        // Total size of cached resources above which unreferenced ones are evicted
+        // (0 = evict resources as soon as they are no longer referenced, size_t(-1) = no limit)
+        size_t budget = 0;
+    } resource_cache;
+    struct
+    {
+        // Run EnterMainLoop() for a fixed number of frames without showing a window, then report the CPU time of
+        // each frame (For performance regression tracking, e.g., on CI machines without a display or GPU).
+        // With HEADLESS_MODE_NULL, tasks must not use the GPU, and PrimitiveRenderer is not created.
+        // The main loop is never pipelined in headless mode.
+        HeadlessMode mode = HEADLESS_MODE_NONE;
+        u32 frame_num = 600;            // Number of frames to run
+        const char* report_path = nullptr;  // If set, per-frame timings are written to this CSV file (Through FileDeviceMgr)
+    } headless;
+    struct
+    {
+        // Files to load on background threads while the managers are created, in addition to RIO's own
+        // (Shader sources of PrimitiveRenderer and, on Windows, gamecontrollerdb.txt).
+        // Each is taken by the first FileDeviceMgr::tryLoad() of the exact same path (See FileDeviceMgr::preload()).
+        const char* const* preload_paths = nullptr;
+        u32 preload_path_num = 0;
+        bool preload = true;            // Preload files on the I/O threads (See file_device_mgr.load_thread_num)
+        bool print_report = false;      // Print the time taken to create each manager
+    } startup;
 };
 
 extern const InitializeArg cDefaultInitializeArg;
@@ -48,6 +108,7 @@ bool Initialize(const InitializeArg& arg = cDefaultInitializeArg)
 }
 
 // Enters RIO's main loop, which executes all tasks and then renders all layers
+// (If InitializeArg::main_loop.pipelined is set, rendering of a frame overlaps the calculation of the next one)
 void EnterMainLoop();
 
 // Terminate RIO and its global managers
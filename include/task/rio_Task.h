@@ -4,8 +4,13 @@
 #include <misc/rio_BitFlag.h>
 #include <container/rio_TList.h>
 
+#include <atomic>
+#include <vector>
+
 namespace rio {
 
+class TaskPool;
+
 class ITask
 {
 public:
@@ -22,6 +27,12 @@ public:
         STATE_DEAD
     };
 
+    enum Flag
+    {
+        FLAG_PARALLEL_CALC  = 1 << 0,   // calc_() may run on a worker thread, concurrently with other parallel tasks
+        FLAG_ASYNC_PREPARE  = 1 << 1    // prepare_() runs on a TaskMgr loader thread
+    };
+
 protected:
     ITask(const char* name);
 
@@ -51,10 +62,41 @@ public:
 
     State getState() const { return mState; }
 
+    // Declare this task's calc_() as safe to run on a worker thread.
+    // Parallel tasks are calculated after all serial tasks, concurrently with each other,
+    // and are joined before TaskMgr::calc() returns.
+    void setParallelCalc(bool enable) { mFlags.change(FLAG_PARALLEL_CALC, enable); }
+    bool isParallelCalc() const { return mFlags.isOn(FLAG_PARALLEL_CALC); }
+
+    // Run this task's prepare_() on a TaskMgr loader thread (Must be set before the task is prepared, e.g., in the constructor).
+    // The task stays in STATE_PREPARE until prepare_() has finished, then enter_() is called on the main thread.
+    // prepare_() must then not use the GPU, which is left to enter_().
+    void setAsyncPrepare(bool enable) { mFlags.change(FLAG_ASYNC_PREPARE, enable); }
+    bool isAsyncPrepare() const { return mFlags.isOn(FLAG_ASYNC_PREPARE); }
+
+    // Get the tasks this task runs after (See TaskMgr::addDependency())
+    const std::vector<ITask*>& getDependencies() const { return mDependencies; }
+
 protected:
-    ListNode    mTaskListNode;
-    const char* mName;
-    State       mState;
+    ListNode            mTaskListNode;
+    const char*         mName;
+    std::atomic<State>  mState;         // Atomic, as parallel calc_() may request destruction of the same task
+    BitFlag8            mFlags;
+
+    enum AsyncPrepareState
+    {
+        ASYNC_PREPARE_NONE,
+        ASYNC_PREPARE_QUEUED,
+        ASYNC_PREPARE_DONE
+    };
+
+    std::atomic<s32>    mAsyncPrepareState;
+
+    std::vector<ITask*> mDependencies;  // Tasks this task runs after
+    std::vector<ITask*> mDependents;    // Tasks running after this task
+    s32                 mGraphIndex;    // Index in TaskMgr's parallel calc graph (-1 = not in graph)
+
+    TaskPool*           mPool;         // Pool the task was allocated from (Set by TaskMgr::createTask())
 
     friend class TaskMgr;
 };
@@ -2,25 +2,39 @@
 #define RIO_TASK_MGR_H
 
 #include <task/rio_Task.h>
+#include <task/rio_TaskPool.h>
+
+#include <mutex>
+#include <new>
+#include <vector>
 
 namespace rio {
 
+class WorkQueue;
+
 class TaskMgr
 {
 public:
-    static bool createSingleton();
+    // Create task manager singleton instance
+    // Parameters:
+    // - loader_thread_num: Number of loader threads running asynchronous prepare_() (0 = prepare synchronously)
+    static bool createSingleton(u32 loader_thread_num = 1);
     static void destroySingleton();
     static TaskMgr* instance() { return sInstance; }
 
 private:
     static TaskMgr* sInstance;
 
-    TaskMgr() { }
-    ~TaskMgr() { }
+    TaskMgr(u32 loader_thread_num);
+    ~TaskMgr();
 
     TaskMgr(const TaskMgr&);
     TaskMgr& operator=(const TaskMgr&);
 
+public:
+    // Number of parallel tasks calculated per job
+    static constexpr u32 cParallelCalcBatchSize = 16;
+
 public:
     template <typename T>
     T* createTask();
@@ -28,21 +42,89 @@ public:
     bool destroyTask(ITask* task);
     bool requestDestroyTask(ITask* task);
 
+    // Make "task" run after "dependency" every frame.
+    // Parallel tasks are grouped into levels by their dependencies and each level is calculated
+    // concurrently, after the previous one. Serial tasks always run before all parallel tasks,
+    // so parallel tasks may depend on serial tasks, but not the other way around.
+    bool addDependency(ITask* task, ITask* dependency);
+    bool removeDependency(ITask* task, ITask* dependency);
+
+    // Run one frame of all tasks: calcPrepare(), calcActive() and calcDestroy(), in that order.
+    // If RIO_TASK_PROFILE is defined, every task stage is timed by the TaskProfiler singleton (See rio_TaskProfiler.h).
     void calc();
 
+    // The phases of calc(), run separately by the pipelined main loop (See rio::InitializeArg).
+    // The pipelined loop runs calcActive() while the previous frame is rendered on the render thread,
+    // so calc_() must then not use the GPU. calcPrepare() and calcDestroy() run while nothing is rendered.
+    void calcPrepare();     // Complete asynchronous file loads, prepare new tasks and enter the prepared ones
+    void calcActive();      // Calculate running tasks
+    void calcDestroy();     // Exit and destroy tasks whose destruction was requested
+
+    // Tasks are allocated from one pool per task type, pools are kept until the task manager is destroyed
+    u32 getTaskPoolNum() const;
+    bool getTaskPoolStats(u32 index, TaskPool::Stats* stats) const;
+    void printTaskPoolStats() const;
+
 private:
+    template <typename T>
+    static u32 getTaskTypeIndex_();
+
+    TaskPool* getTaskPool_(u32 type_index, size_t size, size_t alignment);
+    void freeTask_(ITask* task);
+
     bool changeTaskState_(ITask* task, ITask::State state);
 
+    void unlinkDependencies_(ITask* task);
+
+    static void prepareAsync_(void* arg);
+
+    void buildGraph_();
+    void calcParallel_();
+    static void calcParallelBatch_(void* arg);
+
 private:
+    struct ParallelCalcBatch
+    {
+        ITask* const*   tasks;
+        u32             num;
+    };
+
     ITask::List  mPrepareList;
     ITask::List  mActiveList;
     ITask::List  mDestroyableList;
+    std::mutex   mListCS;   // Guards list changes made from worker and loader threads (createTask() and requestDestroyTask())
+
+    std::vector<ITask*>             mParallelTasks;     // Running parallel tasks in list order (gathered every frame)
+    std::vector<ITask*>             mGraphTasks;        // mParallelTasks at the time the graph was last built
+    std::vector<ITask*>             mLevelTasks;        // Graph tasks sorted by level
+    std::vector<ParallelCalcBatch>  mParallelBatches;   // Batches of mLevelTasks, sorted by level
+    std::vector<u32>                mLevelBatchOffsets; // Index of each level's first batch (+ batch count at the end)
+    bool                            mGraphDirty;        // Dependencies changed since the graph was last built
+
+    WorkQueue*                      mLoaderQueue;       // Runs asynchronous prepare_()
+
+    std::vector<TaskPool*>          mTaskPools;         // Indexed by task type index (nullptr = not used yet)
+    mutable std::mutex              mPoolCS;            // Guards mTaskPools
+
+    static std::atomic<u32>         sTaskTypeNum;
 };
 
+template <typename T>
+u32 TaskMgr::getTaskTypeIndex_()
+{
+    static const u32 index = sTaskTypeNum.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
 template <typename T>
 T* TaskMgr::createTask()
 {
-    T* task = new T;
+    TaskPool* pool = getTaskPool_(getTaskTypeIndex_<T>(), sizeof(T), alignof(T));
+
+    T* task = new (pool->alloc()) T;
+    task->mPool = pool;
+    pool->setName(task->getName());
+
     changeTaskState_(task, ITask::STATE_PREPARE);
     return task;
 }
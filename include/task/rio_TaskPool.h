@@ -0,0 +1,72 @@
+#ifndef RIO_TASK_POOL_H
+#define RIO_TASK_POOL_H
+
+#include <misc/rio_Types.h>
+
+#include <mutex>
+#include <vector>
+
+namespace rio {
+
+class TaskPool
+{
+    // Typed slab allocator for tasks of a single type.
+    // Storage is allocated in chunks of growing size and never returned before the pool is destroyed,
+    // free slots are kept in an intrusive free list so that allocating and freeing are O(1).
+
+public:
+    struct Stats
+    {
+        const char* name;           // Name of the first task allocated from the pool
+        u32         object_size;    // Size of a slot
+        u32         capacity;       // Number of slots
+        u32         used_num;       // Number of slots in use
+        u32         peak_used_num;  // Highest number of slots in use at once
+        u32         chunk_num;      // Number of allocated chunks
+    };
+
+    // Maximum number of slots per chunk
+    static constexpr u32 cChunkObjectNumMax = 256;
+
+public:
+    TaskPool(size_t object_size, size_t alignment);
+    // All slots must be free
+    ~TaskPool();
+
+private:
+    TaskPool(const TaskPool&);
+    TaskPool& operator=(const TaskPool&);
+
+public:
+    // Allocate and free a slot (Can be called from any thread)
+    void* alloc();
+    void free(void* ptr);
+
+    u32 getUsedNum() const;
+
+    void setName(const char* name);
+    void getStats(Stats* stats) const;
+
+private:
+    void allocChunk_();
+
+private:
+    struct FreeNode
+    {
+        FreeNode*   next;
+    };
+
+    mutable std::mutex  mCS;
+    const u32           mObjectSize;
+    const u32           mAlignment;
+    const char*         mName;
+    FreeNode*           mFreeList;
+    std::vector<void*>  mChunks;
+    u32                 mCapacity;
+    u32                 mUsedNum;
+    u32                 mPeakUsedNum;
+};
+
+}
+
+#endif // RIO_TASK_POOL_H
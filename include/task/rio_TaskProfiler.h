@@ -0,0 +1,197 @@
+#ifndef RIO_TASK_PROFILER_H
+#define RIO_TASK_PROFILER_H
+
+#include <misc/rio_Types.h>
+
+// Task profiling is compiled in only if RIO_TASK_PROFILE is defined,
+// otherwise RIO_TASK_PROFILE_SCOPE() expands to nothing.
+
+#ifdef RIO_TASK_PROFILE
+
+#include <filedevice/rio_FileDevice.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rio {
+
+class TaskProfiler
+{
+    // Records the time spent in each stage of each task.
+    // Every thread records into its own fixed-size event buffer (No allocation per event),
+    // the buffers are drained by endFrame(), which aggregates the events into per-frame statistics
+    // and, if a trace has been started, writes them to a Chrome Trace Event JSON file
+    // (Viewable in chrome://tracing or https://ui.perfetto.dev).
+
+public:
+    enum Stage
+    {
+        STAGE_PREPARE,
+        STAGE_ENTER,
+        STAGE_CALC,
+        STAGE_EXIT,
+        STAGE_FRAME,    // TaskMgr::calcPrepare(), calcActive() and calcDestroy()
+        STAGE_NUM
+    };
+
+    struct Stats
+    {
+        const char* name;
+        Stage       stage;
+        u32         frame_num;      // Number of frames the stage ran in
+        u32         call_num;       // Total number of calls
+        u64         last_ns;        // Time in the last frame it ran in
+        u64         min_ns;         // Per-frame minimum
+        u64         max_ns;         // Per-frame maximum
+        u64         total_ns;       // Sum over all frames (avg = total_ns / frame_num)
+    };
+
+    // Number of events each thread can record per frame (Further events are dropped)
+    static constexpr u32 cThreadEventCapacity = 4096;
+
+public:
+    static bool createSingleton();
+    static void destroySingleton();
+    static TaskProfiler* instance() { return sInstance; }
+
+private:
+    static TaskProfiler* sInstance;
+
+    TaskProfiler();
+    ~TaskProfiler();
+
+    TaskProfiler(const TaskProfiler&);
+    TaskProfiler& operator=(const TaskProfiler&);
+
+public:
+    class Scope
+    {
+    public:
+        Scope(const char* name, Stage stage)
+            : mName(name)
+            , mStage(stage)
+            , mBegin(TaskProfiler::now_())
+        {
+        }
+
+        ~Scope()
+        {
+            TaskProfiler* profiler = TaskProfiler::instance();
+            if (profiler)
+                profiler->record(mName, mStage, mBegin, TaskProfiler::now_());
+        }
+
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+    private:
+        const char* mName;
+        Stage       mStage;
+        u64         mBegin;
+    };
+
+public:
+    // Record an event (Can be called from any thread)
+    void record(const char* name, Stage stage, u64 begin_ns, u64 end_ns);
+
+    // Called by TaskMgr at the end of TaskMgr::calcDestroy()
+    void endFrame();
+
+    u32 getFrameNum() const { return mFrameNum; }
+    u32 getDroppedEventNum() const { return mDroppedEventNum.load(std::memory_order_relaxed); }
+
+    // Get the statistics of every task stage, sorted by descending average time per frame
+    void getStats(std::vector<Stats>* stats) const;
+    void printStats() const;
+    void resetStats();
+
+    // Stream every following event to a Chrome Trace Event JSON file (Path goes through FileDeviceMgr)
+    bool startTrace(const std::string& path);
+    void stopTrace();
+    bool isTracing() const { return mTraceHandle.isOpen(); }
+
+    static const char* getStageName(Stage stage);
+
+private:
+    static u64 now_()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    struct Event
+    {
+        const char* name;
+        u32         stage;
+        u64         begin_ns;
+        u64         end_ns;
+    };
+
+    struct ThreadBuffer
+    {
+        std::mutex  cs;             // Only contended while endFrame() drains the buffer
+        Event       events[cThreadEventCapacity];
+        u32         num;
+        u32         index;          // Thread ID in the trace
+    };
+
+    ThreadBuffer* getThreadBuffer_();
+
+    struct StatsKey
+    {
+        const char* name;
+        u32         stage;
+
+        bool operator==(const StatsKey& rhs) const { return name == rhs.name && stage == rhs.stage; }
+    };
+
+    struct StatsKeyHash
+    {
+        size_t operator()(const StatsKey& key) const { return std::hash<const void*>()(key.name) ^ key.stage; }
+    };
+
+    struct StatsEntry
+    {
+        Stats   stats;
+        u64     frame_ns;           // Time in the current frame
+        u32     frame_call_num;     // Calls in the current frame
+    };
+
+    void writeTrace_(const Event* events, u32 num, u32 thread_index);
+
+private:
+    const u32                       mID;                // Distinguishes profiler instances in the threads' cached buffers
+    const u64                       mStartTime;
+    std::vector<ThreadBuffer*>      mThreadBuffers;
+    mutable std::mutex              mThreadBufferCS;    // Guards mThreadBuffers
+    std::atomic<u32>                mDroppedEventNum;
+    u32                             mFrameNum;
+
+    std::unordered_map<StatsKey, StatsEntry, StatsKeyHash>
+                                    mStats;
+    std::vector<StatsEntry*>        mFrameStats;        // Entries updated in the current frame
+    std::vector<Event>              mDrainBuffer;
+
+    FileHandle                      mTraceHandle;
+    std::vector<char>               mTraceBuffer;
+    bool                            mTraceFirstEvent;
+};
+
+}
+
+#define RIO_TASK_PROFILE_SCOPE(name, stage) \
+    rio::TaskProfiler::Scope _rio_task_profile_scope((name), rio::TaskProfiler::stage)
+
+#else
+
+#define RIO_TASK_PROFILE_SCOPE(name, stage)
+
+#endif // RIO_TASK_PROFILE
+
+#endif // RIO_TASK_PROFILER_H
@@ -0,0 +1,131 @@
+#ifndef RIO_THREAD_JOB_SYSTEM_H
+#define RIO_THREAD_JOB_SYSTEM_H
+
+#include <misc/rio_Types.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rio {
+
+class JobSystem
+{
+    // Work-stealing job system with a fixed pool of worker threads.
+    // Every thread owns a deque of jobs: the owner pushes and pops at the back,
+    // idle threads steal from the front of the other threads' deques.
+    // The thread that created the job system takes part as thread index 0,
+    // so waiting on a counter from it helps executing jobs instead of blocking.
+    // Other threads (e.g., I/O threads) may also push jobs and wait on them:
+    // their jobs are spread over the threads' deques, and they steal while waiting.
+
+public:
+    // Job function pointer type.
+    typedef void (*JobFunc)(void* arg);
+
+    class Counter
+    {
+        // Counter of jobs that have not finished yet, used to join a group of jobs.
+
+    public:
+        Counter()
+            : mValue(0)
+        {
+        }
+
+    private:
+        Counter(const Counter&);
+        Counter& operator=(const Counter&);
+
+    public:
+        // Check if all jobs associated with this counter have finished.
+        bool isDone() const { return mValue.load(std::memory_order_acquire) == 0; }
+
+    private:
+        std::atomic<s32> mValue;
+
+        friend class JobSystem;
+    };
+
+private:
+    struct Job
+    {
+        JobFunc     func;
+        void*       arg;
+        Counter*    counter;
+    };
+
+    class JobDeque
+    {
+    public:
+        JobDeque();
+
+        void push(const Job& job);
+        bool pop(Job* job);
+        bool steal(Job* job);
+
+    private:
+        std::mutex          mCS;
+        std::vector<Job>    mBuffer;    // Ring buffer (Capacity is always a power of 2)
+        u32                 mHead;      // Index of the front job (Steal end)
+        u32                 mNum;       // Number of jobs in the deque
+    };
+
+public:
+    // Create job system singleton instance
+    // Parameters:
+    // - worker_num: Number of worker threads to spawn in addition to the calling thread
+    //               (cWorkerNumAuto = one per hardware thread, minus the calling thread)
+    static bool createSingleton(u32 worker_num = cWorkerNumAuto);
+    // Destroy job system singleton instance
+    static void destroySingleton();
+    // Get job system singleton instance
+    static JobSystem* instance() { return sInstance; }
+
+    static constexpr u32 cWorkerNumAuto = 0xFFFFFFFF;
+
+private:
+    static JobSystem* sInstance;
+
+    JobSystem(u32 worker_num);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&);
+    JobSystem& operator=(const JobSystem&);
+
+public:
+    // Get the number of threads executing jobs (worker threads + the owner thread)
+    u32 getThreadNum() const { return mDeques.size(); }
+
+    // Get the index of the calling thread (0 = owner thread, -1 = not part of the job system)
+    static s32 getCurrentThreadIndex();
+
+    // Push a job to the calling thread's deque (Or, if the calling thread is not part of the job system,
+    // to the threads' deques in turn).
+    // "counter" (optional) is incremented now and decremented once the job has finished.
+    void push(JobFunc func, void* arg, Counter* counter = nullptr);
+
+    // Execute pending jobs until all jobs associated with "counter" have finished.
+    void wait(Counter* counter);
+
+private:
+    bool tryExecuteOne_(s32 thread_index);
+    static void execute_(const Job& job);
+
+    void workerMain_(u32 thread_index);
+
+private:
+    std::vector<JobDeque*>      mDeques;        // Per-thread job deques (Index 0 = owner thread)
+    std::vector<std::thread>    mWorkers;       // Worker threads
+    std::atomic<s32>            mPendingNum;    // Number of jobs pushed but not yet taken
+    std::atomic<u32>            mExternalPushIndex; // Next deque for jobs pushed by other threads
+    std::mutex                  mSleepCS;
+    std::condition_variable     mSleepCond;
+    bool                        mExit;
+};
+
+}
+
+#endif // RIO_THREAD_JOB_SYSTEM_H
@@ -0,0 +1,74 @@
+#ifndef RIO_THREAD_WORK_QUEUE_H
+#define RIO_THREAD_WORK_QUEUE_H
+
+#include <misc/rio_Types.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rio {
+
+class WorkQueue
+{
+    // Priority queue of work items serviced by a fixed set of background threads
+    // (Higher priority items run first, items of the same priority run in FIFO order).
+    // Unlike the JobSystem, work items are expected to block (e.g., file I/O),
+    // so they are kept away from the job system's workers.
+
+public:
+    // Work function pointer type.
+    typedef void (*WorkFunc)(void* arg);
+
+public:
+    // Parameters:
+    // - thread_num: Number of background threads (At least 1)
+    // - name: Name of the queue (For debugging)
+    WorkQueue(u32 thread_num, const char* name);
+    // Work items that have not started yet are discarded, running ones are waited for.
+    ~WorkQueue();
+
+private:
+    WorkQueue(const WorkQueue&);
+    WorkQueue& operator=(const WorkQueue&);
+
+public:
+    const char* getName() const { return mName; }
+    u32 getThreadNum() const { return mThreads.size(); }
+
+    // Queue a work item (Can be called from any thread)
+    void push(WorkFunc func, void* arg, s32 priority = 0);
+
+    // Remove a queued work item that has not started yet (Can be called from any thread)
+    // Returns true if it was removed, false if it is running, has already run, or was never queued.
+    bool cancel(WorkFunc func, void* arg);
+
+    // Block until the queue is empty and no work item is running
+    void waitIdle();
+
+private:
+    struct Item
+    {
+        WorkFunc    func;
+        void*       arg;
+        s32         priority;
+    };
+
+    void threadMain_();
+
+private:
+    const char*                 mName;
+    std::vector<std::thread>    mThreads;
+    std::deque<Item>            mItems;
+    u32                         mRunningNum;
+    std::mutex                  mCS;
+    std::condition_variable     mItemCond;
+    std::condition_variable     mIdleCond;
+    bool                        mExit;
+};
+
+}
+
+#endif // RIO_THREAD_WORK_QUEUE_H
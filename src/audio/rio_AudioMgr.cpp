@@ -1,5 +1,8 @@
 #include <audio/rio_AudioMgr.h>
+#include <filedevice/rio_BufferedFileHandle.h>
 #include <filedevice/rio_FileDeviceMgr.h>
+#include <heap/rio_MemTracker.h>
+#include <misc/rio_ResourceCache.h>
 
 #include <vector>
 
@@ -9,24 +12,40 @@
 
 namespace {
 
-inline rio::FileHandle* GetFileHandleFromSDLRWops(SDL_RWops* rwops)
+// SDL_mixer decoders issue many small reads, which are served from the read-ahead window
+struct SDLRWopsFile
 {
-    return static_cast<rio::FileHandle*>(rwops->hidden.unknown.data1);
+    SDLRWopsFile()
+        : buffered(&handle)
+    {
+    }
+
+    rio::FileHandle         handle;
+    rio::BufferedFileHandle buffered;
+};
+
+inline SDLRWopsFile* GetFileFromSDLRWops(SDL_RWops* rwops)
+{
+    return static_cast<SDLRWopsFile*>(rwops->hidden.unknown.data1);
 }
 
 Sint64 SDLRWopsGetSize(SDL_RWops* context)
 {
-    return GetFileHandleFromSDLRWops(context)->getFileSize();
+    u32 size = 0;
+    if (!GetFileFromSDLRWops(context)->buffered.tryGetFileSize(&size))
+        return -1;
+
+    return size;
 }
 
 Sint64 SDLRWopsSeek(SDL_RWops* context, Sint64 offset, int whence)
 {
-    rio::FileHandle* p_handle = GetFileHandleFromSDLRWops(context);
+    rio::BufferedFileHandle& buffered = GetFileFromSDLRWops(context)->buffered;
 
-    if (!p_handle->trySeek(offset, rio::FileDevice::SeekOrigin(whence)))
+    if (!buffered.trySeek(offset, rio::FileDevice::SeekOrigin(whence)))
         return -1;
 
-    return p_handle->getCurrentSeekPos();
+    return buffered.getCurrentSeekPos();
 }
 
 size_t SDLRWopsRead(SDL_RWops* context, void* ptr, size_t size, size_t maxnum)
@@ -35,18 +54,10 @@ size_t SDLRWopsRead(SDL_RWops* context, void* ptr, size_t size, size_t maxnum)
     if (total_size == 0)
         return 0;
 
-    rio::FileHandle* p_handle = GetFileHandleFromSDLRWops(context);
-
-    if (uintptr_t(ptr) % rio::FileDevice::cBufferMinAlignment == 0)
-        return p_handle->read(static_cast<u8*>(ptr), total_size) / size;
-
-    u8* tmp = static_cast<u8*>(rio::MemUtil::alloc(total_size, rio::FileDevice::cBufferMinAlignment));
-
-    u32 read_size = p_handle->read(static_cast<u8*>(tmp), total_size);
-    if (read_size > 0)
-        rio::MemUtil::copy(ptr, tmp, read_size);
-
-    rio::MemUtil::free(tmp);
+    // Reads into buffers of any alignment
+    u32 read_size = 0;
+    if (!GetFileFromSDLRWops(context)->buffered.tryRead(&read_size, static_cast<u8*>(ptr), total_size))
+        return 0;
 
     return read_size / size;
 }
@@ -58,7 +69,7 @@ size_t SDLRWopsWrite(SDL_RWops* context, const void* ptr, size_t size, size_t nu
 
 int SDLRWopsClose(SDL_RWops* context)
 {
-    if (!GetFileHandleFromSDLRWops(context)->tryClose())
+    if (!GetFileFromSDLRWops(context)->handle.tryClose())
         return -1;
 
     return 0;
@@ -68,17 +79,17 @@ SDL_RWops* CreateSDLRWops(const char* fname)
 {
     const std::string& path = std::string("sounds/") + fname;
 
-    rio::FileHandle* p_handle = new rio::FileHandle;
-    if (!rio::FileDeviceMgr::instance()->tryOpen(p_handle, path, rio::FileDevice::FILE_OPEN_FLAG_READ))
+    SDLRWopsFile* p_file = new SDLRWopsFile;
+    if (!rio::FileDeviceMgr::instance()->tryOpen(&p_file->handle, path, rio::FileDevice::FILE_OPEN_FLAG_READ))
     {
-        delete p_handle;
+        delete p_file;
         return nullptr;
     }
 
     SDL_RWops* rwops = SDL_AllocRW();
     if (!rwops)
     {
-        delete p_handle;
+        delete p_file;
         return nullptr;
     }
 
@@ -87,14 +98,14 @@ SDL_RWops* CreateSDLRWops(const char* fname)
     rwops->read = SDLRWopsRead;
     rwops->write = SDLRWopsWrite;
     rwops->close = SDLRWopsClose;
-    rwops->hidden.unknown.data1 = p_handle;
+    rwops->hidden.unknown.data1 = p_file;
 
     return rwops;
 }
 
 void DestroySDLRWops(SDL_RWops* rwops)
 {
-    delete GetFileHandleFromSDLRWops(rwops);
+    delete GetFileFromSDLRWops(rwops);
     SDL_FreeRW(rwops);
 }
 
@@ -197,28 +208,21 @@ AudioMgr::AudioMgr()
 
 AudioMgr::~AudioMgr()
 {
-    for (const auto& it : mAudioBgmCache)
-    {
-        AudioBgm* src = it.second;
-        Mix_FreeMusic(src->mInnerHandle);
-        DestroySDLRWops(src->mpRWops);
-        delete src;
-    }
+    for (const StringMap<AudioBgm*>::Entry& entry : mAudioBgmCache)
+        destroyBgm_(entry.value);
 
-    for (const auto& it : mAudioSfxCache)
-    {
-        AudioSfx* src = it.second;
-        Mix_FreeChunk(src->mInnerHandle);
-        DestroySDLRWops(src->mpRWops);
-        delete src;
-    }
+    // Sound effects must not outlive SDL_mixer, including those unloaded but still cached
+    for (const StringMap<AudioSfx*>::Entry& entry : mAudioSfxCache)
+        ResourceCache::instance()->release(entry.value, true);
+
+    ResourceCache::instance()->purge(&AudioMgr::destroySfx_);
 
     Mix_CloseAudio();
     Mix_Quit();
     SDL_Quit();
 }
 
-bool AudioMgr::loadBgm(const char* fname, const char* key, AudioBgm::FileFormat format)
+bool AudioMgr::loadBgm(const char* fname, const HashedString& key, AudioBgm::FileFormat format)
 {
     RIO_ASSERT(mIsInitialized);
 
@@ -239,53 +243,107 @@ bool AudioMgr::loadBgm(const char* fname, const char* key, AudioBgm::FileFormat
     AudioBgm* src = new AudioBgm(rwops, handle);
     RIO_ASSERT(src != nullptr);
 
-    mAudioBgmCache.try_emplace(key, src);
+    mAudioBgmCache.tryEmplace(key, src);
     return true;
 }
 
-AudioBgm* AudioMgr::getBgm(const char* key) const
+AudioBgm* AudioMgr::getBgm(const HashedString& key) const
 {
-    auto it = mAudioBgmCache.find(key);
-    if (it != mAudioBgmCache.end())
-        return it->second;
+    AudioBgm* const* src = mAudioBgmCache.find(key);
+    return src ? *src : nullptr;
+}
 
-    return nullptr;
+void AudioMgr::unloadBgm(const HashedString& key)
+{
+    AudioBgm* const* src = mAudioBgmCache.find(key);
+    if (!src)
+        return;
+
+    destroyBgm_(*src);
+    mAudioBgmCache.erase(key);
 }
 
-bool AudioMgr::loadSfx(const char* fname, const char* key)
+void AudioMgr::destroyBgm_(AudioBgm* src)
+{
+    Mix_FreeMusic(src->mInnerHandle);
+    DestroySDLRWops(src->mpRWops);
+    delete src;
+}
+
+bool AudioMgr::loadSfx(const char* fname, const HashedString& key)
 {
     RIO_ASSERT(mIsInitialized);
 
     if (getSfx(key))
         return true;
 
-    SDL_RWops* const rwops = CreateSDLRWops(fname);
-    if (!rwops)
-        return false;
+    const std::string path = std::string("sounds/") + fname;
 
-    Mix_Chunk* handle = Mix_LoadWAV_RW(rwops, true);
-    if (!handle)
+    // Check if the sound is still cached
+    AudioSfx* src = ResourceCache::instance()->acquire<AudioSfx>(path);
+    if (!src)
     {
-        DestroySDLRWops(rwops);
-        return false;
+        SDL_RWops* const rwops = CreateSDLRWops(fname);
+        if (!rwops)
+            return false;
+
+        Mix_Chunk* handle = Mix_LoadWAV_RW(rwops, true);
+        if (!handle)
+        {
+            DestroySDLRWops(rwops);
+            return false;
+        }
+
+        src = new AudioSfx(rwops, handle);
+        RIO_ASSERT(src != nullptr);
+
+#if RIO_MEM_TRACKING
+        // The samples are allocated by SDL2 Mixer
+        MemTracker::instance()->recordExternalAlloc("Audio", handle->alen);
+#endif // RIO_MEM_TRACKING
+
+        src = static_cast<AudioSfx*>(ResourceCache::instance()->add(path, src, handle->alen, &AudioMgr::destroySfx_));
     }
 
-    AudioSfx* src = new AudioSfx(rwops, handle);
-    RIO_ASSERT(src != nullptr);
-
-    const auto& it = mAudioSfxCache.try_emplace(key, src);
-    RIO_ASSERT(it.second);
-    it.first->second->setVolume(1.0f);
+    [[maybe_unused]] const std::pair<AudioSfx**, bool> inserted = mAudioSfxCache.tryEmplace(key, src);
+    RIO_ASSERT(inserted.second);
+    src->setVolume(1.0f);
     return true;
 }
 
-AudioSfx* AudioMgr::getSfx(const char* key) const
+void AudioMgr::unloadSfx(const HashedString& key)
 {
-    auto it = mAudioSfxCache.find(key);
-    if (it != mAudioSfxCache.end())
-        return it->second;
+    AudioSfx* const* src = mAudioSfxCache.find(key);
+    if (!src)
+        return;
 
-    return nullptr;
+    ResourceCache::instance()->release(*src);
+    mAudioSfxCache.erase(key);
+}
+
+void AudioMgr::destroySfx_(void* p_src)
+{
+    AudioSfx* src = static_cast<AudioSfx*>(p_src);
+
+#if RIO_MEM_TRACKING
+    MemTracker::instance()->recordExternalFree("Audio", src->mInnerHandle->alen);
+#endif // RIO_MEM_TRACKING
+
+    // Freeing the chunk halts the channels playing it
+    Mix_FreeChunk(src->mInnerHandle);
+    DestroySDLRWops(src->mpRWops);
+
+    for (AudioSfx*& current : AudioSfx::sCurrent)
+        if (current == src)
+            current = nullptr;
+
+    delete src;
+}
+
+AudioSfx* AudioMgr::getSfx(const HashedString& key) const
+{
+    AudioSfx* const* src = mAudioSfxCache.find(key);
+    return src ? *src : nullptr;
 }
 
 void AudioMgr::setListenerPosition(const Vector3f& pos)
@@ -346,8 +404,8 @@ void AudioMgr::setMasterVolume(f32 volume)
     f32* sfx_volume = new f32[mAudioSfxCache.size()];
     {
         s32 i = 0;
-        for (const auto& it : mAudioSfxCache)
-            sfx_volume[i++] = it.second->getVolume();
+        for (const StringMap<AudioSfx*>::Entry& entry : mAudioSfxCache)
+            sfx_volume[i++] = entry.value->getVolume();
     }
 
     sMasterVolume = volume;
@@ -355,8 +413,8 @@ void AudioMgr::setMasterVolume(f32 volume)
     AudioBgm::setCurrentVolume(music_volume);
     {
         s32 i = 0;
-        for (const auto& it : mAudioSfxCache)
-            it.second->setVolume(sfx_volume[i++]);
+        for (const StringMap<AudioSfx*>::Entry& entry : mAudioSfxCache)
+            entry.value->setVolume(sfx_volume[i++]);
     }
 
     delete[] sfx_volume;
@@ -386,16 +444,16 @@ void AudioMgr::setSfxVolume(f32 volume)
     f32* sfx_volume = new f32[mAudioSfxCache.size()];
     {
         s32 i = 0;
-        for (const auto& it : mAudioSfxCache)
-            sfx_volume[i++] = it.second->getVolume();
+        for (const StringMap<AudioSfx*>::Entry& entry : mAudioSfxCache)
+            sfx_volume[i++] = entry.value->getVolume();
     }
 
     sSfxVolume = volume;
 
     {
         s32 i = 0;
-        for (const auto& it : mAudioSfxCache)
-            it.second->setVolume(sfx_volume[i++]);
+        for (const StringMap<AudioSfx*>::Entry& entry : mAudioSfxCache)
+            entry.value->setVolume(sfx_volume[i++]);
     }
 
     delete[] sfx_volume;
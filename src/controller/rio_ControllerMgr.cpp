@@ -83,9 +83,16 @@ void ControllerMgr::initializeDefault_()
         FileDevice::LoadArg arg;
         arg.path = "gamecontrollerdb.txt";
 
-        char* file = (char*)FileDeviceMgr::instance()->load(arg);
-        glfwUpdateGamepadMappings(file);
-        MemUtil::free(file); file = nullptr;
+        u8* file = FileDeviceMgr::instance()->load(arg);
+
+        // The loaded data is not null-terminated
+        const std::string mappings((const char*)file, arg.read_size);
+        glfwUpdateGamepadMappings(mappings.c_str());
+
+        if (arg.need_unload)
+            FileDeviceMgr::unload(file);
+
+        file = nullptr;
     }
 
     for (u32 i = 0; i <= GLFW_JOYSTICK_LAST; i++)
@@ -25,8 +25,12 @@ void KeyboardMouseDevice::calc()
 {
     mIsLastReadSuccess = GetKeyboardState(mKeyState);
 
+    GLFWwindow* const glfw_window = Window::getWindowInner();
+    if (glfw_window == nullptr)
+        return;
+
     f64 pos_x, pos_y;
-    glfwGetCursorPos(Window::getWindowInner(), &pos_x, &pos_y);
+    glfwGetCursorPos(glfw_window, &pos_x, &pos_y);
     mCursorPos.set(pos_x, pos_y);
 }
 
@@ -23,7 +23,7 @@ NativeFileDevice::NativeFileDevice(const std::string& drive_name)
 
 FileDevice*
 NativeFileDevice::doOpen_(
-    FileHandle* handle, const std::string& filename,
+    FileHandle* handle, std::string_view filename,
     FileDevice::FileOpenFlag flag
 )
 {
@@ -52,11 +52,16 @@ NativeFileDevice::doOpen_(
         RIO_ASSERT(false);
     }
 
-    std::string file_path = getNativePath(filename);
+    char file_path[cNativePathMax];
+    if (!getNativePath(file_path, sizeof(file_path), filename))
+    {
+        mLastRawError = RAW_ERROR_ACCESS_ERROR;
+        return nullptr;
+    }
 
-    FSStatus status = FSOpenFile(client, &block, file_path.c_str(), mode, &handle_inner->handle, FSErrorFlag(FS_ERROR_FLAG_PERMISSION_ERROR | FS_ERROR_FLAG_ACCESS_ERROR |
-                                                                                                             FS_ERROR_FLAG_NOT_FILE | FS_ERROR_FLAG_NOT_FOUND |
-                                                                                                             FS_ERROR_FLAG_ALREADY_OPEN));
+    FSStatus status = FSOpenFile(client, &block, file_path, mode, &handle_inner->handle, FSErrorFlag(FS_ERROR_FLAG_PERMISSION_ERROR | FS_ERROR_FLAG_ACCESS_ERROR |
+                                                                                                     FS_ERROR_FLAG_NOT_FILE | FS_ERROR_FLAG_NOT_FOUND |
+                                                                                                     FS_ERROR_FLAG_ALREADY_OPEN));
     handle_inner->position = 0;
 
     if (mLastRawError = RawErrorCode(status), status != FS_STATUS_OK)
@@ -199,7 +204,7 @@ NativeFileDevice::doGetCurrentSeekPos_(
 
 bool
 NativeFileDevice::doGetFileSize_(
-    u32* size, const std::string& path
+    u32* size, std::string_view path
 )
 {
     FSCmdBlock block;
@@ -207,10 +212,15 @@ NativeFileDevice::doGetFileSize_(
 
     FSClient* client = FileDeviceMgr::instance()->getFSClient();
 
-    std::string file_path = getNativePath(path);
+    char file_path[cNativePathMax];
+    if (!getNativePath(file_path, sizeof(file_path), path))
+    {
+        mLastRawError = RAW_ERROR_ACCESS_ERROR;
+        return false;
+    }
 
     FSStat stat;
-    FSStatus status = FSGetStat(client, &block, file_path.c_str(), &stat, FS_ERROR_FLAG_NONE);
+    FSStatus status = FSGetStat(client, &block, file_path, &stat, FS_ERROR_FLAG_NONE);
 
     if (mLastRawError = RawErrorCode(status), status != FS_STATUS_OK)
         return false;
@@ -242,7 +252,7 @@ NativeFileDevice::doGetFileSize_(
 
 bool
 NativeFileDevice::doIsExistFile_(
-    bool* is_exist, const std::string& path
+    bool* is_exist, std::string_view path
 )
 {
     FSCmdBlock block;
@@ -250,10 +260,15 @@ NativeFileDevice::doIsExistFile_(
 
     FSClient* client = FileDeviceMgr::instance()->getFSClient();
 
-    std::string file_path = getNativePath(path);
+    char file_path[cNativePathMax];
+    if (!getNativePath(file_path, sizeof(file_path), path))
+    {
+        mLastRawError = RAW_ERROR_ACCESS_ERROR;
+        return false;
+    }
 
     FSStat stat;
-    FSStatus status = FSGetStat(client, &block, file_path.c_str(), &stat, FSErrorFlag(FS_ERROR_FLAG_PERMISSION_ERROR | FS_ERROR_FLAG_NOT_FOUND));
+    FSStatus status = FSGetStat(client, &block, file_path, &stat, FSErrorFlag(FS_ERROR_FLAG_PERMISSION_ERROR | FS_ERROR_FLAG_NOT_FOUND));
 
     if (mLastRawError = RawErrorCode(status), status != FS_STATUS_OK)
     {
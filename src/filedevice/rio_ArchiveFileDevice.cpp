@@ -0,0 +1,353 @@
+#include <filedevice/rio_ArchiveFileDevice.h>
+#include <filedevice/rio_Decompressor.h>
+#include <filedevice/rio_FileDeviceMgr.h>
+#include <misc/rio_Hash.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+struct Header
+{
+    char    magic[8];
+    u16     bom;
+    u16     _pad;
+    u32     version;
+    u32     file_size;
+    u32     file_num;
+    u32     entries_offset;
+    u32     paths_offset;
+};
+static_assert(sizeof(Header) == 0x20);
+
+// Does the entry's data lie within the archive, and is its path terminated within it
+static bool isValidEntry(const rio::ArchiveFileDevice::Entry& entry, const u8* data, u32 size, u32 paths_offset)
+{
+    if (u64(entry.data_offset) + entry.data_size > size)
+        return false;
+
+    const u64 path_offset = u64(paths_offset) + entry.path_offset;
+    if (path_offset >= size)
+        return false;
+
+    return std::memchr(data + path_offset, '\0', size - path_offset) != nullptr;
+}
+
+}
+
+namespace rio {
+
+ArchiveFileDevice::ArchiveFileDevice(const std::string& drive_name)
+    : FileDevice(drive_name)
+    , mData(nullptr)
+    , mDataSize(0)
+    , mNeedUnload(false)
+    , mEntries(nullptr)
+    , mPaths(nullptr)
+    , mFileNum(0)
+    , mLastRawError(RAW_ERROR_OK)
+{
+}
+
+ArchiveFileDevice::~ArchiveFileDevice()
+{
+    close();
+}
+
+bool ArchiveFileDevice::open(const std::string& path)
+{
+    close();
+
+    FileDevice::LoadArg arg;
+    arg.path = path;
+    arg.alignment = FileDevice::cBufferMinAlignment;
+
+    u8* data = FileDeviceMgr::instance()->tryLoad(arg);
+    if (!data)
+    {
+        RIO_LOG("ArchiveFileDevice::open(): Could not load \"%s\".\n", path.c_str());
+        return false;
+    }
+
+    const Header* header = reinterpret_cast<const Header*>(data);
+
+    if (arg.read_size < sizeof(Header) ||
+        std::memcmp(header->magic, "rioarchv", 8) != 0 ||
+        header->bom != 0xFEFF ||
+        header->version != cVersion ||
+        header->file_size != arg.read_size ||
+        header->entries_offset % alignof(Entry) != 0 ||
+        header->entries_offset + u64(header->file_num) * sizeof(Entry) > arg.read_size ||
+        header->paths_offset > arg.read_size)
+    {
+        RIO_LOG("ArchiveFileDevice::open(): \"%s\" is not a valid archive (Or has the wrong endianness).\n", path.c_str());
+        RIO_ASSERT(false);
+
+        if (arg.need_unload)
+            FileDeviceMgr::unload(data);
+
+        return false;
+    }
+
+    // Entries are trusted from then on
+    const Entry* entries = reinterpret_cast<const Entry*>(data + header->entries_offset);
+    for (u32 i = 0; i < header->file_num; i++)
+    {
+        if (!isValidEntry(entries[i], data, arg.read_size, header->paths_offset))
+        {
+            RIO_LOG("ArchiveFileDevice::open(): Entry %u of \"%s\" is out of bounds.\n", i, path.c_str());
+            RIO_ASSERT(false);
+
+            if (arg.need_unload)
+                FileDeviceMgr::unload(data);
+
+            return false;
+        }
+    }
+
+    mData = data;
+    mDataSize = arg.read_size;
+    mNeedUnload = arg.need_unload;
+    mEntries = entries;
+    mPaths = reinterpret_cast<const char*>(data + header->paths_offset);
+    mFileNum = header->file_num;
+
+    return true;
+}
+
+void ArchiveFileDevice::close()
+{
+    if (!mData)
+        return;
+
+    if (mNeedUnload)
+        FileDeviceMgr::unload(mData);
+
+    mData = nullptr;
+    mDataSize = 0;
+    mNeedUnload = false;
+    mEntries = nullptr;
+    mPaths = nullptr;
+    mFileNum = 0;
+}
+
+const ArchiveFileDevice::Entry* ArchiveFileDevice::findEntry_(std::string_view path) const
+{
+    if (!mData)
+        return nullptr;
+
+    const u32 hash = Hash::calcFNV1a(path.data(), path.length());
+
+    const Entry* const end = mEntries + mFileNum;
+    const Entry* it = std::lower_bound(mEntries, end, hash, [](const Entry& entry, u32 hash) { return entry.hash < hash; });
+
+    // Paths of equal hash are compared
+    for (; it != end && it->hash == hash; ++it)
+        if (path.compare(mPaths + it->path_offset) == 0)
+            return it;
+
+    return nullptr;
+}
+
+const u8* ArchiveFileDevice::getFileData(std::string_view path, u32* size) const
+{
+    const Entry* entry = findEntry_(path);
+    if (!entry)
+        return nullptr;
+
+    if (size)
+        *size = entry->data_size;
+
+    return mData + entry->data_offset;
+}
+
+u8* ArchiveFileDevice::doLoad_(LoadArg& arg)
+{
+    const Entry* entry = findEntry_(arg.path);
+    if (!entry)
+    {
+        mLastRawError = RAW_ERROR_NOT_FOUND;
+        return nullptr;
+    }
+
+    u8* const data = mData + entry->data_offset;
+    const u32 size = entry->data_size;
+
+    mLastRawError = RAW_ERROR_OK;
+
+    if (Decompressor::isCompressed(data, size))
+        return Decompressor::load(arg, data, size);
+
+    u8* buffer = arg.buffer;
+    bool need_unload = false;
+
+    if (buffer)
+    {
+        if (arg.buffer_size < size)
+        {
+            RIO_LOG("ArchiveFileDevice::doLoad_(): arg.buffer_size[%u] is smaller than file size[%u].\n", arg.buffer_size, size);
+            return nullptr;
+        }
+    }
+    else if (arg.alignment > 1 && uintptr_t(data) % arg.alignment != 0)
+    {
+        // Packed with a smaller alignment than requested
+        buffer = (u8*)MemUtil::alloc(size, std::max(arg.alignment, u32(FileDevice::cBufferMinAlignment)));
+        if (!buffer)
+            return nullptr;
+
+        need_unload = true;
+    }
+    else
+    {
+        // No copy
+        arg.read_size = size;
+        arg.roundup_size = size;
+        arg.need_unload = false;
+        return data;
+    }
+
+    std::memcpy(buffer, data, size);
+
+    arg.read_size = size;
+    arg.roundup_size = arg.buffer ? arg.buffer_size : size;
+    arg.need_unload = need_unload;
+    return buffer;
+}
+
+FileDevice* ArchiveFileDevice::doOpen_(FileHandle* handle, std::string_view filename, FileOpenFlag flag)
+{
+    if (flag != FILE_OPEN_FLAG_READ)
+    {
+        mLastRawError = RAW_ERROR_PERMISSION_ERROR;
+        return nullptr;
+    }
+
+    const Entry* entry = findEntry_(filename);
+    if (!entry)
+    {
+        mLastRawError = RAW_ERROR_NOT_FOUND;
+        return nullptr;
+    }
+
+    FileHandleInner* handle_inner = getFileHandleInner_(handle);
+    handle_inner->handle = uintptr_t(entry);
+    handle_inner->position = 0;
+
+    mLastRawError = RAW_ERROR_OK;
+    return this;
+}
+
+bool ArchiveFileDevice::doClose_(FileHandle* handle)
+{
+    FileHandleInner* handle_inner = getFileHandleInner_(handle);
+    handle_inner->handle = 0;
+
+    mLastRawError = RAW_ERROR_OK;
+    return true;
+}
+
+bool ArchiveFileDevice::doRead_(u32* read_size, FileHandle* handle, u8* buf, u32 size)
+{
+    FileHandleInner* handle_inner = getFileHandleInner_(handle);
+    const Entry* entry = reinterpret_cast<const Entry*>(handle_inner->handle);
+
+    const u32 position = std::min(handle_inner->position, entry->data_size);
+    const u32 result = std::min(size, entry->data_size - position);
+
+    std::memcpy(buf, mData + entry->data_offset + position, result);
+    handle_inner->position = position + result;
+
+    if (read_size)
+        *read_size = result;
+
+    mLastRawError = RAW_ERROR_OK;
+    return true;
+}
+
+bool ArchiveFileDevice::doWrite_(u32*, FileHandle*, const u8*, u32)
+{
+    mLastRawError = RAW_ERROR_PERMISSION_ERROR;
+    return false;
+}
+
+bool ArchiveFileDevice::doSeek_(FileHandle* handle, s32 offset, SeekOrigin origin)
+{
+    FileHandleInner* handle_inner = getFileHandleInner_(handle);
+    const Entry* entry = reinterpret_cast<const Entry*>(handle_inner->handle);
+
+    s64 position;
+
+    switch (origin)
+    {
+    case SEEK_ORIGIN_BEGIN:
+        position = offset;
+        break;
+    case SEEK_ORIGIN_CURRENT:
+        position = s64(handle_inner->position) + offset;
+        break;
+    case SEEK_ORIGIN_END:
+        position = s64(entry->data_size) + offset;
+        break;
+    default:
+        return false;
+    }
+
+    if (position < 0 || position > entry->data_size)
+    {
+        mLastRawError = RAW_ERROR_ACCESS_ERROR;
+        return false;
+    }
+
+    handle_inner->position = u32(position);
+
+    mLastRawError = RAW_ERROR_OK;
+    return true;
+}
+
+bool ArchiveFileDevice::doGetCurrentSeekPos_(u32* pos, FileHandle* handle)
+{
+    *pos = getFileHandleInner_(handle)->position;
+
+    mLastRawError = RAW_ERROR_OK;
+    return true;
+}
+
+bool ArchiveFileDevice::doGetFileSize_(u32* size, std::string_view path)
+{
+    const Entry* entry = findEntry_(path);
+    if (!entry)
+    {
+        mLastRawError = RAW_ERROR_NOT_FOUND;
+        return false;
+    }
+
+    *size = entry->data_size;
+
+    mLastRawError = RAW_ERROR_OK;
+    return true;
+}
+
+bool ArchiveFileDevice::doGetFileSize_(u32* size, FileHandle* handle)
+{
+    *size = reinterpret_cast<const Entry*>(getFileHandleInner_(handle)->handle)->data_size;
+
+    mLastRawError = RAW_ERROR_OK;
+    return true;
+}
+
+bool ArchiveFileDevice::doIsExistFile_(bool* is_exist, std::string_view path)
+{
+    *is_exist = findEntry_(path) != nullptr;
+
+    mLastRawError = RAW_ERROR_OK;
+    return true;
+}
+
+RawErrorCode ArchiveFileDevice::doGetLastRawError_() const
+{
+    return mLastRawError;
+}
+
+}
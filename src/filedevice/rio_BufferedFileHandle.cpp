@@ -0,0 +1,289 @@
+#include <filedevice/rio_BufferedFileHandle.h>
+#include <misc/rio_MemUtil.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+static inline u32 align(u32 x, u32 y)
+{
+    RIO_ASSERT(((y - 1) & y) == 0);
+    return (x + y - 1) & -y;
+}
+
+static inline bool isAligned(const void* ptr)
+{
+    return uintptr_t(ptr) % rio::FileDevice::cBufferMinAlignment == 0;
+}
+
+}
+
+namespace rio {
+
+BufferedFileHandle::BufferedFileHandle(FileHandle* handle, u32 window_size, u32 window_size_max)
+    : mHandle(handle)
+    , mBuffer(nullptr)
+    , mCapacity(0)
+    , mBegin(0)
+    , mSize(0)
+    , mOffset(0)
+    , mWindowPos(0)
+    , mHandlePos(cPosUnknown)
+    , mWindowSize(align(std::max(window_size, 1u), FileDevice::cBufferMinAlignment))
+    , mWindowSizeMin(mWindowSize)
+    , mWindowSizeMax(std::max(mWindowSize, align(window_size_max, FileDevice::cBufferMinAlignment)))
+    , mFileSize(cPosUnknown)
+    , mSequential(false)
+{
+    RIO_ASSERT(handle);
+}
+
+BufferedFileHandle::~BufferedFileHandle()
+{
+    if (mBuffer)
+        MemUtil::free(mBuffer);
+}
+
+bool BufferedFileHandle::tryRead(u32* read_size, u8* buf, u32 size)
+{
+    u32 total = 0;
+
+    while (total < size)
+    {
+        const u32 available = mSize - mOffset;
+        if (available > 0)
+        {
+            const u32 copy_size = std::min(available, size - total);
+            std::memcpy(buf + total, mBuffer + mBegin + mOffset, copy_size);
+            mOffset += copy_size;
+            total += copy_size;
+            continue;
+        }
+
+        // Reads larger than the window go straight to the caller's buffer, if the device can read into it
+        if (size - total >= mWindowSize && isAligned(buf + total))
+        {
+            mWindowPos += mSize;
+            mSize = 0;
+            mOffset = 0;
+
+            if (!seekHandle_(mWindowPos))
+                return false;
+
+            u32 direct_size = 0;
+            if (!mHandle->tryRead(&direct_size, buf + total, size - total))
+            {
+                mHandlePos = cPosUnknown;
+                return false;
+            }
+
+            mWindowPos += direct_size;
+            mHandlePos += direct_size;
+            total += direct_size;
+
+            // End of the file
+            if (direct_size == 0)
+                break;
+
+            continue;
+        }
+
+        if (!fill_())
+            return false;
+
+        // End of the file
+        if (mSize == mOffset)
+            break;
+    }
+
+    if (read_size)
+        *read_size = total;
+
+    return true;
+}
+
+const u8* BufferedFileHandle::peek(u32 size, u32* available)
+{
+    if (size > mWindowSizeMax)
+    {
+        RIO_LOG("BufferedFileHandle::peek(): size[%u] is larger than the maximum window size[%u].\n", size, mWindowSizeMax);
+        RIO_ASSERT(false);
+        return nullptr;
+    }
+
+    while (mSize - mOffset < size)
+    {
+        // The window must hold the data kept, followed by the rest
+        mWindowSize = std::max(mWindowSize, align(size, FileDevice::cBufferMinAlignment));
+
+        const u32 prev_size = mSize - mOffset;
+        if (!fill_())
+            return nullptr;
+
+        // End of the file
+        if (mSize - mOffset == prev_size)
+            break;
+    }
+
+    if (available)
+        *available = std::min(size, mSize - mOffset);
+
+    return mBuffer + mBegin + mOffset;
+}
+
+bool BufferedFileHandle::trySkip(u32 size)
+{
+    const u32 pos = getCurrentSeekPos();
+    if (size > cPosUnknown - pos)
+        return false;
+
+    seekTo_(pos + size);
+    return true;
+}
+
+bool BufferedFileHandle::trySeek(s32 offset, FileDevice::SeekOrigin origin)
+{
+    s64 pos;
+
+    switch (origin)
+    {
+    case FileDevice::SEEK_ORIGIN_BEGIN:
+        pos = offset;
+        break;
+    case FileDevice::SEEK_ORIGIN_CURRENT:
+        pos = s64(getCurrentSeekPos()) + offset;
+        break;
+    case FileDevice::SEEK_ORIGIN_END:
+        {
+            u32 file_size = 0;
+            if (!tryGetFileSize(&file_size))
+                return false;
+
+            pos = s64(file_size) + offset;
+        }
+        break;
+    default:
+        return false;
+    }
+
+    if (pos < 0 || pos >= cPosUnknown)
+        return false;
+
+    seekTo_(u32(pos));
+    return true;
+}
+
+bool BufferedFileHandle::tryGetFileSize(u32* size)
+{
+    if (mFileSize == cPosUnknown && !mHandle->tryGetFileSize(&mFileSize))
+    {
+        mFileSize = cPosUnknown;
+        return false;
+    }
+
+    *size = mFileSize;
+    return true;
+}
+
+void BufferedFileHandle::invalidate()
+{
+    u32 pos = 0;
+    if (mHandle->isOpen() && !mHandle->tryGetCurrentSeekPos(&pos))
+        pos = 0;
+
+    mWindowPos = pos;
+    mSize = 0;
+    mOffset = 0;
+    mHandlePos = cPosUnknown;
+    mWindowSize = mWindowSizeMin;
+    mFileSize = cPosUnknown;
+    mSequential = false;
+}
+
+bool BufferedFileHandle::fill_()
+{
+    // Grow the window while the file is read sequentially
+    if (mSequential)
+        mWindowSize = std::min(mWindowSize * 2, mWindowSizeMax);
+
+    mSequential = true;
+
+    // Data not consumed yet is kept right before the data read, which is aligned
+    const u32 keep = mSize - mOffset;
+    const u32 read_begin = align(keep, FileDevice::cBufferMinAlignment);
+    const u8* const keep_data = mBuffer + mBegin + mOffset;
+
+    if (read_begin + mWindowSize > mCapacity)
+    {
+        const u32 capacity = std::max(read_begin + mWindowSize, mWindowSize * 2);
+        u8* buffer = static_cast<u8*>(MemUtil::alloc(capacity, FileDevice::cBufferMinAlignment));
+        if (!buffer)
+            return false;
+
+        if (keep > 0)
+            std::memcpy(buffer + read_begin - keep, keep_data, keep);
+
+        if (mBuffer)
+            MemUtil::free(mBuffer);
+
+        mBuffer = buffer;
+        mCapacity = capacity;
+    }
+    else if (keep > 0)
+    {
+        std::memmove(mBuffer + read_begin - keep, keep_data, keep);
+    }
+
+    mWindowPos += mOffset;
+    mBegin = read_begin - keep;
+    mSize = keep;
+    mOffset = 0;
+
+    if (!seekHandle_(mWindowPos + mSize))
+        return false;
+
+    u32 read_size = 0;
+    if (!mHandle->tryRead(&read_size, mBuffer + read_begin, mWindowSize))
+    {
+        mHandlePos = cPosUnknown;
+        return false;
+    }
+
+    mSize += read_size;
+    mHandlePos += read_size;
+    return true;
+}
+
+void BufferedFileHandle::seekTo_(u32 pos)
+{
+    if (mWindowPos <= pos && pos - mWindowPos <= mSize)
+    {
+        mOffset = pos - mWindowPos;
+        return;
+    }
+
+    // Not sequential anymore, the handle is only moved on the next read
+    mWindowPos = pos;
+    mSize = 0;
+    mOffset = 0;
+    mWindowSize = mWindowSizeMin;
+    mSequential = false;
+}
+
+bool BufferedFileHandle::seekHandle_(u32 pos)
+{
+    if (mHandlePos == pos)
+        return true;
+
+    if (!mHandle->trySeek(s32(pos), FileDevice::SEEK_ORIGIN_BEGIN))
+    {
+        mHandlePos = cPosUnknown;
+        return false;
+    }
+
+    mHandlePos = pos;
+    return true;
+}
+
+}
@@ -0,0 +1,426 @@
+#include <filedevice/rio_Decompressor.h>
+#include <misc/rio_MemUtil.h>
+#include <thread/rio_JobSystem.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+static inline u32 align(u32 x, u32 y)
+{
+    RIO_ASSERT(((y - 1) & y) == 0);
+    return (x + y - 1) & -y;
+}
+
+}
+
+namespace rio {
+
+std::atomic<bool> Decompressor::sParallel(false);
+
+class Decompressor::Context
+{
+    // Decompression of the chunks of one file, each chunk being decompressed (Or pushed to the job system)
+    // as soon as its data is available.
+
+public:
+    Context(const Header& header, u8* dst, JobSystem* job_system)
+        : mHeader(header)
+        , mDst(dst)
+        , mJobSystem(job_system)
+        , mFailed(false)
+    {
+    }
+
+    ~Context()
+    {
+        RIO_ASSERT(!mJobSystem || mCounter.isDone());
+    }
+
+private:
+    Context(const Context&);
+    Context& operator=(const Context&);
+
+public:
+    // Validate the chunk size table, "data_size" being the size available for the chunks
+    bool setChunkSizes(const u8* table, u32 data_size)
+    {
+        const u32 chunk_num = mHeader.chunk_num;
+
+        mSizes.resize(chunk_num);
+        mOffsets.resize(chunk_num + 1);
+        std::memcpy(mSizes.data(), table, chunk_num * sizeof(u32));
+
+        u64 offset = 0;
+        for (u32 i = 0; i < chunk_num; i++)
+        {
+            const u32 size = mSizes[i] & ~cChunkStored;
+            const u32 dst_size = getDstSize_(i);
+
+            // Chunks which do not compress are stored
+            if (size > dst_size || ((mSizes[i] & cChunkStored) && size != dst_size))
+                return false;
+
+            mOffsets[i] = offset;
+            offset += size;
+        }
+
+        if (offset > data_size)
+            return false;
+
+        mOffsets[chunk_num] = offset;
+
+        if (mJobSystem)
+            mJobs.resize(chunk_num);
+
+        return true;
+    }
+
+    u32 getChunkOffset(u32 index) const { return mOffsets[index]; }
+    u32 getChunkEnd(u32 index) const { return mOffsets[index + 1]; }
+
+    // Decompress a chunk, "src" being its data (Which must stay valid until finish())
+    void decompress(u32 index, const u8* src)
+    {
+        if (mJobSystem)
+        {
+            Job& job = mJobs[index];
+            job.context = this;
+            job.index = index;
+            job.src = src;
+
+            mJobSystem->push(&Context::jobMain_, &job, &mCounter);
+        }
+        else if (!decompressChunk_(index, src))
+        {
+            mFailed.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    // Wait for every chunk to be decompressed
+    bool finish()
+    {
+        if (mJobSystem)
+            mJobSystem->wait(&mCounter);
+
+        return !mFailed.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Job
+    {
+        Context*    context;
+        u32         index;
+        const u8*   src;
+    };
+
+    static void jobMain_(void* arg)
+    {
+        const Job& job = *static_cast<const Job*>(arg);
+        if (!job.context->decompressChunk_(job.index, job.src))
+            job.context->mFailed.store(true, std::memory_order_relaxed);
+    }
+
+    u32 getDstSize_(u32 index) const
+    {
+        return std::min(mHeader.chunk_size, mHeader.decompressed_size - index * mHeader.chunk_size);
+    }
+
+    bool decompressChunk_(u32 index, const u8* src) const
+    {
+        u8* const dst = mDst + index * mHeader.chunk_size;
+        const u32 dst_size = getDstSize_(index);
+
+        if (mSizes[index] & cChunkStored)
+        {
+            std::memcpy(dst, src, dst_size);
+            return true;
+        }
+
+        return decompressLZ4(dst, dst_size, src, mSizes[index]);
+    }
+
+private:
+    const Header&       mHeader;
+    u8*                 mDst;
+    std::vector<u32>    mSizes;
+    std::vector<u32>    mOffsets;       // Offset of each chunk from the first, followed by the end of the last
+    JobSystem*          mJobSystem;     // Null if decompressing sequentially
+    JobSystem::Counter  mCounter;
+    std::vector<Job>    mJobs;
+    std::atomic<bool>   mFailed;
+};
+
+JobSystem* Decompressor::getJobSystem_(const Header& header)
+{
+    // Single chunks are not worth a job
+    if (!isParallel() || header.chunk_num < 2)
+        return nullptr;
+
+    return JobSystem::instance();
+}
+
+bool Decompressor::isCompressed(const u8* data, u32 size)
+{
+    if (size < sizeof(Header))
+        return false;
+
+    // "data" may not be aligned (e.g., a file in an archive)
+    u16 bom;
+    std::memcpy(&bom, data + offsetof(Header, bom), sizeof(u16));
+
+    // Files compressed for the other endianness are detected as well, for load() to reject them
+    return std::memcmp(data + offsetof(Header, magic), "riocmprs", 8) == 0 && (bom == 0xFEFF || bom == 0xFFFE);
+}
+
+bool Decompressor::isValidHeader_(const Header& header, u32 file_size)
+{
+    return header.bom == 0xFEFF &&
+           header.codec == CODEC_LZ4 &&
+           header.version == cVersion &&
+           header.decompressed_size != 0 &&
+           header.chunk_size != 0 &&
+           header.chunk_num == (u64(header.decompressed_size) + header.chunk_size - 1) / header.chunk_size &&
+           sizeof(Header) + u64(header.chunk_num) * sizeof(u32) <= file_size;
+}
+
+u8* Decompressor::allocBuffer_(FileDevice::LoadArg& arg, const Header& header, bool* need_unload)
+{
+    *need_unload = false;
+
+    if (arg.buffer)
+    {
+        if (arg.buffer_size < header.decompressed_size)
+        {
+            RIO_LOG("Decompressor::load(): arg.buffer_size[%u] is smaller than decompressed size[%u].\n", arg.buffer_size, header.decompressed_size);
+            return nullptr;
+        }
+
+        arg.roundup_size = arg.buffer_size;
+        return arg.buffer;
+    }
+
+    const u32 buffer_size = align(header.decompressed_size, FileDevice::cBufferMinAlignment);
+
+    arg.roundup_size = buffer_size;
+    *need_unload = true;
+    return (u8*)MemUtil::alloc(buffer_size, align(std::max(arg.alignment, 1u), FileDevice::cBufferMinAlignment));
+}
+
+u8* Decompressor::load(FileDevice::LoadArg& arg, const u8* src, u32 src_size)
+{
+    RIO_ASSERT(isCompressed(src, src_size));
+
+    Header header;
+    std::memcpy(&header, src, sizeof(Header));
+
+    if (!isValidHeader_(header, src_size))
+    {
+        RIO_LOG("Decompressor::load(): \"%s\" is not a valid compressed file (Or has the wrong endianness).\n", arg.path.c_str());
+        return nullptr;
+    }
+
+    bool need_unload;
+    u8* buffer = allocBuffer_(arg, header, &need_unload);
+    if (!buffer)
+        return nullptr;
+
+    Context context(header, buffer, getJobSystem_(header));
+
+    const u8* const table = src + sizeof(Header);
+    const u8* const data = table + header.chunk_num * sizeof(u32);
+
+    bool success = context.setChunkSizes(table, src_size - u32(data - src));
+    if (success)
+    {
+        for (u32 i = 0; i < header.chunk_num; i++)
+            context.decompress(i, data + context.getChunkOffset(i));
+    }
+
+    success = context.finish() && success;
+
+    if (!success)
+    {
+        RIO_LOG("Decompressor::load(): \"%s\" is corrupted.\n", arg.path.c_str());
+
+        if (need_unload)
+            MemUtil::free(buffer);
+
+        return nullptr;
+    }
+
+    arg.read_size = header.decompressed_size;
+    arg.need_unload = need_unload;
+    return buffer;
+}
+
+u8* Decompressor::load(FileDevice::LoadArg& arg, FileHandle* handle, const Header& header, u32 file_size)
+{
+    if (!isValidHeader_(header, file_size))
+    {
+        RIO_LOG("Decompressor::load(): \"%s\" is not a valid compressed file (Or has the wrong endianness).\n", arg.path.c_str());
+        return nullptr;
+    }
+
+    bool need_unload;
+    u8* buffer = allocBuffer_(arg, header, &need_unload);
+    if (!buffer)
+        return nullptr;
+
+    // Chunk size table, followed by the chunks
+    const u32 size = file_size - sizeof(Header);
+    const u32 table_size = header.chunk_num * sizeof(u32);
+
+    u8* const staging = (u8*)MemUtil::alloc(align(size, FileDevice::cBufferMinAlignment), FileDevice::cBufferMinAlignment);
+    if (!staging)
+    {
+        RIO_LOG("Decompressor::load(): Could not allocate 0x%X bytes to read \"%s\".\n", size, arg.path.c_str());
+
+        if (need_unload)
+            MemUtil::free(buffer);
+
+        return nullptr;
+    }
+
+    Context context(header, buffer, getJobSystem_(header));
+
+    bool success = true;
+    bool table_read = false;
+    u32 read_pos = 0;
+    u32 chunk_index = 0;
+
+    while (success && chunk_index < header.chunk_num)
+    {
+        u32 read_size = 0;
+        success = read_pos < size &&
+                  handle->tryRead(&read_size, staging + read_pos, std::min(cReadSize, size - read_pos)) &&
+                  read_size != 0;
+
+        read_pos += read_size;
+
+        if (success && !table_read && read_pos >= table_size)
+        {
+            success = context.setChunkSizes(staging, size - table_size);
+            table_read = true;
+        }
+
+        if (!success || !table_read)
+            continue;
+
+        // Decompress every chunk read entirely, while the next ones are read
+        while (chunk_index < header.chunk_num && table_size + context.getChunkEnd(chunk_index) <= read_pos)
+        {
+            context.decompress(chunk_index, staging + table_size + context.getChunkOffset(chunk_index));
+            chunk_index++;
+        }
+    }
+
+    // Jobs use the staging buffer until then
+    success = context.finish() && success;
+
+    MemUtil::free(staging);
+
+    if (!success)
+    {
+        RIO_LOG("Decompressor::load(): Could not read or decompress \"%s\".\n", arg.path.c_str());
+
+        if (need_unload)
+            MemUtil::free(buffer);
+
+        return nullptr;
+    }
+
+    arg.read_size = header.decompressed_size;
+    arg.need_unload = need_unload;
+    return buffer;
+}
+
+bool Decompressor::decompressLZ4(u8* dst, u32 dst_size, const u8* src, u32 src_size)
+{
+    // LZ4 block format: sequences of a token (Literal length:4, match length:4), literals
+    // and a match (Offset:16, little endian), the last sequence only having literals.
+    // Lengths of 15 are continued by bytes added until one is not 255.
+
+    const u8* ip = src;
+    const u8* const ip_end = src + src_size;
+    u8* op = dst;
+    u8* const op_end = dst + dst_size;
+
+    while (ip < ip_end)
+    {
+        const u32 token = *ip++;
+
+        size_t literal_len = token >> 4;
+        if (literal_len == 15)
+        {
+            u32 byte;
+            do
+            {
+                if (ip == ip_end)
+                    return false;
+
+                byte = *ip++;
+                literal_len += byte;
+            }
+            while (byte == 255);
+        }
+
+        if (literal_len > size_t(ip_end - ip) || literal_len > size_t(op_end - op))
+            return false;
+
+        std::memcpy(op, ip, literal_len);
+        ip += literal_len;
+        op += literal_len;
+
+        // Last sequence
+        if (ip == ip_end)
+            break;
+
+        if (ip_end - ip < 2)
+            return false;
+
+        const size_t offset = size_t(ip[0]) | size_t(ip[1]) << 8;
+        ip += 2;
+
+        if (offset == 0 || offset > size_t(op - dst))
+            return false;
+
+        size_t match_len = token & 15;
+        if (match_len == 15)
+        {
+            u32 byte;
+            do
+            {
+                if (ip == ip_end)
+                    return false;
+
+                byte = *ip++;
+                match_len += byte;
+            }
+            while (byte == 255);
+        }
+        match_len += 4;
+
+        if (match_len > size_t(op_end - op))
+            return false;
+
+        const u8* match = op - offset;
+        if (offset >= match_len)
+        {
+            std::memcpy(op, match, match_len);
+            op += match_len;
+        }
+        else
+        {
+            // Overlapping match (Repeating pattern)
+            for (size_t i = 0; i < match_len; i++)
+                *op++ = *match++;
+        }
+    }
+
+    return op == op_end;
+}
+
+}
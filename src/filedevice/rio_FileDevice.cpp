@@ -1,7 +1,13 @@
+#include <filedevice/rio_Decompressor.h>
 #include <filedevice/rio_FileDevice.h>
 #include <filedevice/rio_FileDeviceMgr.h>
 #include <misc/rio_MemUtil.h>
 
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
 namespace {
 
 static inline u32 max(u32 x, u32 y)
@@ -18,6 +24,11 @@ static inline u32 align(u32 x, u32 y)
     return (x + y - 1) & -y;
 }
 
+// Data to release with a function other than MemUtil::free() (See FileDevice::registerUnload_())
+static std::mutex sUnloadFuncCS;
+static std::unordered_map<u8*, rio::FileDevice::UnloadFunc> sUnloadFuncs;
+static std::atomic<u32> sUnloadFuncNum(0);  // Skips the lookup while nothing is registered
+
 }
 
 namespace rio {
@@ -28,6 +39,99 @@ FileDevice::~FileDevice()
         FileDeviceMgr::instance()->unmount(this);
 }
 
+void FileDevice::setDriveName(const std::string& drive_name)
+{
+    mDriveName = drive_name;
+    mDriveNameHash = Hash::calcFNV1a(drive_name.c_str(), drive_name.length());
+
+    // Keep the lookup of mounted devices up to date
+    if (mList && FileDeviceMgr::instance())
+        FileDeviceMgr::instance()->updateDeviceIndex_();
+}
+
+std::string FileDevice::getNativePath(std::string_view path) const
+{
+    std::string_view root;
+    if (!getNativeRoot_(&root))
+        return std::string();
+
+    if (root.empty())
+        return std::string(path);
+
+    std::string native_path;
+    native_path.reserve(root.length() + 1 + path.length());
+    native_path.append(root).append(1, '/').append(path);
+    return native_path;
+}
+
+bool FileDevice::getNativePath(char* buf, size_t size, std::string_view path) const
+{
+    RIO_ASSERT(buf);
+
+    std::string_view root;
+    if (!getNativeRoot_(&root))
+        return false;
+
+    const size_t root_length = root.empty() ? 0 : root.length() + 1;
+    if (root_length + path.length() >= size)
+    {
+        RIO_LOG("FileDevice::getNativePath(): Path too long. [%.*s]\n", int(path.length()), path.data());
+        return false;
+    }
+
+    if (root_length > 0)
+    {
+        std::memcpy(buf, root.data(), root.length());
+        buf[root.length()] = '/';
+    }
+
+    std::memcpy(buf + root_length, path.data(), path.length());
+    buf[root_length + path.length()] = '\0';
+    return true;
+}
+
+void FileDevice::unload(u8* data)
+{
+    RIO_ASSERT(data);
+
+    if (sUnloadFuncNum.load(std::memory_order_acquire) > 0)
+    {
+        UnloadFunc func = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(sUnloadFuncCS);
+
+            std::unordered_map<u8*, UnloadFunc>::iterator it = sUnloadFuncs.find(data);
+            if (it != sUnloadFuncs.end())
+            {
+                func = it->second;
+                sUnloadFuncs.erase(it);
+                sUnloadFuncNum.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        if (func)
+        {
+            (*func)(data);
+            return;
+        }
+    }
+
+    MemUtil::free(data);
+}
+
+void FileDevice::registerUnload_(u8* data, UnloadFunc func)
+{
+    RIO_ASSERT(data);
+    RIO_ASSERT(func);
+
+    std::lock_guard<std::mutex> lock(sUnloadFuncCS);
+
+    [[maybe_unused]] const bool inserted = sUnloadFuncs.emplace(data, func).second;
+    RIO_ASSERT(inserted);
+
+    sUnloadFuncNum.fetch_add(1, std::memory_order_release);
+}
+
 RawErrorCode FileDevice::getLastRawError() const
 {
     return doGetLastRawError_();
@@ -35,10 +139,46 @@ RawErrorCode FileDevice::getLastRawError() const
 
 u8* FileDevice::tryLoad(FileDevice::LoadArg& arg)
 {
-    return doLoad_(arg);
+    const u64 begin = FileDeviceStats::now();
+
+    u8* data = doLoad_(arg);
+
+    mStats.record(FileDeviceStats::OP_LOAD, begin, data ? arg.read_size : 0, data != nullptr);
+    return data;
 }
 
-FileDevice* FileDevice::tryOpen(FileHandle* handle, const std::string& filename, FileDevice::FileOpenFlag flag)
+u32 FileDevice::tryLoadMultiple(FileDevice::LoadArg* args, u8** data, u32 num)
+{
+    if (num == 0)
+        return 0;
+
+    if (args == nullptr || data == nullptr)
+    {
+        RIO_LOG("FileDevice::tryLoadMultiple(): args or data is null.\n");
+        RIO_ASSERT(false);
+        return 0;
+    }
+
+    const u64 begin = FileDeviceStats::now();
+
+    doLoadMultiple_(args, data, num);
+
+    u32 loaded_num = 0;
+    u64 loaded_size = 0;
+    for (u32 i = 0; i < num; i++)
+    {
+        if (data[i])
+        {
+            loaded_num++;
+            loaded_size += args[i].read_size;
+        }
+    }
+
+    mStats.record(FileDeviceStats::OP_LOAD_MULTIPLE, begin, loaded_size, loaded_num == num);
+    return loaded_num;
+}
+
+FileDevice* FileDevice::tryOpen(FileHandle* handle, std::string_view filename, FileDevice::FileOpenFlag flag)
 {
     if (handle == nullptr)
     {
@@ -47,7 +187,12 @@ FileDevice* FileDevice::tryOpen(FileHandle* handle, const std::string& filename,
         return nullptr;
     }
 
+    const u64 begin = FileDeviceStats::now();
+
     FileDevice* device = doOpen_(handle, filename, flag);
+
+    mStats.record(FileDeviceStats::OP_OPEN, begin, 0, device != nullptr);
+
     handle->mDevice = device;
     if (device)
         handle->mOriginalDevice = this;
@@ -104,8 +249,12 @@ bool FileDevice::tryRead(u32* read_size, FileHandle* handle, u8* buf, u32 size)
         return false;
     }
 
+    const u64 begin = FileDeviceStats::now();
+
     bool success = doRead_(read_size, handle, buf, size);
     RIO_ASSERT(!read_size || *read_size <= size);
+
+    mStats.record(FileDeviceStats::OP_READ, begin, success && read_size ? *read_size : 0, success);
     return success;
 }
 
@@ -132,8 +281,12 @@ bool FileDevice::tryWrite(u32* write_size, FileHandle* handle, const u8* buf, u3
         return false;
     }
 
+    const u64 begin = FileDeviceStats::now();
+
     bool success = doWrite_(write_size, handle, buf, size);
     RIO_ASSERT(!write_size || *write_size <= size);
+
+    mStats.record(FileDeviceStats::OP_WRITE, begin, success && write_size ? *write_size : 0, success);
     return success;
 }
 
@@ -153,7 +306,12 @@ bool FileDevice::trySeek(FileHandle* handle, s32 offset, FileDevice::SeekOrigin
         return false;
     }
 
-    return doSeek_(handle, offset, origin);
+    const u64 begin = FileDeviceStats::now();
+
+    bool success = doSeek_(handle, offset, origin);
+
+    mStats.record(FileDeviceStats::OP_SEEK, begin, 0, success);
+    return success;
 }
 
 bool FileDevice::tryGetCurrentSeekPos(u32* pos, FileHandle* handle)
@@ -182,7 +340,7 @@ bool FileDevice::tryGetCurrentSeekPos(u32* pos, FileHandle* handle)
     return doGetCurrentSeekPos_(pos, handle);
 }
 
-bool FileDevice::tryGetFileSize(u32* size, const std::string& path)
+bool FileDevice::tryGetFileSize(u32* size, std::string_view path)
 {
     if (size == nullptr)
     {
@@ -220,7 +378,7 @@ bool FileDevice::tryGetFileSize(u32* size, FileHandle* handle)
     return doGetFileSize_(size, handle);
 }
 
-bool FileDevice::tryIsExistFile(bool* is_exist, const std::string& path)
+bool FileDevice::tryIsExistFile(bool* is_exist, std::string_view path)
 {
     if (is_exist == nullptr)
     {
@@ -232,6 +390,42 @@ bool FileDevice::tryIsExistFile(bool* is_exist, const std::string& path)
     return doIsExistFile_(is_exist, path);
 }
 
+bool FileDevice::tryGetLoadSize(u32* size, std::string_view path)
+{
+    if (size == nullptr)
+    {
+        RIO_LOG("FileDevice::tryGetLoadSize(): size is null.\n");
+        RIO_ASSERT(false);
+        return false;
+    }
+
+    FileHandle handle;
+    if (!tryOpen(&handle, path, FileDevice::FILE_OPEN_FLAG_READ))
+        return false;
+
+    u32 file_size = 0;
+    if (!tryGetFileSize(&file_size, &handle))
+        return false;
+
+    *size = file_size;
+
+    // Check for a compressed file
+    if (file_size >= sizeof(Decompressor::Header))
+    {
+        alignas(FileDevice::cBufferMinAlignment) Decompressor::Header header;
+
+        u32 header_size = 0;
+        if (!tryRead(&header_size, &handle, reinterpret_cast<u8*>(&header), sizeof(Decompressor::Header)))
+            return false;
+
+        // The size of a file of the wrong endianness does not matter, as it cannot be loaded
+        if (Decompressor::isCompressed(reinterpret_cast<const u8*>(&header), header_size) && header.bom == 0xFEFF)
+            *size = header.decompressed_size;
+    }
+
+    return tryClose(&handle);
+}
+
 u8* FileDevice::doLoad_(FileDevice::LoadArg& arg)
 {
     if (arg.buffer && arg.buffer_size == 0)
@@ -256,6 +450,33 @@ u8* FileDevice::doLoad_(FileDevice::LoadArg& arg)
         return nullptr;
     }
 
+    // Check for a compressed file
+    if (file_size >= sizeof(Decompressor::Header))
+    {
+        alignas(FileDevice::cBufferMinAlignment) Decompressor::Header header;
+
+        u32 header_size = 0;
+        if (!tryRead(&header_size, &handle, reinterpret_cast<u8*>(&header), sizeof(Decompressor::Header)))
+            return nullptr;
+
+        if (Decompressor::isCompressed(reinterpret_cast<const u8*>(&header), header_size))
+        {
+            u8* buffer = Decompressor::load(arg, &handle, header, file_size);
+            if (!tryClose(&handle) && buffer)
+            {
+                if (arg.need_unload)
+                    MemUtil::free(buffer);
+
+                return nullptr;
+            }
+
+            return buffer;
+        }
+
+        if (!trySeek(&handle, 0, FileDevice::SEEK_ORIGIN_BEGIN))
+            return nullptr;
+    }
+
     u32 buffer_size = arg.buffer_size;
     if (buffer_size == 0)
         buffer_size = align(file_size, FileDevice::cBufferMinAlignment);
@@ -299,6 +520,12 @@ u8* FileDevice::doLoad_(FileDevice::LoadArg& arg)
     return buffer;
 }
 
+void FileDevice::doLoadMultiple_(FileDevice::LoadArg* args, u8** data, u32 num)
+{
+    for (u32 i = 0; i < num; i++)
+        data[i] = doLoad_(args[i]);
+}
+
 void FileHandle::close()
 {
     if (!isOpen())
@@ -1,5 +1,11 @@
 #include <filedevice/rio_FileDeviceMgr.h>
+#include <filedevice/rio_LoadBatch.h>
 #include <filedevice/rio_Path.h>
+#include <thread/rio_WorkQueue.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 #if RIO_IS_CAFE
 extern "C" {
@@ -8,16 +14,59 @@ void SAVEShutdown();
 }
 #endif // RIO_IS_CAFE
 
+namespace {
+
+// Removes the drive prefix of a path in place for its lifetime
+class ScopedPathExceptDrive
+{
+public:
+    ScopedPathExceptDrive(std::string* path, size_t prefix_length)
+        : mPath(path)
+        , mPrefixLength(prefix_length)
+    {
+        if (mPrefixLength == 0)
+            return;
+
+        // Drive prefixes are short, longer ones are saved on the heap
+        if (mPrefixLength <= sizeof(mPrefix))
+            std::memcpy(mPrefix, mPath->data(), mPrefixLength);
+        else
+            mLongPrefix.assign(*mPath, 0, mPrefixLength);
+
+        // Erasing never reallocates, and restoring the prefix fits in the capacity
+        mPath->erase(0, mPrefixLength);
+    }
+
+    ~ScopedPathExceptDrive()
+    {
+        if (mPrefixLength == 0)
+            return;
+
+        if (mPrefixLength <= sizeof(mPrefix))
+            mPath->insert(0, mPrefix, mPrefixLength);
+        else
+            mPath->insert(0, mLongPrefix);
+    }
+
+private:
+    std::string*    mPath;
+    size_t          mPrefixLength;
+    char            mPrefix[32];
+    std::string     mLongPrefix;
+};
+
+}
+
 namespace rio {
 
 FileDeviceMgr* FileDeviceMgr::sInstance = nullptr;
 
-bool FileDeviceMgr::createSingleton()
+bool FileDeviceMgr::createSingleton(u32 load_thread_num)
 {
     if (sInstance)
         return false;
 
-    sInstance = new FileDeviceMgr();
+    sInstance = new FileDeviceMgr(load_thread_num);
     return true;
 }
 
@@ -30,9 +79,14 @@ void FileDeviceMgr::destroySingleton()
     sInstance = nullptr;
 }
 
-FileDeviceMgr::FileDeviceMgr()
+FileDeviceMgr::FileDeviceMgr(u32 load_thread_num)
     : mDeviceList()
+    , mMountGeneration(0)
+    , mLoadThreadNum(load_thread_num > 0 ? load_thread_num : 1)
+    , mLoadQueue(nullptr)
 {
+    RIO_ASSERT(load_thread_num > 0);
+
 #if RIO_IS_CAFE
     FSInit();
     FSAddClient(&mFSClient, FS_ERROR_FLAG_NONE);
@@ -59,6 +113,40 @@ FileDeviceMgr::FileDeviceMgr()
 
 FileDeviceMgr::~FileDeviceMgr()
 {
+    // Before the devices are deleted
+    clearPreloads();
+
+    // Cancel the asynchronous loads that have not started and wait for the running ones
+    {
+        std::vector<AsyncLoadHandle> loads;
+        {
+            std::lock_guard<std::mutex> lock(mAsyncLoadCS);
+
+            loads.reserve(mAsyncLoads.size());
+            for (AsyncLoad* load : mAsyncLoads)
+                loads.push_back(load->mSelf);
+        }
+
+        for (const AsyncLoadHandle& load : loads)
+            cancelLoadAsync(load);
+    }
+
+    if (mLoadQueue)
+    {
+        delete mLoadQueue;
+        mLoadQueue = nullptr;
+    }
+
+    // Loads that were not completed yet are dropped without calling their callbacks
+    for (AsyncLoad* load : mLoadedAsyncLoads)
+    {
+        AsyncLoadHandle self = std::move(load->mSelf);
+        load->mState.store(AsyncLoad::STATE_CANCELED, std::memory_order_release);
+    }
+
+    mAsyncLoads.clear();
+    mLoadedAsyncLoads.clear();
+
     if (mMainFileDevice)
     {
         delete mMainFileDevice;
@@ -93,17 +181,43 @@ void FileDeviceMgr::mount(FileDevice* device, const std::string& drive_name)
     RIO_ASSERT(device);
 
     if (!drive_name.empty())
-        device->mDriveName = drive_name;
+        device->setDriveName(drive_name);
 
     mDeviceList.pushBack(device);
+    updateDeviceIndex_();
 }
 
 void FileDeviceMgr::unmount(FileDevice* device)
 {
     RIO_ASSERT(device);
 
+    // Drop the device's preloads, as the device may be deleted after this
+    waitPreloads();
+    {
+        std::lock_guard<std::mutex> lock(mPreloadCS);
+
+        for (PreloadMap::iterator it = mPreloads.begin(); it != mPreloads.end(); )
+        {
+            Preload* preload = it->second;
+            if (preload->device != device)
+            {
+                ++it;
+                continue;
+            }
+
+            if (preload->data && preload->need_unload)
+                FileDevice::unload(preload->data);
+
+            delete preload;
+            it = mPreloads.erase(it);
+        }
+    }
+
     if (device->mList)
+    {
         mDeviceList.erase(device);
+        updateDeviceIndex_();
+    }
 
     if (device == mDefaultFileDevice)
         mDefaultFileDevice = nullptr;
@@ -114,7 +228,23 @@ FileDeviceMgr::findDeviceFromPath(
     const std::string& path, std::string* no_drive_path
 ) const
 {
-    std::string drive;
+    std::string_view no_drive_path_;
+    FileDevice* device = findDeviceFromPath(std::string_view(path), &no_drive_path_);
+    if (!device)
+        return nullptr;
+
+    if (no_drive_path)
+        *no_drive_path = no_drive_path_;
+
+    return device;
+}
+
+FileDevice*
+FileDeviceMgr::findDeviceFromPath(
+    std::string_view path, std::string_view* no_drive_path
+) const
+{
+    std::string_view drive;
     FileDevice* device;
 
     device = Path::getDriveName(&drive, path) ? findDevice(drive)
@@ -123,24 +253,46 @@ FileDeviceMgr::findDeviceFromPath(
         return nullptr;
 
     if (no_drive_path)
-        Path::getPathExceptDrive(no_drive_path, path);
+        *no_drive_path = Path::getPathExceptDrive(path);
 
     return device;
 }
 
 FileDevice*
-FileDeviceMgr::findDevice(const std::string& drive) const
+FileDeviceMgr::findDevice(std::string_view drive) const
 {
-    for (FileDeviceMgr::DeviceList::iterator it = mDeviceList.begin(); it != mDeviceList.end(); ++it)
-        if ((*it)->mDriveName == drive)
-            return (*it);
+    const u32 hash = Hash::calcFNV1a(drive.data(), drive.length());
+
+    std::vector<DeviceIndexEntry>::const_iterator it = std::lower_bound(
+        mDeviceIndex.begin(), mDeviceIndex.end(), hash,
+        [](const DeviceIndexEntry& entry, u32 hash) { return entry.hash < hash; }
+    );
+
+    // Names of equal hash are compared
+    for (; it != mDeviceIndex.end() && it->hash == hash; ++it)
+        if (it->device->mDriveName == drive)
+            return it->device;
 
     return nullptr;
 }
 
-FileDevice* FileDeviceMgr::tryOpen(FileHandle* handle, const std::string& filename, FileDevice::FileOpenFlag flag)
+void FileDeviceMgr::updateDeviceIndex_()
 {
-    std::string no_drive_path;
+    mDeviceIndex.clear();
+
+    for (FileDeviceMgr::DeviceList::iterator it = mDeviceList.begin(); it != mDeviceList.end(); ++it)
+        mDeviceIndex.push_back({ (*it)->mDriveNameHash, *it });
+
+    std::stable_sort(mDeviceIndex.begin(), mDeviceIndex.end(), [](const DeviceIndexEntry& lhs, const DeviceIndexEntry& rhs) {
+        return lhs.hash < rhs.hash;
+    });
+
+    mMountGeneration.fetch_add(1, std::memory_order_release);
+}
+
+FileDevice* FileDeviceMgr::tryOpen(FileHandle* handle, std::string_view filename, FileDevice::FileOpenFlag flag)
+{
+    std::string_view no_drive_path;
     FileDevice* device = findDeviceFromPath(filename, &no_drive_path);
     if (!device)
         return nullptr;
@@ -152,21 +304,658 @@ u8* FileDeviceMgr::tryLoad(FileDevice::LoadArg& arg)
 {
     RIO_ASSERT(!arg.path.empty());
 
+    u8* preloaded = takePreload_(arg);
+    if (preloaded)
+        return preloaded;
+
+    std::string_view no_drive_path;
+    FileDevice* device = findDeviceFromPath(std::string_view(arg.path), &no_drive_path);
+    if (!device)
+        return nullptr;
+
+    // The device is given the path without its drive, removed from arg.path (And restored after) without allocating
+    ScopedPathExceptDrive path_except_drive(&arg.path, arg.path.length() - no_drive_path.length());
+
+    return device->tryLoad(arg);
+}
+
+u32 FileDeviceMgr::tryLoadMultiple(FileDevice::LoadArg* args, u8** data, u32 num)
+{
+    std::vector<FileDevice*> devices(num, nullptr);
+    std::vector<FileDevice::LoadArg> device_args;
+    std::vector<u8*> device_data;
+    std::vector<u32> indices;
+
+    u32 loaded_num = 0;
+
+    for (u32 i = 0; i < num; i++)
+    {
+        RIO_ASSERT(!args[i].path.empty());
+
+        data[i] = takePreload_(args[i]);
+        if (data[i])
+        {
+            loaded_num++;
+            continue;
+        }
+
+        devices[i] = findDeviceFromPath(std::string_view(args[i].path), nullptr);
+    }
+
+    // One batch per device, in order of first appearance
+    for (u32 i = 0; i < num; i++)
+    {
+        FileDevice* const device = devices[i];
+        if (!device)
+            continue;
+
+        device_args.clear();
+        indices.clear();
+
+        for (u32 j = i; j < num; j++)
+        {
+            if (devices[j] != device)
+                continue;
+
+            devices[j] = nullptr;
+            indices.push_back(j);
+
+            device_args.push_back(args[j]);
+            Path::getPathExceptDrive(&device_args.back().path, args[j].path);
+        }
+
+        device_data.resize(indices.size());
+        loaded_num += device->tryLoadMultiple(device_args.data(), device_data.data(), indices.size());
+
+        for (u32 j = 0; j < indices.size(); j++)
+        {
+            FileDevice::LoadArg& arg = args[indices[j]];
+            const FileDevice::LoadArg& arg_ = device_args[j];
+
+            arg.read_size = arg_.read_size;
+            arg.roundup_size = arg_.roundup_size;
+            arg.need_unload = arg_.need_unload;
+
+            data[indices[j]] = device_data[j];
+        }
+    }
+
+    return loaded_num;
+}
+
+bool FileDeviceMgr::tryLoadBatch(LoadBatch* batch)
+{
+    RIO_ASSERT(batch);
+
+    if (batch->isLoaded())
+    {
+        RIO_LOG("FileDeviceMgr::tryLoadBatch(): The batch is already loaded.\n");
+        RIO_ASSERT(false);
+        return false;
+    }
+
+    const u32 num = batch->getFileNum();
+    if (num == 0)
+        return true;
+
+    struct Entry
+    {
+        u32             index;
+        FileDevice*     device;
+        std::string     native_path;
+        u32             size;
+        u32             offset;
+    };
+
+    std::vector<Entry> entries;
+    entries.reserve(num);
+
+    bool success = true;
+
+    // Query the size of every file first
+    for (u32 i = 0; i < num; i++)
+    {
+        LoadBatch::File& file = batch->mFiles[i];
+
+        std::string_view no_drive_path;
+        FileDevice* device = findDeviceFromPath(std::string_view(file.path), &no_drive_path);
+
+        u32 size = 0;
+        if (!device || !device->tryGetLoadSize(&size, no_drive_path))
+        {
+            RIO_LOG("FileDeviceMgr::tryLoadBatch(): Could not get the size of \"%s\".\n", file.path.c_str());
+            success = false;
+            continue;
+        }
+
+        entries.push_back({ i, device, device->getNativePath(no_drive_path), size, 0 });
+    }
+
+    // Read (And lay out) the files of each device in path order, as files written together tend to be stored together
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+        if (lhs.device != rhs.device)
+            return lhs.device < rhs.device;
+
+        return lhs.native_path < rhs.native_path;
+    });
+
+    u64 arena_size = 0;
+    u32 alignment_max = FileDevice::cBufferMinAlignment;
+
+    for (Entry& entry : entries)
+    {
+        const u32 alignment = std::max(batch->mFiles[entry.index].alignment, u32(FileDevice::cBufferMinAlignment));
+        alignment_max = std::max(alignment, alignment_max);
+
+        arena_size = (arena_size + alignment - 1) & -u64(alignment);
+        entry.offset = u32(arena_size);
+
+        arena_size += (u64(entry.size) + FileDevice::cBufferMinAlignment - 1) & -u64(FileDevice::cBufferMinAlignment);
+        if (arena_size > 0xFFFFFFFF)
+        {
+            RIO_LOG("FileDeviceMgr::tryLoadBatch(): The files are too large for a single arena.\n");
+            return false;
+        }
+    }
+
+    if (arena_size == 0)
+        return false;
+
+    u8* const arena = static_cast<u8*>(MemUtil::alloc(arena_size, alignment_max));
+    if (!arena)
+        return false;
+
+    batch->mArena = arena;
+    batch->mArenaSize = u32(arena_size);
+
+    std::vector<FileDevice::LoadArg> args(entries.size());
+    std::vector<u8*> data(entries.size());
+
+    for (u32 i = 0; i < entries.size(); i++)
+    {
+        const Entry& entry = entries[i];
+        FileDevice::LoadArg& arg = args[i];
+
+        arg.path = batch->mFiles[entry.index].path;
+        arg.buffer = arena + entry.offset;
+        arg.buffer_size = (entry.size + FileDevice::cBufferMinAlignment - 1) & -u32(FileDevice::cBufferMinAlignment);
+        arg.alignment = batch->mFiles[entry.index].alignment;
+    }
+
+    if (tryLoadMultiple(args.data(), data.data(), args.size()) != args.size())
+        success = false;
+
+    for (u32 i = 0; i < entries.size(); i++)
+    {
+        LoadBatch::File& file = batch->mFiles[entries[i].index];
+
+        // Data not in the arena (e.g., a file changed after its size was queried) is not kept
+        if (data[i] && data[i] != args[i].buffer)
+        {
+            if (args[i].need_unload)
+                unload(data[i]);
+
+            data[i] = nullptr;
+            success = false;
+        }
+
+        if (!data[i])
+        {
+            RIO_LOG("FileDeviceMgr::tryLoadBatch(): Could not load \"%s\".\n", file.path.c_str());
+            continue;
+        }
+
+        file.data = data[i];
+        file.size = args[i].read_size;
+    }
+
+    return success;
+}
+
+void FileDeviceMgr::preload(const std::string& path)
+{
+    RIO_ASSERT(!path.empty());
+
     std::string no_drive_path;
-    FileDevice* device = findDeviceFromPath(arg.path, &no_drive_path);
+    FileDevice* device = findDeviceFromPath(path, &no_drive_path);
     if (!device)
+    {
+        RIO_LOG("FileDeviceMgr::preload(): Device not found. [%s]\n", path.c_str());
+        return;
+    }
+
+    Preload* preload = new Preload;
+    preload->device = device;
+    preload->path = no_drive_path;
+    preload->data = nullptr;
+    preload->read_size = 0;
+    preload->roundup_size = 0;
+    preload->need_unload = false;
+    preload->done = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mPreloadCS);
+
+        if (!mPreloads.emplace(path, preload).second)
+        {
+            // Already preloading
+            delete preload;
+            return;
+        }
+    }
+
+    getLoadQueue_()->push(&FileDeviceMgr::preloadMain_, preload, AsyncLoad::PRIORITY_NORMAL);
+}
+
+void FileDeviceMgr::preloadMain_(void* arg)
+{
+    Preload* preload = static_cast<Preload*>(arg);
+
+    FileDevice::LoadArg load_arg;
+    load_arg.path = preload->path;
+
+    u8* data = preload->device->tryLoad(load_arg);
+    if (!data)
+        RIO_LOG("FileDeviceMgr::preload(): Failure. [%s]\n", preload->path.c_str());
+
+    FileDeviceMgr* mgr = sInstance;
+    {
+        std::lock_guard<std::mutex> lock(mgr->mPreloadCS);
+
+        preload->data = data;
+        preload->read_size = load_arg.read_size;
+        preload->roundup_size = load_arg.roundup_size;
+        preload->need_unload = load_arg.need_unload;
+        preload->done = true;
+    }
+    mgr->mPreloadCond.notify_all();
+}
+
+u8* FileDeviceMgr::takePreload_(FileDevice::LoadArg& arg)
+{
+    Preload* preload;
+    {
+        std::unique_lock<std::mutex> lock(mPreloadCS);
+
+        if (mPreloads.empty())
+            return nullptr;
+
+        PreloadMap::iterator it = mPreloads.find(arg.path);
+        if (it == mPreloads.end())
+            return nullptr;
+
+        // Taken by this call only: other loads of the same path read the file themselves
+        preload = it->second;
+        mPreloads.erase(it);
+
+        mPreloadCond.wait(lock, [preload] { return preload->done; });
+    }
+
+    u8* data = preload->data;
+    const u32 read_size = preload->read_size;
+    const u32 roundup_size = preload->roundup_size;
+    const bool need_unload = preload->need_unload;
+    delete preload;
+
+    // Failed preloads fall back to a regular load, which reports the error
+    if (!data)
         return nullptr;
 
-    FileDevice::LoadArg arg_(arg);
-    arg_.path = no_drive_path;
+    if (arg.buffer)
+    {
+        // Caller-owned buffer: copy into it
+        if (arg.buffer_size < read_size)
+        {
+            if (need_unload)
+                FileDevice::unload(data);
+
+            return nullptr;
+        }
+
+        std::memcpy(arg.buffer, data, read_size);
+
+        if (need_unload)
+            FileDevice::unload(data);
+
+        arg.read_size = read_size;
+        arg.roundup_size = arg.buffer_size;
+        arg.need_unload = false;
+        return arg.buffer;
+    }
+
+    // Preloads use the default alignment, reload if the caller needs more
+    if (arg.alignment > 1 && uintptr_t(data) % arg.alignment != 0)
+    {
+        if (need_unload)
+            FileDevice::unload(data);
+
+        return nullptr;
+    }
+
+    arg.read_size = read_size;
+    arg.roundup_size = roundup_size;
+    arg.need_unload = need_unload;
+    return data;
+}
+
+void FileDeviceMgr::waitPreloads()
+{
+    WorkQueue* queue = peekLoadQueue_();
+    if (queue)
+        queue->waitIdle();
+}
+
+void FileDeviceMgr::clearPreloads()
+{
+    WorkQueue* queue = peekLoadQueue_();
+
+    std::unique_lock<std::mutex> lock(mPreloadCS);
+
+    // Waiting unlocks mPreloadCS, so the preloads are detached from the map first
+    PreloadMap preloads;
+    preloads.swap(mPreloads);
+
+    for (const auto& it : preloads)
+    {
+        Preload* preload = it.second;
+
+        // Wait for the preloads that are already loading
+        if (!queue->cancel(&FileDeviceMgr::preloadMain_, preload))
+            mPreloadCond.wait(lock, [preload] { return preload->done; });
+
+        if (preload->data && preload->need_unload)
+            FileDevice::unload(preload->data);
+
+        delete preload;
+    }
+}
+
+u32 FileDeviceMgr::getPreloadNum() const
+{
+    std::lock_guard<std::mutex> lock(mPreloadCS);
+    return mPreloads.size();
+}
+
+WorkQueue* FileDeviceMgr::getLoadQueue_()
+{
+    std::lock_guard<std::mutex> lock(mLoadQueueCS);
+
+    if (!mLoadQueue)
+        mLoadQueue = new WorkQueue(mLoadThreadNum, "rio::FileDeviceMgr::Loader");
+
+    return mLoadQueue;
+}
+
+WorkQueue* FileDeviceMgr::peekLoadQueue_() const
+{
+    std::lock_guard<std::mutex> lock(mLoadQueueCS);
+    return mLoadQueue;
+}
+
+AsyncLoad::AsyncLoad(const FileDevice::LoadArg& arg, Priority priority, Callback callback, void* user_data)
+    : mArg(arg)
+    , mDevice(nullptr)
+    , mPriority(priority)
+    , mCallback(callback)
+    , mUserData(user_data)
+    , mState(STATE_QUEUED)
+    , mData(nullptr)
+{
+}
+
+AsyncLoad::~AsyncLoad()
+{
+    if (mData && mArg.need_unload)
+        FileDevice::unload(mData);
+}
+
+AsyncLoadHandle
+FileDeviceMgr::tryLoadAsync(
+    const FileDevice::LoadArg& arg, AsyncLoad::Priority priority,
+    AsyncLoad::Callback callback, void* user_data
+)
+{
+    RIO_ASSERT(!arg.path.empty());
+
+    std::string no_drive_path;
+    FileDevice* device = findDeviceFromPath(arg.path, &no_drive_path);
+    if (!device)
+    {
+        RIO_LOG("FileDeviceMgr::tryLoadAsync(): Device not found. [%s]\n", arg.path.c_str());
+        return AsyncLoadHandle();
+    }
+
+    AsyncLoadHandle load(new AsyncLoad(arg, priority, callback, user_data));
+    load->mDevice = device;
+    load->mDevicePath = no_drive_path;
+    load->mSelf = load;
+
+    {
+        std::lock_guard<std::mutex> lock(mAsyncLoadCS);
+        mAsyncLoads.push_back(load.get());
+    }
+
+    getLoadQueue_()->push(&FileDeviceMgr::loadAsyncMain_, load.get(), priority);
+    return load;
+}
+
+void FileDeviceMgr::loadAsyncMain_(void* arg)
+{
+    AsyncLoad* load = static_cast<AsyncLoad*>(arg);
+    load->mState.store(AsyncLoad::STATE_LOADING, std::memory_order_release);
+
+    FileDevice::LoadArg load_arg(load->mArg);
+    load_arg.path = load->mDevicePath;
+
+    u8* data = load->mDevice->tryLoad(load_arg);
+    if (!data)
+        RIO_LOG("FileDeviceMgr::tryLoadAsync(): Failure. [%s]\n", load->mArg.path.c_str());
+
+    load->mArg.read_size = load_arg.read_size;
+    load->mArg.roundup_size = load_arg.roundup_size;
+    load->mArg.need_unload = load_arg.need_unload;
+    load->mData = data;
+
+    FileDeviceMgr* mgr = sInstance;
+    {
+        std::lock_guard<std::mutex> lock(mgr->mAsyncLoadCS);
+
+        load->mState.store(AsyncLoad::STATE_LOADED, std::memory_order_release);
+        mgr->mLoadedAsyncLoads.push_back(load);
+    }
+    mgr->mAsyncLoadCond.notify_all();
+}
+
+bool FileDeviceMgr::cancelLoadAsync(const AsyncLoadHandle& load)
+{
+    if (!load)
+        return false;
+
+    WorkQueue* queue = peekLoadQueue_();
+    if (!queue || !queue->cancel(&FileDeviceMgr::loadAsyncMain_, load.get()))
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock(mAsyncLoadCS);
+        removeLoadAsync_(load.get());
+    }
 
-    u8* ret = device->tryLoad(arg_);
+    load->mState.store(AsyncLoad::STATE_CANCELED, std::memory_order_release);
+    load->mSelf.reset();
+    return true;
+}
+
+void FileDeviceMgr::waitLoadAsync(const AsyncLoadHandle& load)
+{
+    if (!load || load->isDone())
+        return;
+
+    // Load it right away rather than waiting behind other loads
+    WorkQueue* queue = peekLoadQueue_();
+    if (queue && queue->cancel(&FileDeviceMgr::loadAsyncMain_, load.get()))
+        loadAsyncMain_(load.get());
+
+    {
+        std::unique_lock<std::mutex> lock(mAsyncLoadCS);
+        mAsyncLoadCond.wait(lock, [&load] { return load->getState() == AsyncLoad::STATE_LOADED; });
+
+        std::vector<AsyncLoad*>::iterator it = std::find(mLoadedAsyncLoads.begin(), mLoadedAsyncLoads.end(), load.get());
+        if (it != mLoadedAsyncLoads.end())
+            mLoadedAsyncLoads.erase(it);
+
+        removeLoadAsync_(load.get());
+    }
+
+    completeLoadAsync_(load);
+}
+
+void FileDeviceMgr::calcLoadAsync()
+{
+    // Keep the loads alive while their callbacks run
+    std::vector<AsyncLoadHandle> loads;
+    {
+        std::lock_guard<std::mutex> lock(mAsyncLoadCS);
+
+        if (mLoadedAsyncLoads.empty())
+            return;
+
+        loads.reserve(mLoadedAsyncLoads.size());
+        for (AsyncLoad* load : mLoadedAsyncLoads)
+        {
+            loads.push_back(load->mSelf);
+            removeLoadAsync_(load);
+        }
+
+        mLoadedAsyncLoads.clear();
+    }
 
-    arg.read_size = arg_.read_size;
-    arg.roundup_size = arg_.roundup_size;
-    arg.need_unload = arg_.need_unload;
+    for (const AsyncLoadHandle& load : loads)
+        completeLoadAsync_(load);
+}
+
+void FileDeviceMgr::completeLoadAsync_(const AsyncLoadHandle& load)
+{
+    // Already completed by waitLoadAsync() (From a previous callback)
+    if (load->getState() != AsyncLoad::STATE_LOADED)
+        return;
+
+    load->mSelf.reset();
+    load->mState.store(AsyncLoad::STATE_DONE, std::memory_order_release);
+
+    if (load->mCallback)
+        (*load->mCallback)(*load, load->mUserData);
+}
+
+void FileDeviceMgr::removeLoadAsync_(AsyncLoad* load)
+{
+    // mAsyncLoadCS must be locked
+    std::vector<AsyncLoad*>::iterator it = std::find(mAsyncLoads.begin(), mAsyncLoads.end(), load);
+    if (it != mAsyncLoads.end())
+    {
+        *it = mAsyncLoads.back();
+        mAsyncLoads.pop_back();
+    }
+}
+
+u32 FileDeviceMgr::getLoadAsyncNum() const
+{
+    std::lock_guard<std::mutex> lock(mAsyncLoadCS);
+    return mAsyncLoads.size();
+}
+
+bool FileDeviceMgr::getStats(std::string_view drive, FileDeviceStats::Op op, FileDeviceStats::OpStats* stats) const
+{
+    FileDevice* device = findDevice(drive);
+    if (!device)
+        return false;
 
-    return ret;
+    device->getStats().get(op, stats);
+    return true;
+}
+
+void FileDeviceMgr::getStatsJson(std::string* json) const
+{
+    RIO_ASSERT(json);
+
+    char buf[32];
+
+    json->append("{\"bucket_min_ns\":[");
+    for (u32 i = 0; i < FileDeviceStats::cBucketNum; i++)
+    {
+        std::snprintf(buf, sizeof(buf), "%s%llu", i > 0 ? "," : "", (unsigned long long)FileDeviceStats::getBucketMinNs(i));
+        json->append(buf);
+    }
+    json->append("],\"devices\":{");
+
+    for (FileDeviceMgr::DeviceList::iterator it = mDeviceList.begin(); it != mDeviceList.end(); ++it)
+    {
+        if (it != mDeviceList.begin())
+            json->append(1, ',');
+
+        json->append(1, '"');
+        for (char c : (*it)->getDriveName())
+        {
+            if (c == '"' || c == '\\')
+                json->append(1, '\\');
+
+            json->append(1, c);
+        }
+        json->append("\":");
+
+        (*it)->getStats().appendJson(json);
+    }
+
+    json->append("}}\n");
+}
+
+bool FileDeviceMgr::dumpStatsJson(const std::string& path)
+{
+    std::string json;
+    getStatsJson(&json);
+
+    FileHandle handle;
+    if (!tryOpen(&handle, path, FileDevice::FILE_OPEN_FLAG_CREATE))
+    {
+        RIO_LOG("FileDeviceMgr::dumpStatsJson(): Could not open \"%s\".\n", path.c_str());
+        return false;
+    }
+
+    u32 write_size = 0;
+    if (!handle.tryWrite(&write_size, reinterpret_cast<const u8*>(json.data()), json.length()) || write_size != json.length())
+    {
+        RIO_LOG("FileDeviceMgr::dumpStatsJson(): Could not write \"%s\".\n", path.c_str());
+        return false;
+    }
+
+    return handle.tryClose();
+}
+
+void FileDeviceMgr::printStats() const
+{
+    for (FileDeviceMgr::DeviceList::iterator it = mDeviceList.begin(); it != mDeviceList.end(); ++it)
+    {
+        const FileDevice* device = *it;
+        RIO_LOG("FileDevice \"%s\":\n", device->getDriveName().c_str());
+
+        for (u32 op = 0; op < FileDeviceStats::OP_NUM; op++)
+        {
+            FileDeviceStats::OpStats stats;
+            device->getStats().get(FileDeviceStats::Op(op), &stats);
+            if (stats.call_num == 0)
+                continue;
+
+            RIO_LOG("  %s: %llu call(s) (%llu failed), %llu byte(s), avg %.1f us, max %.1f us\n",
+                    FileDeviceStats::getOpName(FileDeviceStats::Op(op)),
+                    (unsigned long long)stats.call_num, (unsigned long long)stats.error_num, (unsigned long long)stats.size,
+                    f64(stats.total_ns) / f64(stats.call_num) / 1000.0, f64(stats.max_ns) / 1000.0);
+        }
+    }
+}
+
+void FileDeviceMgr::resetStats()
+{
+    for (FileDeviceMgr::DeviceList::iterator it = mDeviceList.begin(); it != mDeviceList.end(); ++it)
+        (*it)->resetStats();
 }
 
 }
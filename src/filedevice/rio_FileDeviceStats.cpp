@@ -0,0 +1,147 @@
+#include <filedevice/rio_FileDeviceStats.h>
+
+#include <cstdio>
+
+namespace rio {
+
+FileDeviceStats::FileDeviceStats()
+{
+    reset();
+}
+
+void FileDeviceStats::record(Op op, u64 begin_ns, u64 size, bool success)
+{
+    RIO_ASSERT(op < OP_NUM);
+
+    const u64 end_ns = now();
+    const u64 ns = end_ns > begin_ns ? end_ns - begin_ns : 0;
+
+    Counters& counters = mCounters[op];
+
+    counters.call_num.fetch_add(1, std::memory_order_relaxed);
+    if (!success)
+        counters.error_num.fetch_add(1, std::memory_order_relaxed);
+
+    if (size > 0)
+        counters.size.fetch_add(size, std::memory_order_relaxed);
+
+    counters.total_ns.fetch_add(ns, std::memory_order_relaxed);
+    counters.buckets[getBucket(ns)].fetch_add(1, std::memory_order_relaxed);
+
+    u64 max_ns = counters.max_ns.load(std::memory_order_relaxed);
+    while (ns > max_ns && !counters.max_ns.compare_exchange_weak(max_ns, ns, std::memory_order_relaxed))
+        ;
+}
+
+void FileDeviceStats::get(Op op, OpStats* stats) const
+{
+    RIO_ASSERT(op < OP_NUM);
+    RIO_ASSERT(stats);
+
+    const Counters& counters = mCounters[op];
+
+    stats->call_num = counters.call_num.load(std::memory_order_relaxed);
+    stats->error_num = counters.error_num.load(std::memory_order_relaxed);
+    stats->size = counters.size.load(std::memory_order_relaxed);
+    stats->total_ns = counters.total_ns.load(std::memory_order_relaxed);
+    stats->max_ns = counters.max_ns.load(std::memory_order_relaxed);
+
+    for (u32 i = 0; i < cBucketNum; i++)
+        stats->buckets[i] = counters.buckets[i].load(std::memory_order_relaxed);
+}
+
+void FileDeviceStats::reset()
+{
+    for (Counters& counters : mCounters)
+    {
+        counters.call_num.store(0, std::memory_order_relaxed);
+        counters.error_num.store(0, std::memory_order_relaxed);
+        counters.size.store(0, std::memory_order_relaxed);
+        counters.total_ns.store(0, std::memory_order_relaxed);
+        counters.max_ns.store(0, std::memory_order_relaxed);
+
+        for (std::atomic<u64>& bucket : counters.buckets)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void FileDeviceStats::appendJson(std::string* json) const
+{
+    RIO_ASSERT(json);
+
+    char buf[64];
+
+    json->append(1, '{');
+
+    for (u32 op = 0; op < OP_NUM; op++)
+    {
+        OpStats stats;
+        get(Op(op), &stats);
+
+        std::snprintf(buf, sizeof(buf), "%s\"%s\":{", op > 0 ? "," : "", getOpName(Op(op)));
+        json->append(buf);
+
+        std::snprintf(buf, sizeof(buf), "\"calls\":%llu,", (unsigned long long)stats.call_num);
+        json->append(buf);
+        std::snprintf(buf, sizeof(buf), "\"errors\":%llu,", (unsigned long long)stats.error_num);
+        json->append(buf);
+        std::snprintf(buf, sizeof(buf), "\"bytes\":%llu,", (unsigned long long)stats.size);
+        json->append(buf);
+        std::snprintf(buf, sizeof(buf), "\"total_ns\":%llu,", (unsigned long long)stats.total_ns);
+        json->append(buf);
+        std::snprintf(buf, sizeof(buf), "\"max_ns\":%llu,", (unsigned long long)stats.max_ns);
+        json->append(buf);
+
+        // Trailing empty buckets are omitted
+        u32 bucket_num = cBucketNum;
+        while (bucket_num > 0 && stats.buckets[bucket_num - 1] == 0)
+            bucket_num--;
+
+        json->append("\"histogram\":[");
+        for (u32 i = 0; i < bucket_num; i++)
+        {
+            std::snprintf(buf, sizeof(buf), "%s%llu", i > 0 ? "," : "", (unsigned long long)stats.buckets[i]);
+            json->append(buf);
+        }
+        json->append("]}");
+    }
+
+    json->append(1, '}');
+}
+
+u32 FileDeviceStats::getBucket(u64 ns)
+{
+    const u64 us = ns >> 10;
+    if (us == 0)
+        return 0;
+
+    // Bit width of us
+    const u32 bucket = 64 - __builtin_clzll(us);
+    return bucket < cBucketNum ? bucket : cBucketNum - 1;
+}
+
+u64 FileDeviceStats::getBucketMinNs(u32 bucket)
+{
+    RIO_ASSERT(bucket < cBucketNum);
+
+    if (bucket == 0)
+        return 0;
+
+    return u64(1) << (bucket + 9);
+}
+
+const char* FileDeviceStats::getOpName(Op op)
+{
+    switch (op)
+    {
+    case OP_OPEN:           return "open";
+    case OP_READ:           return "read";
+    case OP_WRITE:          return "write";
+    case OP_SEEK:           return "seek";
+    case OP_LOAD:           return "load";
+    case OP_LOAD_MULTIPLE:  return "load_multiple";
+    default:                return "";
+    }
+}
+
+}
@@ -0,0 +1,45 @@
+#include <filedevice/rio_LoadBatch.h>
+
+namespace rio {
+
+LoadBatch::LoadBatch()
+    : mArena(nullptr)
+    , mArenaSize(0)
+{
+}
+
+LoadBatch::~LoadBatch()
+{
+    unload();
+}
+
+u32 LoadBatch::add(const std::string& path, u32 alignment)
+{
+    RIO_ASSERT(!isLoaded());
+    RIO_ASSERT(!path.empty());
+
+    File file;
+    file.path = path;
+    file.alignment = alignment > 0 ? alignment : 1;
+    file.data = nullptr;
+    file.size = 0;
+
+    RIO_ASSERT(((file.alignment - 1) & file.alignment) == 0);
+
+    mFiles.push_back(file);
+    return mFiles.size() - 1;
+}
+
+void LoadBatch::unload()
+{
+    if (mArena)
+    {
+        MemUtil::free(mArena);
+        mArena = nullptr;
+    }
+
+    mArenaSize = 0;
+    mFiles.clear();
+}
+
+}
@@ -0,0 +1,11 @@
+#include <filedevice/rio_MappedFileDevice.h>
+
+namespace rio {
+
+MappedFileDevice::MappedFileDevice(const std::string& drive_name, const std::string& root)
+    : NativeFileDevice(drive_name)
+    , mRoot(root)
+{
+}
+
+}
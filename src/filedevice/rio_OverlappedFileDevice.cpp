@@ -0,0 +1,14 @@
+#include <filedevice/rio_OverlappedFileDevice.h>
+
+namespace rio {
+
+OverlappedFileDevice::OverlappedFileDevice(const std::string& drive_name, const std::string& root,
+                                           u32 queue_depth, bool unbuffered)
+    : NativeFileDevice(drive_name)
+    , mRoot(root)
+    , mQueueDepth(queue_depth > 0 ? queue_depth : 1)
+    , mUnbuffered(unbuffered)
+{
+}
+
+}
@@ -0,0 +1,298 @@
+#include <filedevice/rio_FileDeviceMgr.h>
+#include <filedevice/rio_OverlayFileDevice.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace rio {
+
+OverlayFileDevice::OverlayFileDevice(const std::string& drive_name)
+    : FileDevice(drive_name)
+    , mCacheGeneration(0)
+    , mCacheEpoch(0)
+    , mLastRawError(RAW_ERROR_OK)
+{
+}
+
+void OverlayFileDevice::pushLayer(FileDevice* device)
+{
+    RIO_ASSERT(device);
+    RIO_ASSERT(device != this);
+
+    mLayers.insert(mLayers.begin(), device);
+    clearCache();
+}
+
+bool OverlayFileDevice::removeLayer(FileDevice* device)
+{
+    std::vector<FileDevice*>::iterator it = std::find(mLayers.begin(), mLayers.end(), device);
+    if (it == mLayers.end())
+        return false;
+
+    mLayers.erase(it);
+    clearCache();
+    return true;
+}
+
+void OverlayFileDevice::clearLayers()
+{
+    mLayers.clear();
+    clearCache();
+}
+
+FileDevice* OverlayFileDevice::findLayer(std::string_view path)
+{
+    const s32 index = findLayerIndex_(path);
+    if (index == cLayerNone)
+        return nullptr;
+
+    return mLayers[index];
+}
+
+void OverlayFileDevice::clearCache()
+{
+    std::lock_guard<std::mutex> lock(mCacheCS);
+    clearCache_();
+}
+
+u32 OverlayFileDevice::getCacheSize() const
+{
+    std::lock_guard<std::mutex> lock(mCacheCS);
+    return mCache.size();
+}
+
+void OverlayFileDevice::clearCache_()
+{
+    mCache.clear();
+    mCachePaths.clear();
+    mCacheEpoch++;
+}
+
+u32 OverlayFileDevice::getMountGeneration_()
+{
+    FileDeviceMgr* mgr = FileDeviceMgr::instance();
+    if (!mgr)
+        return 0;
+
+    return mgr->getMountGeneration();
+}
+
+s32 OverlayFileDevice::findLayerIndex_(std::string_view path)
+{
+    const u32 generation = getMountGeneration_();
+    u32 epoch;
+
+    {
+        std::lock_guard<std::mutex> lock(mCacheCS);
+
+        if (mCacheGeneration != generation)
+        {
+            clearCache_();
+            mCacheGeneration = generation;
+        }
+
+        epoch = mCacheEpoch;
+
+        std::unordered_map<std::string_view, s32>::const_iterator it = mCache.find(path);
+        if (it != mCache.end())
+            return it->second;
+    }
+
+    // Not locked while looking the file up, so that lookups on other threads are not blocked by the file system
+    s32 index = cLayerNone;
+    for (u32 i = 0; i < mLayers.size(); i++)
+    {
+        bool is_exist = false;
+        if (mLayers[i]->tryIsExistFile(&is_exist, path) && is_exist)
+        {
+            index = i;
+            break;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mCacheCS);
+
+        // Not cached if the cache was dropped in the meantime (By a mount, a change of layers or clearCache())
+        if (mCacheEpoch == epoch && mCache.find(path) == mCache.end())
+        {
+            mCachePaths.emplace_back(path);
+            mCache.emplace(mCachePaths.back(), index);
+        }
+    }
+
+    return index;
+}
+
+u8* OverlayFileDevice::doLoad_(LoadArg& arg)
+{
+    const s32 index = findLayerIndex_(arg.path);
+    if (index == cLayerNone)
+    {
+        mLastRawError = RAW_ERROR_NOT_FOUND;
+        return nullptr;
+    }
+
+    FileDevice* layer = mLayers[index];
+
+    u8* data = layer->tryLoad(arg);
+    mLastRawError = data ? RAW_ERROR_OK : layer->getLastRawError();
+    return data;
+}
+
+void OverlayFileDevice::doLoadMultiple_(LoadArg* args, u8** data, u32 num)
+{
+    std::vector<s32> indices(num);
+    bool found_all = true;
+
+    for (u32 i = 0; i < num; i++)
+    {
+        indices[i] = findLayerIndex_(args[i].path);
+        data[i] = nullptr;
+
+        if (indices[i] == cLayerNone)
+            found_all = false;
+    }
+
+    // Each layer loads its files in a single batch
+    std::vector<LoadArg> layer_args;
+    std::vector<u8*> layer_data;
+    std::vector<u32> layer_indices;
+
+    for (u32 layer = 0; layer < mLayers.size(); layer++)
+    {
+        layer_indices.clear();
+        for (u32 i = 0; i < num; i++)
+            if (indices[i] == s32(layer))
+                layer_indices.push_back(i);
+
+        if (layer_indices.empty())
+            continue;
+
+        const u32 layer_num = layer_indices.size();
+        layer_args.resize(layer_num);
+        layer_data.resize(layer_num);
+
+        // Swapped in and out rather than copied, so that paths are not copied
+        for (u32 j = 0; j < layer_num; j++)
+            std::swap(layer_args[j], args[layer_indices[j]]);
+
+        mLayers[layer]->tryLoadMultiple(layer_args.data(), layer_data.data(), layer_num);
+
+        for (u32 j = 0; j < layer_num; j++)
+        {
+            std::swap(layer_args[j], args[layer_indices[j]]);
+            data[layer_indices[j]] = layer_data[j];
+        }
+    }
+
+    mLastRawError = found_all ? RAW_ERROR_OK : RAW_ERROR_NOT_FOUND;
+}
+
+FileDevice* OverlayFileDevice::doOpen_(FileHandle* handle, std::string_view filename, FileOpenFlag flag)
+{
+    s32 index = findLayerIndex_(filename);
+    if (index == cLayerNone)
+    {
+        // New files are created on the top layer
+        if (flag == FILE_OPEN_FLAG_READ || mLayers.empty())
+        {
+            mLastRawError = RAW_ERROR_NOT_FOUND;
+            return nullptr;
+        }
+
+        index = 0;
+    }
+
+    FileDevice* layer = mLayers[index];
+
+    // The handle belongs to the layer from now on
+    FileDevice* device = layer->tryOpen(handle, filename, flag);
+    if (!device)
+    {
+        mLastRawError = layer->getLastRawError();
+        return nullptr;
+    }
+
+    // The file may have been created
+    if (flag != FILE_OPEN_FLAG_READ)
+        clearCache();
+
+    mLastRawError = RAW_ERROR_OK;
+    return device;
+}
+
+// Handles are opened on the layers, which then get every call on them
+
+bool OverlayFileDevice::doClose_(FileHandle*)
+{
+    RIO_ASSERT(false);
+    mLastRawError = RAW_ERROR_FATAL_ERROR;
+    return false;
+}
+
+bool OverlayFileDevice::doRead_(u32*, FileHandle*, u8*, u32)
+{
+    RIO_ASSERT(false);
+    mLastRawError = RAW_ERROR_FATAL_ERROR;
+    return false;
+}
+
+bool OverlayFileDevice::doWrite_(u32*, FileHandle*, const u8*, u32)
+{
+    RIO_ASSERT(false);
+    mLastRawError = RAW_ERROR_FATAL_ERROR;
+    return false;
+}
+
+bool OverlayFileDevice::doSeek_(FileHandle*, s32, SeekOrigin)
+{
+    RIO_ASSERT(false);
+    mLastRawError = RAW_ERROR_FATAL_ERROR;
+    return false;
+}
+
+bool OverlayFileDevice::doGetCurrentSeekPos_(u32*, FileHandle*)
+{
+    RIO_ASSERT(false);
+    mLastRawError = RAW_ERROR_FATAL_ERROR;
+    return false;
+}
+
+bool OverlayFileDevice::doGetFileSize_(u32*, FileHandle*)
+{
+    RIO_ASSERT(false);
+    mLastRawError = RAW_ERROR_FATAL_ERROR;
+    return false;
+}
+
+bool OverlayFileDevice::doGetFileSize_(u32* size, std::string_view path)
+{
+    const s32 index = findLayerIndex_(path);
+    if (index == cLayerNone)
+    {
+        mLastRawError = RAW_ERROR_NOT_FOUND;
+        return false;
+    }
+
+    FileDevice* layer = mLayers[index];
+
+    const bool success = layer->tryGetFileSize(size, path);
+    mLastRawError = success ? RAW_ERROR_OK : layer->getLastRawError();
+    return success;
+}
+
+bool OverlayFileDevice::doIsExistFile_(bool* is_exist, std::string_view path)
+{
+    *is_exist = findLayerIndex_(path) != cLayerNone;
+
+    mLastRawError = RAW_ERROR_OK;
+    return true;
+}
+
+RawErrorCode OverlayFileDevice::doGetLastRawError_() const
+{
+    return mLastRawError;
+}
+
+}
@@ -6,11 +6,11 @@ bool Path::getDriveName(std::string* dst, const std::string& src)
 {
     RIO_ASSERT(dst);
 
-    size_t index = src.find(':');
-    if (index == std::string::npos)
+    std::string_view drive;
+    if (!getDriveName(&drive, src))
         return false;
 
-    *dst = src.substr(0, index);
+    *dst = drive;
     return true;
 }
 
@@ -18,12 +18,28 @@ void Path::getPathExceptDrive(std::string* dst, const std::string& src)
 {
     RIO_ASSERT(dst);
 
+    *dst = getPathExceptDrive(std::string_view(src));
+}
+
+bool Path::getDriveName(std::string_view* dst, std::string_view src)
+{
+    RIO_ASSERT(dst);
+
+    size_t index = src.find(':');
+    if (index == std::string_view::npos)
+        return false;
+
+    *dst = src.substr(0, index);
+    return true;
+}
+
+std::string_view Path::getPathExceptDrive(std::string_view src)
+{
     size_t index = src.find("://");
-    if (index != std::string::npos)
-        *dst = src.substr(index + 3);
+    if (index != std::string_view::npos)
+        return src.substr(index + 3);
 
-    else
-        *dst = src;
+    return src;
 }
 
 }
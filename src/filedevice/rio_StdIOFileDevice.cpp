@@ -17,7 +17,7 @@ StdIOFileDevice::StdIOFileDevice(const std::string& drive_name, const std::strin
 
 FileDevice*
 StdIOFileDevice::doOpen_(
-    FileHandle* handle, const std::string& filename,
+    FileHandle* handle, std::string_view filename,
     FileDevice::FileOpenFlag flag
 )
 {
@@ -42,10 +42,15 @@ StdIOFileDevice::doOpen_(
         RIO_ASSERT(false);
     }
 
-    std::string file_path = getNativePath(filename);
+    char file_path[cNativePathMax];
+    if (!getNativePath(file_path, sizeof(file_path), filename))
+    {
+        mLastRawError = RAW_ERROR_ACCESS_ERROR;
+        return nullptr;
+    }
 
     errno = 0;
-    handle_inner->handle = (uintptr_t)std::fopen(file_path.c_str(), mode);
+    handle_inner->handle = (uintptr_t)std::fopen(file_path, mode);
     if (handle_inner->handle)
     {
         mLastRawError = RAW_ERROR_OK;
@@ -79,7 +84,7 @@ StdIOFileDevice::doOpen_(
             auto prev_errno = errno;
 
             struct stat st;
-            auto stat_ret = stat(file_path.c_str(), &st);
+            auto stat_ret = stat(file_path, &st);
 
             errno = prev_errno;
 
@@ -284,14 +289,19 @@ StdIOFileDevice::doGetCurrentSeekPos_(
 
 bool
 StdIOFileDevice::doGetFileSize_(
-    u32* size, const std::string& path
+    u32* size, std::string_view path
 )
 {
-    std::string file_path = getNativePath(path);
+    char file_path[cNativePathMax];
+    if (!getNativePath(file_path, sizeof(file_path), path))
+    {
+        mLastRawError = RAW_ERROR_ACCESS_ERROR;
+        return false;
+    }
 
     struct stat st;
     errno = 0;
-    if (stat(file_path.c_str(), &st) == 0)
+    if (stat(file_path, &st) == 0)
     {
         mLastRawError = RAW_ERROR_OK;
         *size = st.st_size;
@@ -348,14 +358,19 @@ StdIOFileDevice::doGetFileSize_(
 
 bool
 StdIOFileDevice::doIsExistFile_(
-    bool* is_exist, const std::string& path
+    bool* is_exist, std::string_view path
 )
 {
-    std::string file_path = getNativePath(path);
+    char file_path[cNativePathMax];
+    if (!getNativePath(file_path, sizeof(file_path), path))
+    {
+        mLastRawError = RAW_ERROR_ACCESS_ERROR;
+        return false;
+    }
 
     struct stat st;
     errno = 0;
-    if (stat(file_path.c_str(), &st) == 0)
+    if (stat(file_path, &st) == 0)
     {
         mLastRawError = RAW_ERROR_OK;
         *is_exist = !(st.st_mode & S_IFDIR) && (st.st_mode & S_IFREG);
@@ -0,0 +1,241 @@
+#include <filedevice/rio_FileDeviceMgr.h>
+#include <filedevice/rio_StreamReader.h>
+#include <thread/rio_WorkQueue.h>
+
+namespace {
+
+static inline u32 max(u32 x, u32 y)
+{
+    if (x >= y)
+        return x;
+
+    return y;
+}
+
+static inline u32 align(u32 x, u32 y)
+{
+    RIO_ASSERT(((y - 1) & y) == 0);
+    return (x + y - 1) & -y;
+}
+
+}
+
+namespace rio {
+
+StreamReader::StreamReader(u32 chunk_size, u32 chunk_num, AsyncLoad::Priority priority)
+    : mChunkSize(align(max(chunk_size, 1), FileDevice::cBufferMinAlignment))
+    , mChunkNum(max(chunk_num, 2))
+    , mPriority(priority)
+    , mBuffer(nullptr)
+    , mSlots(new Slot[mChunkNum])
+    , mFirstIndex(0)
+    , mReadyNum(0)
+    , mReadOffset(0)
+    , mAcquired(false)
+    , mReading(false)
+    , mReadEnd(false)
+    , mError(false)
+    , mClosing(false)
+{
+    RIO_ASSERT(chunk_num >= 2);
+}
+
+StreamReader::~StreamReader()
+{
+    close();
+
+    delete[] mSlots;
+}
+
+bool StreamReader::tryOpen(const std::string& path, u64 offset)
+{
+    close();
+
+    if (!FileDeviceMgr::instance()->tryOpen(&mHandle, path, FileDevice::FILE_OPEN_FLAG_READ))
+        return false;
+
+    if (!seekTo_(offset))
+    {
+        RIO_LOG("StreamReader::tryOpen(): Could not seek \"%s\" to %llu.\n", path.c_str(), (unsigned long long)offset);
+        mHandle.tryClose();
+        return false;
+    }
+
+    if (!mBuffer)
+    {
+        mBuffer = static_cast<u8*>(MemUtil::alloc(size_t(mChunkSize) * mChunkNum, FileDevice::cBufferMinAlignment));
+        if (!mBuffer)
+        {
+            RIO_LOG("StreamReader::tryOpen(): Could not allocate %u chunk(s) of 0x%X bytes.\n", mChunkNum, mChunkSize);
+            mHandle.tryClose();
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mCS);
+
+    mFirstIndex = 0;
+    mReadyNum = 0;
+    mReadOffset = offset;
+    mAcquired = false;
+    mReadEnd = false;
+    mError = false;
+    mClosing = false;
+
+    startRead_();
+    return true;
+}
+
+void StreamReader::close()
+{
+    {
+        std::unique_lock<std::mutex> lock(mCS);
+
+        mClosing = true;
+
+        // A read that has not started yet is dropped, one in progress is waited for
+        if (mReading)
+        {
+            WorkQueue* queue = FileDeviceMgr::instance()->peekLoadQueue_();
+            if (queue && queue->cancel(&StreamReader::readMain_, this))
+                mReading = false;
+            else
+                mCond.wait(lock, [this] { return !mReading; });
+        }
+
+        mFirstIndex = 0;
+        mReadyNum = 0;
+        mAcquired = false;
+    }
+
+    if (mHandle.isOpen())
+        mHandle.tryClose();
+
+    if (mBuffer)
+    {
+        MemUtil::free(mBuffer);
+        mBuffer = nullptr;
+    }
+}
+
+bool StreamReader::acquire(Chunk* chunk, bool wait)
+{
+    RIO_ASSERT(chunk);
+
+    std::unique_lock<std::mutex> lock(mCS);
+
+    if (mAcquired)
+    {
+        RIO_LOG("StreamReader::acquire(): The previous chunk has not been released.\n");
+        RIO_ASSERT(false);
+        return false;
+    }
+
+    if (wait)
+        mCond.wait(lock, [this] { return mReadyNum > 0 || !mReading; });
+
+    if (mReadyNum == 0)
+        return false;
+
+    const Slot& slot = mSlots[mFirstIndex];
+    chunk->data = mBuffer + size_t(mFirstIndex) * mChunkSize;
+    chunk->size = slot.size;
+    chunk->offset = slot.offset;
+
+    mAcquired = true;
+    return true;
+}
+
+void StreamReader::release()
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    if (!mAcquired)
+    {
+        RIO_LOG("StreamReader::release(): No chunk is acquired.\n");
+        RIO_ASSERT(false);
+        return;
+    }
+
+    mAcquired = false;
+    mFirstIndex = (mFirstIndex + 1) % mChunkNum;
+    mReadyNum--;
+
+    startRead_();
+}
+
+bool StreamReader::isEnd() const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+    return mReadEnd && mReadyNum == 0;
+}
+
+bool StreamReader::isError() const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+    return mError;
+}
+
+void StreamReader::startRead_()
+{
+    if (mReading || mReadEnd || mError || mClosing || mReadyNum == mChunkNum)
+        return;
+
+    mReading = true;
+    FileDeviceMgr::instance()->getLoadQueue_()->push(&StreamReader::readMain_, this, mPriority);
+}
+
+void StreamReader::readMain_(void* arg)
+{
+    StreamReader* reader = static_cast<StreamReader*>(arg);
+
+    u32 index;
+    u64 offset;
+    {
+        std::lock_guard<std::mutex> lock(reader->mCS);
+
+        index = (reader->mFirstIndex + reader->mReadyNum) % reader->mChunkNum;
+        offset = reader->mReadOffset;
+    }
+
+    // The slot is not used by the consumer until it is marked as read
+    u32 read_size = 0;
+    const bool success = reader->mHandle.tryRead(&read_size, reader->mBuffer + size_t(index) * reader->mChunkSize, reader->mChunkSize);
+
+    {
+        std::lock_guard<std::mutex> lock(reader->mCS);
+
+        reader->mReading = false;
+
+        if (!success)
+        {
+            reader->mError = true;
+        }
+        else
+        {
+            if (read_size > 0)
+            {
+                reader->mSlots[index].size = read_size;
+                reader->mSlots[index].offset = offset;
+                reader->mReadyNum++;
+                reader->mReadOffset = offset + read_size;
+            }
+
+            if (read_size < reader->mChunkSize)
+                reader->mReadEnd = true;
+        }
+
+        reader->startRead_();
+        reader->mCond.notify_all();
+    }
+}
+
+bool StreamReader::seekTo_(u64 offset)
+{
+    if (offset > 0x7FFFFFFF)
+        return false;
+
+    return mHandle.trySeek(s32(offset), FileDevice::SEEK_ORIGIN_BEGIN);
+}
+
+}
@@ -0,0 +1,121 @@
+#include <misc/rio_Types.h>
+
+#if RIO_IS_WIN
+
+#include <filedevice/rio_Decompressor.h>
+#include <filedevice/rio_MappedFileDevice.h>
+
+#include <misc/win/rio_Windows.h>
+
+namespace {
+
+static u32 GetAllocationGranularity()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+}
+
+}
+
+namespace rio {
+
+u8* MappedFileDevice::doLoad_(LoadArg& arg)
+{
+    // Views are aligned to the allocation granularity (Usually 64 KiB)
+    static const u32 cViewAlignment = GetAllocationGranularity();
+
+    if (arg.buffer || arg.alignment > cViewAlignment)
+        return FileDevice::doLoad_(arg);
+
+    char file_path[cNativePathMax];
+    if (!getNativePath(file_path, sizeof(file_path), arg.path))
+    {
+        mLastRawError = RAW_ERROR_ACCESS_ERROR;
+        return nullptr;
+    }
+
+    HANDLE file = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        const DWORD error = GetLastError();
+        mLastRawError = (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND) ? RAW_ERROR_NOT_FOUND
+                      : (error == ERROR_ACCESS_DENIED)                                   ? RAW_ERROR_PERMISSION_ERROR
+                                                                                         : RAW_ERROR_ACCESS_ERROR;
+        return nullptr;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size))
+    {
+        CloseHandle(file);
+        mLastRawError = RAW_ERROR_ACCESS_ERROR;
+        return nullptr;
+    }
+
+    if (file_size.QuadPart == 0)
+    {
+        // Same as FileDevice::doLoad_()
+        CloseHandle(file);
+        RIO_ASSERT(false);
+        return nullptr;
+    }
+
+    if (file_size.QuadPart > 0xFFFFFFFF)
+    {
+        CloseHandle(file);
+        mLastRawError = RAW_ERROR_FILE_TOO_BIG;
+        return nullptr;
+    }
+
+    // Copy-on-write, so that callers may modify the data in place (e.g., relocating a resource)
+    // without affecting the file
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (!mapping)
+    {
+        mLastRawError = RAW_ERROR_ACCESS_ERROR;
+        return nullptr;
+    }
+
+    u8* data = static_cast<u8*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+
+    // The view keeps the mapping alive
+    CloseHandle(mapping);
+
+    if (!data)
+    {
+        mLastRawError = RAW_ERROR_ACCESS_ERROR;
+        return nullptr;
+    }
+
+    mLastRawError = RAW_ERROR_OK;
+
+    if (Decompressor::isCompressed(data, u32(file_size.QuadPart)))
+    {
+        // Decompressed straight from the view
+        u8* buffer = Decompressor::load(arg, data, u32(file_size.QuadPart));
+        unmap_(data);
+        return buffer;
+    }
+
+    registerUnload_(data, &MappedFileDevice::unmap_);
+
+    arg.read_size = u32(file_size.QuadPart);
+    arg.roundup_size = u32(file_size.QuadPart);
+    arg.need_unload = true;
+
+    return data;
+}
+
+void MappedFileDevice::unmap_(u8* data)
+{
+    [[maybe_unused]] const BOOL success = UnmapViewOfFile(data);
+    RIO_ASSERT(success);
+}
+
+}
+
+#endif // RIO_IS_WIN
@@ -0,0 +1,493 @@
+#include <misc/rio_Types.h>
+
+#if RIO_IS_WIN
+
+#include <filedevice/rio_Decompressor.h>
+#include <filedevice/rio_OverlappedFileDevice.h>
+
+#include <misc/win/rio_Windows.h>
+
+#include <vector>
+
+namespace {
+
+static inline u32 max(u32 x, u32 y)
+{
+    if (x >= y)
+        return x;
+
+    return y;
+}
+
+static inline u32 min(u32 x, u32 y)
+{
+    if (x <= y)
+        return x;
+
+    return y;
+}
+
+static inline u32 align(u32 x, u32 y)
+{
+    RIO_ASSERT(((y - 1) & y) == 0);
+    return (x + y - 1) & -y;
+}
+
+static u32 GetAllocationGranularity()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+}
+
+static rio::RawErrorCode GetRawError(DWORD error)
+{
+    switch (error)
+    {
+    case ERROR_FILE_NOT_FOUND:
+    case ERROR_PATH_NOT_FOUND:
+        return rio::RAW_ERROR_NOT_FOUND;
+    case ERROR_ACCESS_DENIED:
+        return rio::RAW_ERROR_PERMISSION_ERROR;
+    default:
+        return rio::RAW_ERROR_ACCESS_ERROR;
+    }
+}
+
+}
+
+namespace rio {
+
+class OverlappedFileDevice::Batch
+{
+public:
+    Batch(OverlappedFileDevice* device, HANDLE port, LoadArg* args, u8** data, u32 num);
+    ~Batch();
+
+    // Load every file of the batch
+    void run();
+
+private:
+    struct File
+    {
+        HANDLE      handle;
+        u8*         buffer;
+        u32         size;
+        u32         buffer_size;
+        u32         read_pos;       // Position of the next read to issue
+        u32         read_size;      // Bytes read so far
+        u32         pending_num;    // Reads in flight
+        bool        unbuffered;
+        bool        need_unload;
+        bool        failed;
+    };
+
+    struct Read
+    {
+        OVERLAPPED  overlapped;     // First member, completions give back its address
+        u32         index;          // Of the file
+    };
+
+    // Open the file at "index" and allocate its buffer, returns false if it is not to be read by the batch
+    bool open_(u32 index);
+    // Issue the next read of the file at "index", returns false if it failed
+    bool issue_(u32 index, Read* read);
+    // Close the file at "index", whose reads have all completed, and output its data
+    void finish_(u32 index);
+    // Release the buffer allocated for the file at "index"
+    void freeBuffer_(u32 index);
+
+private:
+    OverlappedFileDevice*   mDevice;
+    HANDLE                  mPort;
+    LoadArg*                mArgs;
+    u8**                    mData;
+    u32                     mNum;
+    std::vector<File>       mFiles;
+    std::vector<Read>       mReads;
+    std::vector<Read*>      mFreeReads;
+};
+
+OverlappedFileDevice::Batch::Batch(OverlappedFileDevice* device, HANDLE port, LoadArg* args, u8** data, u32 num)
+    : mDevice(device)
+    , mPort(port)
+    , mArgs(args)
+    , mData(data)
+    , mNum(num)
+    , mFiles(num)
+    , mReads(device->mQueueDepth)
+{
+    mFreeReads.reserve(mReads.size());
+    for (Read& read : mReads)
+        mFreeReads.push_back(&read);
+}
+
+OverlappedFileDevice::Batch::~Batch()
+{
+    CloseHandle(mPort);
+}
+
+void OverlappedFileDevice::Batch::run()
+{
+    u32 next_index = 0;     // Next file to open
+    u32 issue_index = mNum; // File whose reads are being issued
+    u32 pending_num = 0;
+
+    for (;;)
+    {
+        // Fill the queue, issuing all reads of a file before opening the next one
+        while (!mFreeReads.empty())
+        {
+            if (issue_index < mNum)
+            {
+                const File& file = mFiles[issue_index];
+                if (!file.failed && file.read_pos < file.size)
+                {
+                    Read* read = mFreeReads.back();
+                    mFreeReads.pop_back();
+
+                    if (issue_(issue_index, read))
+                        pending_num++;
+                    else if (file.pending_num == 0)
+                        finish_(issue_index);
+
+                    continue;
+                }
+            }
+
+            if (next_index == mNum)
+                break;
+
+            issue_index = next_index++;
+            if (!open_(issue_index))
+                issue_index = mNum;
+        }
+
+        if (pending_num == 0)
+            break;
+
+        DWORD transferred = 0;
+        ULONG_PTR key = 0;
+        OVERLAPPED* overlapped = nullptr;
+
+        const BOOL success = GetQueuedCompletionStatus(mPort, &transferred, &key, &overlapped, INFINITE);
+        if (!overlapped)
+        {
+            // The port itself failed: the buffers of the files still being read cannot be released,
+            // since their reads may still complete
+            RIO_LOG("OverlappedFileDevice: GetQueuedCompletionStatus() failed (%lu).\n", GetLastError());
+            RIO_ASSERT(false);
+
+            for (u32 i = 0; i < mNum; i++)
+            {
+                if (mFiles[i].pending_num > 0)
+                {
+                    CloseHandle(mFiles[i].handle);
+                    mData[i] = nullptr;
+                }
+            }
+
+            return;
+        }
+
+        Read* read = reinterpret_cast<Read*>(overlapped);
+        File& file = mFiles[read->index];
+
+        if (success)
+        {
+            file.read_size += transferred;
+        }
+        else
+        {
+            mDevice->mLastRawError = GetRawError(GetLastError());
+            file.failed = true;
+        }
+
+        mFreeReads.push_back(read);
+        pending_num--;
+
+        if (--file.pending_num == 0 && (file.failed || file.read_pos >= file.size))
+            finish_(read->index);
+    }
+}
+
+bool OverlappedFileDevice::Batch::open_(u32 index)
+{
+    LoadArg& arg = mArgs[index];
+    File& file = mFiles[index];
+
+    file.handle = INVALID_HANDLE_VALUE;
+    file.buffer = nullptr;
+    file.size = 0;
+    file.buffer_size = 0;
+    file.read_pos = 0;
+    file.read_size = 0;
+    file.pending_num = 0;
+    file.unbuffered = mDevice->mUnbuffered;
+    file.need_unload = false;
+    file.failed = false;
+
+    mData[index] = nullptr;
+
+    if (arg.buffer && arg.buffer_size == 0)
+    {
+        RIO_LOG("OverlappedFileDevice: arg.buffer is specified, but arg.buffer_size is zero.\n");
+        return false;
+    }
+
+    // Buffers for unbuffered reads are allocated with VirtualAlloc(), aligned to the allocation granularity
+    // (Usually 64 KiB), so that large reads do not take space in the heaps
+    static const u32 cVirtualAllocAlignment = GetAllocationGranularity();
+
+    // Unbuffered reads must go to a buffer that is aligned, and large enough for the last read to be rounded up
+    if (file.unbuffered && (arg.buffer ? uintptr_t(arg.buffer) % cUnbufferedAlignment != 0
+                                       : arg.alignment > cVirtualAllocAlignment))
+        file.unbuffered = false;
+
+    char file_path[cNativePathMax];
+    if (!mDevice->getNativePath(file_path, sizeof(file_path), arg.path))
+    {
+        mDevice->mLastRawError = RAW_ERROR_ACCESS_ERROR;
+        return false;
+    }
+
+    const DWORD flags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN;
+
+    for (;;)
+    {
+        file.handle = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  file.unbuffered ? (flags | FILE_FLAG_NO_BUFFERING) : flags, nullptr);
+        if (file.handle == INVALID_HANDLE_VALUE)
+        {
+            mDevice->mLastRawError = GetRawError(GetLastError());
+            return false;
+        }
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file.handle, &file_size))
+        {
+            CloseHandle(file.handle);
+            mDevice->mLastRawError = RAW_ERROR_ACCESS_ERROR;
+            return false;
+        }
+
+        if (file_size.QuadPart == 0)
+        {
+            // Same as FileDevice::doLoad_()
+            CloseHandle(file.handle);
+            RIO_ASSERT(false);
+            return false;
+        }
+
+        if (file_size.QuadPart > 0xFFFFFFFF)
+        {
+            CloseHandle(file.handle);
+            mDevice->mLastRawError = RAW_ERROR_FILE_TOO_BIG;
+            return false;
+        }
+
+        file.size = u32(file_size.QuadPart);
+
+        if (file.unbuffered && arg.buffer && (file.size > 0xFFFFFFFF - cUnbufferedAlignment + 1 ||
+                                              arg.buffer_size < align(file.size, cUnbufferedAlignment)))
+        {
+            // Read through the cache instead
+            CloseHandle(file.handle);
+            file.unbuffered = false;
+            continue;
+        }
+
+        break;
+    }
+
+    if (!CreateIoCompletionPort(file.handle, mPort, ULONG_PTR(index), 0))
+    {
+        // Read as usual
+        CloseHandle(file.handle);
+        mData[index] = mDevice->FileDevice::doLoad_(arg);
+        return false;
+    }
+
+    if (arg.buffer)
+    {
+        if (arg.buffer_size < file.size)
+        {
+            RIO_LOG("OverlappedFileDevice: arg.buffer_size[%u] is smaller than file size[%u].\n", arg.buffer_size, file.size);
+            CloseHandle(file.handle);
+            return false;
+        }
+
+        file.buffer = arg.buffer;
+        file.buffer_size = arg.buffer_size;
+    }
+    else if (file.unbuffered)
+    {
+        file.buffer_size = align(file.size, cUnbufferedAlignment);
+        if (file.buffer_size < file.size)
+        {
+            CloseHandle(file.handle);
+            mDevice->mLastRawError = RAW_ERROR_FILE_TOO_BIG;
+            return false;
+        }
+
+        file.buffer = static_cast<u8*>(VirtualAlloc(nullptr, file.buffer_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+        if (!file.buffer)
+        {
+            CloseHandle(file.handle);
+            mDevice->mLastRawError = RAW_ERROR_FATAL_ERROR;
+            return false;
+        }
+
+        file.need_unload = true;
+    }
+    else
+    {
+        file.buffer_size = align(file.size, FileDevice::cBufferMinAlignment);
+        file.buffer = static_cast<u8*>(MemUtil::alloc(file.buffer_size, align(max(arg.alignment, 1), FileDevice::cBufferMinAlignment)));
+        if (!file.buffer)
+        {
+            CloseHandle(file.handle);
+            mDevice->mLastRawError = RAW_ERROR_FATAL_ERROR;
+            return false;
+        }
+
+        file.need_unload = true;
+    }
+
+    return true;
+}
+
+bool OverlappedFileDevice::Batch::issue_(u32 index, Read* read)
+{
+    File& file = mFiles[index];
+
+    u32 size = min(file.size - file.read_pos, cReadSize);
+    if (file.unbuffered)
+        size = align(size, cUnbufferedAlignment);
+
+    ZeroMemory(&read->overlapped, sizeof(OVERLAPPED));
+    read->overlapped.Offset = file.read_pos;
+    read->index = index;
+
+    // A completion is queued even if the read completes right away
+    if (!ReadFile(file.handle, file.buffer + file.read_pos, size, nullptr, &read->overlapped) &&
+        GetLastError() != ERROR_IO_PENDING)
+    {
+        mDevice->mLastRawError = GetRawError(GetLastError());
+        file.failed = true;
+        mFreeReads.push_back(read);
+        return false;
+    }
+
+    file.read_pos += min(size, file.size - file.read_pos);
+    file.pending_num++;
+    return true;
+}
+
+void OverlappedFileDevice::Batch::finish_(u32 index)
+{
+    LoadArg& arg = mArgs[index];
+    File& file = mFiles[index];
+
+    CloseHandle(file.handle);
+    file.handle = INVALID_HANDLE_VALUE;
+
+    // The file changed while being read
+    if (!file.failed && file.read_size != file.size)
+    {
+        mDevice->mLastRawError = RAW_ERROR_ACCESS_ERROR;
+        file.failed = true;
+    }
+
+    if (file.failed)
+    {
+        freeBuffer_(index);
+        mData[index] = nullptr;
+        return;
+    }
+
+    mDevice->mLastRawError = RAW_ERROR_OK;
+
+    if (Decompressor::isCompressed(file.buffer, file.size))
+    {
+        if (file.need_unload)
+        {
+            mData[index] = Decompressor::load(arg, file.buffer, file.size);
+            freeBuffer_(index);
+        }
+        else
+        {
+            // The compressed data was read into the caller's buffer, which receives the decompressed data
+            u8* src = static_cast<u8*>(MemUtil::alloc(file.size, FileDevice::cBufferMinAlignment));
+            if (!src)
+            {
+                mDevice->mLastRawError = RAW_ERROR_FATAL_ERROR;
+                mData[index] = nullptr;
+                return;
+            }
+
+            MemUtil::copy(src, file.buffer, file.size);
+            mData[index] = Decompressor::load(arg, src, file.size);
+            MemUtil::free(src);
+        }
+
+        return;
+    }
+
+    if (file.unbuffered && file.need_unload)
+        registerUnload_(file.buffer, &OverlappedFileDevice::virtualFree_);
+
+    arg.read_size = file.size;
+    arg.roundup_size = file.buffer_size;
+    arg.need_unload = file.need_unload;
+
+    mData[index] = file.buffer;
+}
+
+void OverlappedFileDevice::Batch::freeBuffer_(u32 index)
+{
+    File& file = mFiles[index];
+    if (!file.need_unload)
+        return;
+
+    if (file.unbuffered)
+        virtualFree_(file.buffer);
+    else
+        MemUtil::free(file.buffer);
+
+    file.buffer = nullptr;
+    file.need_unload = false;
+}
+
+u8* OverlappedFileDevice::doLoad_(LoadArg& arg)
+{
+    u8* data = nullptr;
+    doLoadMultiple_(&arg, &data, 1);
+    return data;
+}
+
+void OverlappedFileDevice::virtualFree_(u8* data)
+{
+    [[maybe_unused]] const BOOL success = VirtualFree(data, 0, MEM_RELEASE);
+    RIO_ASSERT(success);
+}
+
+void OverlappedFileDevice::doLoadMultiple_(LoadArg* args, u8** data, u32 num)
+{
+    HANDLE port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+    if (!port)
+    {
+        // Read as usual
+        for (u32 i = 0; i < num; i++)
+            data[i] = FileDevice::doLoad_(args[i]);
+
+        return;
+    }
+
+    Batch batch(this, port, args, data, num);
+    batch.run();
+}
+
+}
+
+#endif // RIO_IS_WIN
@@ -385,6 +385,9 @@ bool Window::initialize_()
 
 bool Window::isRunning() const
 {
+    if (mIsNull)
+        return true;
+
     return mNativeWindow.mIsRunning;
 }
 
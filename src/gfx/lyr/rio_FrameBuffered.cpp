@@ -0,0 +1,45 @@
+#include <gfx/lyr/rio_FrameBuffered.h>
+
+#include <mutex>
+
+namespace {
+
+// Instances can be created on any thread (e.g., by asynchronous ITask::prepare_())
+static std::mutex sListCS;
+
+// Function-local, as instances can be static objects of other translation units
+static rio::lyr::IFrameBuffered::List& GetList()
+{
+    static rio::lyr::IFrameBuffered::List sList;
+    return sList;
+}
+
+}
+
+namespace rio { namespace lyr {
+
+bool IFrameBuffered::sPipelined = false;
+
+IFrameBuffered::IFrameBuffered()
+    : mListNode(this)
+{
+    std::lock_guard<std::mutex> lock(sListCS);
+    GetList().pushBack(&mListNode);
+}
+
+IFrameBuffered::~IFrameBuffered()
+{
+    std::lock_guard<std::mutex> lock(sListCS);
+    mListNode.erase();
+}
+
+void IFrameBuffered::publishAll_()
+{
+    std::lock_guard<std::mutex> lock(sListCS);
+
+    List& list = GetList();
+    for (List::iterator it = list.begin(); it != list.end(); ++it)
+        (*it)->publish_();
+}
+
+} }
@@ -4,6 +4,8 @@
 #include <gfx/rio_Window.h>
 #include <math/rio_Matrix.h>
 
+#include <algorithm>
+
 namespace {
 
 class IdentityCamera : public rio::Camera
@@ -165,6 +167,11 @@ void Layer::resetScissor()
     mFlags.reset(FLAGS_SET_SCISSOR);
 }
 
+void RenderStep::insert_(const DrawMethod& draw_method)
+{
+    mDrawMethods.insert(std::upper_bound(mDrawMethods.begin(), mDrawMethods.end(), draw_method), draw_method);
+}
+
 void Layer::addRenderStep(const char* name)
 {
     mRenderSteps.emplace_back(name);
@@ -183,13 +190,13 @@ void Layer::addDrawMethod(u32 render_step_idx, const DrawMethod& draw_method)
         return;
     }
 
-    mRenderSteps[render_step_idx].mDrawMethods.insert(draw_method);
+    mRenderSteps[render_step_idx].insert_(draw_method);
 }
 
 void Layer::addDrawMethodToAll(const DrawMethod& draw_method)
 {
     for (RenderStep& render_step : mRenderSteps)
-        render_step.mDrawMethods.insert(draw_method);
+        render_step.insert_(draw_method);
 }
 
 void Layer::clearDrawMethods(u32 render_step_idx)
@@ -1,4 +1,6 @@
+#include <gfx/rio_Camera.h>
 #include <gfx/rio_Graphics.h>
+#include <gfx/rio_Projection.h>
 #include <gfx/rio_Window.h>
 #include <gfx/lyr/rio_Renderer.h>
 
@@ -25,15 +27,89 @@ void Renderer::destroySingleton()
 }
 
 Renderer::Renderer()
+    : mPipelined(false)
 {
 }
 
 Renderer::~Renderer()
 {
+    setPipelined(false);
     clearLayers();
 }
 
-void Renderer::render() const
+void Renderer::setPipelined(bool pipelined)
+{
+    mPipelined = pipelined;
+    IFrameBuffered::sPipelined = pipelined;
+
+    // Layers removed while pipelined are no longer rendered
+    if (!pipelined)
+        publish();
+}
+
+void Renderer::destroyLayer_(Layer* p_layer)
+{
+    if (mPipelined)
+        mDestroyedLayers.push_back(p_layer);
+
+    else
+        delete p_layer;
+}
+
+void Renderer::publish()
+{
+    mLayerStates.clear();
+    mDrawCalls.clear();
+
+    for (const Layer* p_layer : mLayers)
+    {
+        const Layer& layer = *p_layer;
+
+        LayerState state;
+        state.p_layer = p_layer;
+        state.clear_color = layer.mClearColor;
+        state.clear_depth = layer.mClearDepth;
+        state.clear_stencil = layer.mClearStencil;
+        state.viewport = layer.mViewport;
+        state.scissor = layer.mScissor;
+        state.flags = layer.mFlags;
+        layer.mpCamera->getMatrix(&state.view_mtx);
+        state.proj_mtx = layer.mpProjection->getMatrix();
+        state.draw_call_begin = mDrawCalls.size();
+
+        u32 render_step_idx = 0;
+
+        for (const RenderStep& render_step : layer.mRenderSteps)
+        {
+            for (const DrawMethod& draw_method : render_step.mDrawMethods)
+                mDrawCalls.push_back({ draw_method.mObjPtr, draw_method.mFuncPtr, render_step_idx });
+
+            render_step_idx++;
+        }
+
+        state.draw_call_end = mDrawCalls.size();
+        mLayerStates.push_back(state);
+    }
+
+    if (mPipelined)
+        IFrameBuffered::publishAll_();
+
+    // Nothing refers to removed layers anymore
+    for (Layer* p_layer : mDestroyedLayers)
+        delete p_layer;
+
+    mDestroyedLayers.clear();
+}
+
+void Renderer::render()
+{
+    if (!mPipelined)
+        publish();
+
+    render_();
+}
+
+void Renderer::render_() const
 {
     Window* const p_window = Window::instance();
 
@@ -43,25 +119,23 @@ void Renderer::render() const
     bool viewport_changed = false;
     bool scissor_changed = false;
 
-    for (const Layer* p_layer : mLayers)
+    for (const LayerState& state : mLayerStates)
     {
-        const Layer& layer = *p_layer;
-
-        if (layer.mFlags.isOn(Layer::FLAGS_CLEAR_COLOR_BUFFER))
-            p_window->clearColor(layer.mClearColor.r, layer.mClearColor.g, layer.mClearColor.b, layer.mClearColor.a);
+        if (state.flags.isOn(Layer::FLAGS_CLEAR_COLOR_BUFFER))
+            p_window->clearColor(state.clear_color.r, state.clear_color.g, state.clear_color.b, state.clear_color.a);
 
-        if (layer.mFlags.isOn(Layer::FLAGS_CLEAR_DEPTH_STENCIL_BUFFER))
-            p_window->clearDepthStencil(layer.mClearDepth, layer.mClearDepth);
+        if (state.flags.isOn(Layer::FLAGS_CLEAR_DEPTH_STENCIL_BUFFER))
+            p_window->clearDepthStencil(state.clear_depth, state.clear_stencil);
 
-        else if (layer.mFlags.isOn(Layer::FLAGS_CLEAR_DEPTH_BUFFER))
-            p_window->clearDepth(layer.mClearDepth);
+        else if (state.flags.isOn(Layer::FLAGS_CLEAR_DEPTH_BUFFER))
+            p_window->clearDepth(state.clear_depth);
 
-        else if (layer.mFlags.isOn(Layer::FLAGS_CLEAR_STENCIL_BUFFER))
-            p_window->clearStencil(layer.mClearDepth);
+        else if (state.flags.isOn(Layer::FLAGS_CLEAR_STENCIL_BUFFER))
+            p_window->clearStencil(state.clear_stencil);
 
-        if (layer.mFlags.isOn(Layer::FLAGS_SET_VIEWPORT))
+        if (state.flags.isOn(Layer::FLAGS_SET_VIEWPORT))
         {
-            Graphics::setViewport(layer.mViewport.x, layer.mViewport.y, layer.mViewport.width, layer.mViewport.height, layer.mViewport.near, layer.mViewport.far, layer.mViewport.frame_buffer_height);
+            Graphics::setViewport(state.viewport.x, state.viewport.y, state.viewport.width, state.viewport.height, state.viewport.near, state.viewport.far, state.viewport.frame_buffer_height);
             viewport_changed = true;
         }
         else if (viewport_changed)
@@ -69,9 +143,9 @@ void Renderer::render() const
             Graphics::setViewport(0, 0, p_window->getWidth(), p_window->getHeight());
         }
 
-        if (layer.mFlags.isOn(Layer::FLAGS_SET_SCISSOR))
+        if (state.flags.isOn(Layer::FLAGS_SET_SCISSOR))
         {
-            Graphics::setScissor(layer.mScissor.x, layer.mScissor.y, layer.mScissor.width, layer.mScissor.height, layer.mScissor.frame_buffer_height);
+            Graphics::setScissor(state.scissor.x, state.scissor.y, state.scissor.width, state.scissor.height, state.scissor.frame_buffer_height);
             scissor_changed = true;
         }
         else if (scissor_changed)
@@ -79,14 +153,12 @@ void Renderer::render() const
             Graphics::setScissor(0, 0, p_window->getWidth(), p_window->getHeight());
         }
 
-        u32 render_step_idx = 0;
+        const Layer& layer = *state.p_layer;
 
-        for (const RenderStep& render_step : layer.mRenderSteps)
+        for (u32 i = state.draw_call_begin; i < state.draw_call_end; i++)
         {
-            for (const DrawMethod& draw_method : render_step.mDrawMethods)
-                (draw_method.mObjPtr->*(draw_method.mFuncPtr))({ layer, render_step_idx });
-
-            render_step_idx++;
+            const DrawCall& draw_call = mDrawCalls[i];
+            (draw_call.p_obj->*(draw_call.p_func))({ layer, draw_call.render_step_idx, state.view_mtx, state.proj_mtx });
         }
     }
 }
@@ -2,6 +2,8 @@
 #include <gfx/mdl/res/rio_ModelCacher.h>
 #include <gfx/mdl/res/rio_ModelData.h>
 #include <gpu/rio_Drawer.h>
+#include <heap/rio_MemTracker.h>
+#include <misc/rio_ResourceCache.h>
 
 namespace rio { namespace mdl { namespace res {
 
@@ -31,18 +33,29 @@ ModelCacher::ModelCacher()
 
 ModelCacher::~ModelCacher()
 {
-    for (const auto& it : mModelCache)
-        MemUtil::free(it.second);
+    for (const StringMap<Model*>::Entry& entry : mModelCache)
+        ResourceCache::instance()->release(entry.value);
 
     mModelCache.clear();
 }
 
-Model* ModelCacher::loadModel(const char* base_fname, const char* key)
+void ModelCacher::destroyFile_(void* file)
+{
+    FileDeviceMgr::unload(static_cast<u8*>(file));
+}
+
+void ModelCacher::keepFile_(void*)
+{
+}
+
+Model* ModelCacher::loadModel(const char* base_fname, const HashedString& key)
 {
     // Check if it exists
     if (Model* model = get(key))
         return model;
 
+    ScopedMemTag mem_tag("Model");
+
     FileDevice::LoadArg arg;
 #if RIO_IS_WIN
     arg.path = std::string("models/") + base_fname + "_LE.rmdl";
@@ -53,10 +66,25 @@ Model* ModelCacher::loadModel(const char* base_fname, const char* key)
 #endif
     arg.alignment = Drawer::cVtxAlignment;
 
+    // Check if the file is still cached
+    if (Model* model = ResourceCache::instance()->acquire<Model>(arg.path))
+    {
+        mModelCache.tryEmplace(key, model);
+        return model;
+    }
+
     u8* const file = FileDeviceMgr::instance()->tryLoad(arg);
-    if (!file || arg.read_size < sizeof(Model))
+    if (!file)
         return nullptr;
 
+    if (arg.read_size < sizeof(Model))
+    {
+        if (arg.need_unload)
+            FileDeviceMgr::unload(file);
+
+        return nullptr;
+    }
+
     Model* model = (Model*)file;
 
     RIO_ASSERT(model->mMagic[0] == 'r' &&
@@ -73,17 +101,30 @@ Model* ModelCacher::loadModel(const char* base_fname, const char* key)
 
     RIO_ASSERT(model->mFileSize == arg.read_size);
 
-    auto it = mModelCache.try_emplace(key, model);
-    return it.first->second;
+    // Files served without copy (e.g., from an archive) are not owned by the cache and use no memory of their own
+    if (arg.need_unload)
+        model = static_cast<Model*>(ResourceCache::instance()->add(arg.path, file, arg.roundup_size, &ModelCacher::destroyFile_));
+    else
+        model = static_cast<Model*>(ResourceCache::instance()->add(arg.path, file, 0, &ModelCacher::keepFile_));
+
+    mModelCache.tryEmplace(key, model);
+    return model;
 }
 
-Model* ModelCacher::get(const char* key) const
+void ModelCacher::unloadModel(const HashedString& key)
 {
-    auto it = mModelCache.find(key);
-    if (it != mModelCache.end())
-        return it->second;
+    Model* const* model = mModelCache.find(key);
+    if (!model)
+        return;
+
+    ResourceCache::instance()->release(*model);
+    mModelCache.erase(key);
+}
 
-    return nullptr;
+Model* ModelCacher::get(const HashedString& key) const
+{
+    Model* const* model = mModelCache.find(key);
+    return model ? *model : nullptr;
 }
 
 } } }
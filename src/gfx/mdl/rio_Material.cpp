@@ -3,6 +3,7 @@
 #include <gfx/mdl/rio_Model.h>
 #include <gpu/rio_Drawer.h>
 #include <misc/rio_MemUtil.h>
+#include <misc/rio_ResourceCache.h>
 
 namespace rio { namespace mdl {
 
@@ -28,9 +29,18 @@ Material::Material(const res::Material* res_material, Model* parent_mdl)
     else
         mShaderMode = Shader::MODE_INVALID;
 
-    // TODO: Shader cacher
-    mShader = new Shader();
-    mShader->load(mResMaterial.shaderName(), mShaderMode);
+    // Shaders and textures are shared with the other materials through the resource cache
+    const std::string shader_path = std::string("shaders/") + mResMaterial.shaderName();
+
+    mShader = ResourceCache::instance()->acquire<Shader>(shader_path);
+    if (!mShader)
+    {
+        Shader* shader = new Shader();
+        shader->load(mResMaterial.shaderName(), mShaderMode);
+
+        // The size of the shader program is not known
+        mShader = ResourceCache::instance()->add(shader_path, shader, sizeof(Shader));
+    }
 
     mNumTextures = mResMaterial.numTextures();
     if (mNumTextures > 0)
@@ -45,8 +55,17 @@ Material::Material(const res::Material* res_material, Model* parent_mdl)
 
             Texture& texture = mTextures[i];
 
-            // TODO: Texture cacher
-            texture.mpTexture = new Texture2D(texture_name);
+            const std::string texture_path = std::string("textures/") + texture_name + ".rtx";
+
+            texture.mpTexture = ResourceCache::instance()->acquire<Texture2D>(texture_path);
+            if (!texture.mpTexture)
+            {
+                Texture2D* texture_2d = new Texture2D(texture_name);
+
+                const NativeSurface2D& surface = texture_2d->getNativeTexture().surface;
+                texture.mpTexture = ResourceCache::instance()->add(texture_path, texture_2d, surface.imageSize + surface.mipmapSize);
+            }
+
             texture.mTextureSampler.linkTexture2D(texture.mpTexture);
 
             texture.mVSLocation = mShader->getVertexSamplerLocation(sampler_name);
@@ -112,12 +131,12 @@ Material::Material(const res::Material* res_material, Model* parent_mdl)
 
 Material::~Material()
 {
-    delete mShader;
+    ResourceCache::instance()->release(mShader);
 
     if (mNumTextures > 0)
     {
         for (u32 i = 0; i < mNumTextures; i++)
-            delete mTextures[i].mpTexture;
+            ResourceCache::instance()->release(mTextures[i].mpTexture);
 
         delete[] mTextures;
     }
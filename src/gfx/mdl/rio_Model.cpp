@@ -1,6 +1,7 @@
 #include <gfx/mdl/rio_Material.h>
 #include <gfx/mdl/rio_Mesh.h>
 #include <gfx/mdl/rio_Model.h>
+#include <heap/rio_MemTracker.h>
 #include <misc/rio_MemUtil.h>
 
 #include <new>
@@ -15,6 +16,8 @@ Model::Model(const res::Model* res_mdl)
 {
     RIO_ASSERT(res_mdl);
 
+    ScopedMemTag mem_tag("Model");
+
     mNumMeshes = mResModel.numMeshes();
     if (mNumMeshes > 0)
     {
@@ -12,6 +12,7 @@ bool Window::createSingleton(
     , bool resizable
     , u32 gl_major
     , u32 gl_minor
+    , bool visible
 #endif // RIO_IS_WIN
 )
 {
@@ -27,6 +28,7 @@ bool Window::createSingleton(
         resizable
         , gl_major
         , gl_minor
+        , visible
 #endif // RIO_IS_WIN
     ))
     {
@@ -48,12 +50,26 @@ bool Window::createSingleton(
     return true;
 }
 
+bool Window::createSingletonNull(u32 width, u32 height)
+{
+    if (sInstance)
+        return false;
+
+    Window* window = new Window(width, height);
+    window->mIsNull = true;
+
+    sInstance = window;
+    return true;
+}
+
 void Window::destroySingleton()
 {
     if (!sInstance)
         return;
 
-    sInstance->terminate_();
+    if (!sInstance->mIsNull)
+        sInstance->terminate_();
+
     delete sInstance;
     sInstance = nullptr;
 }
@@ -77,7 +77,7 @@ void Window::resizeCallback_(GLFWwindow* glfw_window, s32 width, s32 height)
     window->resizeCallback_(width, height);
 }
 
-bool Window::initialize_(bool resizable, u32 gl_major, u32 gl_minor)
+bool Window::initialize_(bool resizable, u32 gl_major, u32 gl_minor, bool visible)
 {
     // Initialize GLFW
     if (!glfwInit())
@@ -104,6 +104,9 @@ bool Window::initialize_(bool resizable, u32 gl_major, u32 gl_minor)
     // Enforce double-buffering
     glfwWindowHint(GLFW_DOUBLEBUFFER, GLFW_TRUE);
 
+    if (!visible)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
     // Create the window instance
     mNativeWindow.mpGLFWwindow = glfwCreateWindow(mWidth, mHeight, "Game", nullptr, nullptr);
     if (!mNativeWindow.mpGLFWwindow)
@@ -195,6 +198,9 @@ bool Window::initialize_(bool resizable, u32 gl_major, u32 gl_minor)
 
 bool Window::isRunning() const
 {
+    if (mIsNull)
+        return true;
+
     return !glfwWindowShouldClose(mNativeWindow.mpGLFWwindow);
 }
 
@@ -365,6 +371,16 @@ void Window::makeContextCurrent() const
     RIO_GL_CALL(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, mNativeWindow.mDepthBufferHandle));
 }
 
+void Window::releaseContext() const
+{
+    glfwMakeContextCurrent(nullptr);
+}
+
+void Window::pollEvents()
+{
+    glfwPollEvents();
+}
+
 void Window::setSwapInterval(u32 swap_interval)
 {
     glfwSwapInterval(0);
@@ -413,7 +429,8 @@ void Window::swapBuffers() const
     glfwSwapBuffers(mNativeWindow.mpGLFWwindow);
     mNativeWindow.onSwapBuffers_();
     // Poll for and process events
-    glfwPollEvents();
+    if (mNativeWindow.mPollEventsOnSwap)
+        glfwPollEvents();
 
     // Restore our Frame Buffer
     RIO_GL_CALL(glBindFramebuffer(GL_FRAMEBUFFER, mNativeWindow.mFramebufferHandle));
@@ -147,7 +147,8 @@ void Shader::load(const char* base_fname, ShaderMode exp_mode)
     RIO_ASSERT(mpPixelShader);
     RIO_ASSERT(mpPixelShader->mode == (GX2ShaderMode)exp_mode);
 
-    MemUtil::free(file);
+    if (arg.need_unload)
+        FileDeviceMgr::unload(file);
 
     mShaderMode = exp_mode;
     mLoaded = true;
@@ -4,6 +4,7 @@
 
 #include <filedevice/rio_FileDeviceMgr.h>
 #include <gpu/rio_Texture.h>
+#include <heap/rio_MemTracker.h>
 
 #include <gfd.h>
 #include <gx2/mem.h>
@@ -13,12 +14,16 @@ namespace rio {
 Texture2D::Texture2D(const char* base_fname)
     : mSelfAllocated(true)
 {
+    ScopedMemTag mem_tag("Texture");
+
     FileDevice::LoadArg arg;
     arg.path = std::string("textures/") + base_fname + ".gtx";
 
     u8* const file = FileDeviceMgr::instance()->load(arg);
     load_(file, arg.read_size);
-    MemUtil::free(file);
+
+    if (arg.need_unload)
+        FileDeviceMgr::unload(file);
 }
 
 Texture2D::Texture2D(TextureFormat format, u32 width, u32 height, u32 numMips)
@@ -123,12 +123,14 @@ void Shader::load(const char* base_fname, ShaderMode)
 
     char* vertex_shader_src_file;
     u32 vertex_shader_src_file_len;
+    bool vertex_shader_src_file_need_unload;
     {
         FileDevice::LoadArg arg;
         arg.path = base_path + ".vert";
 
         vertex_shader_src_file = (char*)FileDeviceMgr::instance()->load(arg);
         vertex_shader_src_file_len = arg.read_size;
+        vertex_shader_src_file_need_unload = arg.need_unload;
     }
 
     const std::string vertex_shader_src = std::string(vertex_shader_src_file, vertex_shader_src_file_len);
@@ -136,12 +138,14 @@ void Shader::load(const char* base_fname, ShaderMode)
 
     char* fragment_shader_src_file;
     u32 fragment_shader_src_file_len;
+    bool fragment_shader_src_file_need_unload;
     {
         FileDevice::LoadArg arg;
         arg.path = base_path + ".frag";
 
         fragment_shader_src_file = (char*)FileDeviceMgr::instance()->load(arg);
         fragment_shader_src_file_len = arg.read_size;
+        fragment_shader_src_file_need_unload = arg.need_unload;
     }
 
     const std::string fragment_shader_src = std::string(fragment_shader_src_file, fragment_shader_src_file_len);
@@ -149,8 +153,11 @@ void Shader::load(const char* base_fname, ShaderMode)
 
     load(c_vertex_shader_src, c_fragment_shader_src);
 
-    MemUtil::free(vertex_shader_src_file);
-    MemUtil::free(fragment_shader_src_file);
+    if (vertex_shader_src_file_need_unload)
+        FileDeviceMgr::unload((u8*)vertex_shader_src_file);
+
+    if (fragment_shader_src_file_need_unload)
+        FileDeviceMgr::unload((u8*)fragment_shader_src_file);
 }
 
 void Shader::unload()
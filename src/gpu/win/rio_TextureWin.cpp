@@ -5,6 +5,7 @@
 #include <filedevice/rio_FileDeviceMgr.h>
 #include <gpu/rio_Texture.h>
 #include <gpu/win/rio_Texture2DUtilWin.h>
+#include <heap/rio_MemTracker.h>
 
 #include <algorithm>
 
@@ -33,12 +34,16 @@ namespace rio {
 Texture2D::Texture2D(const char* base_fname)
     : mSelfAllocated(true)
 {
+    ScopedMemTag mem_tag("Texture");
+
     FileDevice::LoadArg arg;
     arg.path = std::string("textures/") + base_fname + ".rtx";
 
     u8* const file = FileDeviceMgr::instance()->load(arg);
     load_(file, arg.read_size);
-    MemUtil::free(file);
+
+    if (arg.need_unload)
+        FileDeviceMgr::unload(file);
 }
 
 Texture2D::Texture2D(TextureFormat format, u32 width, u32 height, u32 numMips)
@@ -0,0 +1,248 @@
+#include <heap/rio_ExpHeap.h>
+
+namespace {
+
+static inline size_t alignUp(size_t x, size_t y)
+{
+    RIO_ASSERT(((y - 1) & y) == 0);
+    return (x + y - 1) & ~(y - 1);
+}
+
+}
+
+namespace rio {
+
+ExpHeap* ExpHeap::create(size_t size, const char* name, Heap* parent)
+{
+    size &= ~size_t(cMinAlignment - 1);
+    if (size < cHeaderSize + cMinAlignment)
+    {
+        RIO_LOG("ExpHeap::create(): \"%s\": Size %zu is too small.\n", name, size);
+        return nullptr;
+    }
+
+    void* start = allocBlock_(parent, size, cMinAlignment);
+    if (!start)
+    {
+        RIO_LOG("ExpHeap::create(): \"%s\": Could not allocate %zu byte(s).\n", name, size);
+        return nullptr;
+    }
+
+    ExpHeap* heap = new ExpHeap(name, parent, start, size);
+    register_(heap);
+    return heap;
+}
+
+ExpHeap::ExpHeap(const char* name, Heap* parent, void* start, size_t size)
+    : Heap(name, parent, start, size)
+    , mFreeList(nullptr)
+{
+    doFreeAll_();
+}
+
+size_t ExpHeap::getAllocSize(const void* ptr) const
+{
+    RIO_ASSERT(isInclude(ptr));
+
+    std::lock_guard<std::mutex> lock(mCS);
+
+    const UsedBlock* used = getUsedBlock_(ptr);
+    RIO_ASSERT(used->magic == cUsedMagic);
+
+    return used->size;
+}
+
+ExpHeap::UsedBlock* ExpHeap::getUsedBlock_(const void* ptr)
+{
+    return reinterpret_cast<UsedBlock*>(const_cast<u8*>(static_cast<const u8*>(ptr)) - cHeaderSize);
+}
+
+u8* ExpHeap::getAllocAddress_(const FreeBlock* block, u32 alignment)
+{
+    return reinterpret_cast<u8*>(alignUp(uintptr_t(block) + cHeaderSize, alignment));
+}
+
+void* ExpHeap::doAlloc_(size_t size, u32 alignment)
+{
+    size = alignUp(size > 0 ? size : 1, cMinAlignment);
+
+    // Best fit
+    FreeBlock* best = nullptr;
+    FreeBlock* best_prev = nullptr;
+    u8* addr = nullptr;
+
+    for (FreeBlock* prev = nullptr, * block = mFreeList; block; prev = block, block = block->next)
+    {
+        u8* const block_addr = getAllocAddress_(block, alignment);
+        const size_t offset = block_addr - reinterpret_cast<u8*>(block);
+        if (offset > block->size || block->size - offset < size)
+            continue;
+
+        if (!best || block->size < best->size)
+        {
+            best = block;
+            best_prev = prev;
+            addr = block_addr;
+
+            if (block->size - offset == size)
+                break;
+        }
+    }
+
+    if (!best)
+        return nullptr;
+
+    u8* const begin = reinterpret_cast<u8*>(best);
+    u8* const end = begin + best->size;
+    u8* const header = addr - cHeaderSize;
+    u8* alloc_end = addr + size;
+    FreeBlock* const next = best->next;
+
+    size_t padding = header - begin;
+    FreeBlock** link = best_prev ? &best_prev->next : &mFreeList;
+
+    // Space before the allocation is kept free if it can hold a free block, and is padding otherwise
+    if (padding >= cMinFreeBlockSize)
+    {
+        FreeBlock* leading = reinterpret_cast<FreeBlock*>(begin);
+        leading->size = padding;
+        *link = leading;
+        link = &leading->next;
+        padding = 0;
+    }
+
+    // Same for the space after it, which otherwise goes to the allocation
+    if (size_t(end - alloc_end) >= cMinFreeBlockSize)
+    {
+        FreeBlock* trailing = reinterpret_cast<FreeBlock*>(alloc_end);
+        trailing->size = end - alloc_end;
+        trailing->next = next;
+        *link = trailing;
+    }
+    else
+    {
+        alloc_end = end;
+        *link = next;
+    }
+
+    UsedBlock* used = reinterpret_cast<UsedBlock*>(header);
+    used->magic = cUsedMagic;
+    used->padding = padding;
+    used->size = alloc_end - addr;
+
+    return addr;
+}
+
+void ExpHeap::doFree_(void* ptr)
+{
+    UsedBlock* used = getUsedBlock_(ptr);
+    if (used->magic != cUsedMagic)
+    {
+        RIO_LOG("ExpHeap::free(): \"%s\": %p is not allocated.\n", mName.c_str(), ptr);
+        RIO_ASSERT(false);
+        return;
+    }
+
+    used->magic = 0;
+
+    u8* const begin = reinterpret_cast<u8*>(used) - used->padding;
+    u8* const end = static_cast<u8*>(ptr) + used->size;
+
+    FreeBlock* prev = nullptr;
+    FreeBlock* next = mFreeList;
+    while (next && reinterpret_cast<u8*>(next) < begin)
+    {
+        prev = next;
+        next = next->next;
+    }
+
+    // Merge with the free neighbors
+    FreeBlock* block;
+    if (prev && reinterpret_cast<u8*>(prev) + prev->size == begin)
+    {
+        block = prev;
+        block->size += end - begin;
+    }
+    else
+    {
+        block = reinterpret_cast<FreeBlock*>(begin);
+        block->size = end - begin;
+
+        if (prev)
+            prev->next = block;
+        else
+            mFreeList = block;
+    }
+
+    if (next && reinterpret_cast<u8*>(next) == end)
+    {
+        block->size += next->size;
+        block->next = next->next;
+    }
+    else
+    {
+        block->next = next;
+    }
+}
+
+void ExpHeap::doFreeAll_()
+{
+    mFreeList = reinterpret_cast<FreeBlock*>(mStart);
+    mFreeList->size = mSize;
+    mFreeList->next = nullptr;
+}
+
+size_t ExpHeap::doGetFreeSize_() const
+{
+    size_t size = 0;
+    for (const FreeBlock* block = mFreeList; block; block = block->next)
+        size += block->size;
+
+    return size;
+}
+
+size_t ExpHeap::doGetMaxAllocatableSize_(u32 alignment) const
+{
+    size_t max_size = 0;
+    for (const FreeBlock* block = mFreeList; block; block = block->next)
+    {
+        const size_t offset = getAllocAddress_(block, alignment) - reinterpret_cast<const u8*>(block);
+        if (offset >= block->size)
+            continue;
+
+        const size_t size = (block->size - offset) & ~size_t(cMinAlignment - 1);
+        if (size > max_size)
+            max_size = size;
+    }
+
+    return max_size;
+}
+
+u32 ExpHeap::doGetFreeBlockNum_() const
+{
+    u32 num = 0;
+    for (const FreeBlock* block = mFreeList; block; block = block->next)
+        num++;
+
+    return num;
+}
+
+f32 ExpHeap::doGetFragmentation_() const
+{
+    // Compare the largest free block to the total free size, so that the headers do not count as fragmentation
+    size_t free_size = 0;
+    size_t max_size = 0;
+    for (const FreeBlock* block = mFreeList; block; block = block->next)
+    {
+        free_size += block->size;
+        if (block->size > max_size)
+            max_size = block->size;
+    }
+
+    if (free_size == 0)
+        return 0.0f;
+
+    return 1.0f - f32(max_size) / f32(free_size);
+}
+
+}
@@ -0,0 +1,198 @@
+#include <heap/rio_FrameAllocator.h>
+#include <heap/rio_MemTracker.h>
+#include <misc/rio_MemUtil.h>
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace {
+
+static inline size_t alignUp(size_t x, size_t y)
+{
+    RIO_ASSERT(((y - 1) & y) == 0);
+    return (x + y - 1) & ~(y - 1);
+}
+
+}
+
+namespace rio {
+
+FrameAllocator* FrameAllocator::sInstance = nullptr;
+
+bool FrameAllocator::createSingleton(size_t size)
+{
+    if (sInstance)
+        return false;
+
+    sInstance = new FrameAllocator(size);
+
+    if (!sInstance->mBuffers[0].start || !sInstance->mBuffers[1].start)
+    {
+        RIO_LOG("FrameAllocator: Could not allocate two buffers of %zu byte(s).\n", size);
+        delete sInstance;
+        sInstance = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+void FrameAllocator::destroySingleton()
+{
+    if (!sInstance)
+        return;
+
+    delete sInstance;
+    sInstance = nullptr;
+}
+
+FrameAllocator::FrameAllocator(size_t size)
+    : mCurrent(0)
+    , mSize(alignUp(size, cMinAlignment))
+    , mHighWaterMark(0)
+    , mOverflowNum(0)
+    , mOverflowSize(0)
+    , mFrameNum(0)
+{
+    ScopedMemTag mem_tag("FrameAllocator");
+
+    for (Buffer& buffer : mBuffers)
+    {
+        buffer.start = mSize > 0 ? static_cast<u8*>(MemUtil::alloc(mSize, cMinAlignment)) : nullptr;
+        buffer.offset.store(0, std::memory_order_relaxed);
+        buffer.overflow_size = 0;
+    }
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    for (Buffer& buffer : mBuffers)
+    {
+        reset_(buffer);
+        MemUtil::free(buffer.start);
+    }
+}
+
+void* FrameAllocator::alloc(size_t size, u32 alignment)
+{
+    RIO_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    Buffer& buffer = mBuffers[mCurrent];
+    const uintptr_t start = uintptr_t(buffer.start);
+
+    size_t offset = buffer.offset.load(std::memory_order_relaxed);
+    while (true)
+    {
+        const size_t begin = alignUp(start + offset, alignment) - start;
+        if (begin > mSize || mSize - begin < size)
+            return allocOverflow_(buffer, size, alignment);
+
+        if (buffer.offset.compare_exchange_weak(offset, begin + size, std::memory_order_relaxed))
+            return buffer.start + begin;
+    }
+}
+
+void* FrameAllocator::allocOverflow_(Buffer& buffer, size_t size, u32 alignment)
+{
+    void* const ptr = MemUtil::alloc(size > 0 ? size : 1, alignment);
+    if (!ptr)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(mOverflowCS);
+
+    buffer.overflow.push_back(ptr);
+    buffer.overflow_size += size;
+
+    mOverflowNum++;
+    mOverflowSize += size;
+
+    return ptr;
+}
+
+const char* FrameAllocator::format(const char* fmt, ...)
+{
+    std::va_list args;
+    va_start(args, fmt);
+
+    std::va_list args_copy;
+    va_copy(args_copy, args);
+    const s32 len = std::vsnprintf(nullptr, 0, fmt, args_copy);
+    va_end(args_copy);
+
+    char* str = len >= 0 ? static_cast<char*>(alloc(size_t(len) + 1, 1)) : nullptr;
+    if (str)
+        std::vsnprintf(str, size_t(len) + 1, fmt, args);
+
+    va_end(args);
+
+    return str ? str : "";
+}
+
+void FrameAllocator::flip()
+{
+    const Buffer& prev = mBuffers[mCurrent];
+    const size_t used_size = prev.offset.load(std::memory_order_relaxed) + prev.overflow_size;
+
+    if (used_size > mHighWaterMark)
+        mHighWaterMark = used_size;
+
+    if (!prev.overflow.empty())
+        RIO_LOG("FrameAllocator: Frame %u used %zu byte(s), %zu of which did not fit in the buffer (%u allocation(s)).\n",
+                mFrameNum, used_size, prev.overflow_size, u32(prev.overflow.size()));
+
+    mFrameNum++;
+
+    // The new current buffer was last used two frames ago, whose rendering has completed
+    mCurrent ^= 1;
+    reset_(mBuffers[mCurrent]);
+}
+
+void FrameAllocator::reset_(Buffer& buffer)
+{
+    {
+        std::lock_guard<std::mutex> lock(mOverflowCS);
+
+        for (void* ptr : buffer.overflow)
+            MemUtil::free(ptr);
+
+        buffer.overflow.clear();
+        buffer.overflow_size = 0;
+    }
+
+    buffer.offset.store(0, std::memory_order_relaxed);
+}
+
+size_t FrameAllocator::getUsedSize() const
+{
+    const Buffer& buffer = mBuffers[mCurrent];
+
+    std::lock_guard<std::mutex> lock(mOverflowCS);
+    return buffer.offset.load(std::memory_order_relaxed) + buffer.overflow_size;
+}
+
+void FrameAllocator::getStats(Stats* stats) const
+{
+    RIO_ASSERT(stats);
+
+    const Buffer& buffer = mBuffers[mCurrent];
+
+    std::lock_guard<std::mutex> lock(mOverflowCS);
+
+    stats->size = mSize;
+    stats->used_size = buffer.offset.load(std::memory_order_relaxed) + buffer.overflow_size;
+    stats->high_water_mark = mHighWaterMark;
+    stats->overflow_num = mOverflowNum;
+    stats->overflow_size = mOverflowSize;
+    stats->frame_num = mFrameNum;
+}
+
+void FrameAllocator::printStats() const
+{
+    Stats stats;
+    getStats(&stats);
+
+    RIO_LOG("FrameAllocator: %zu/%zu byte(s) used this frame, high-water mark: %zu, %u overflow(s) (%zu byte(s)) in %u frame(s)\n",
+            stats.used_size, stats.size, stats.high_water_mark, stats.overflow_num, stats.overflow_size, stats.frame_num);
+}
+
+}
@@ -0,0 +1,101 @@
+#include <heap/rio_FrameHeap.h>
+
+namespace {
+
+static inline uintptr_t alignUp(uintptr_t x, uintptr_t y)
+{
+    RIO_ASSERT(((y - 1) & y) == 0);
+    return (x + y - 1) & ~(y - 1);
+}
+
+}
+
+namespace rio {
+
+FrameHeap* FrameHeap::create(size_t size, const char* name, Heap* parent)
+{
+    size &= ~size_t(cMinAlignment - 1);
+    if (size == 0)
+    {
+        RIO_LOG("FrameHeap::create(): \"%s\": Size is zero.\n", name);
+        return nullptr;
+    }
+
+    void* start = allocBlock_(parent, size, cMinAlignment);
+    if (!start)
+    {
+        RIO_LOG("FrameHeap::create(): \"%s\": Could not allocate %zu byte(s).\n", name, size);
+        return nullptr;
+    }
+
+    FrameHeap* heap = new FrameHeap(name, parent, start, size);
+    register_(heap);
+    return heap;
+}
+
+FrameHeap::FrameHeap(const char* name, Heap* parent, void* start, size_t size)
+    : Heap(name, parent, start, size)
+    , mHead(mStart)
+{
+}
+
+FrameHeap::State FrameHeap::recordState() const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+    return { mHead, mAllocNum };
+}
+
+void FrameHeap::restoreState(const State& state)
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    RIO_ASSERT(mStart <= state.head && state.head <= mHead);
+
+    mHead = state.head;
+    mAllocNum = state.alloc_num;
+}
+
+void* FrameHeap::doAlloc_(size_t size, u32 alignment)
+{
+    size = alignUp(size > 0 ? size : 1, cMinAlignment);
+
+    u8* const addr = reinterpret_cast<u8*>(alignUp(uintptr_t(mHead), alignment));
+    u8* const end = mStart + mSize;
+    if (addr > end || size_t(end - addr) < size)
+        return nullptr;
+
+    mHead = addr + size;
+    return addr;
+}
+
+void FrameHeap::doFree_(void*)
+{
+    // Only freed by freeAll() or restoreState()
+}
+
+void FrameHeap::doFreeAll_()
+{
+    mHead = mStart;
+}
+
+size_t FrameHeap::doGetFreeSize_() const
+{
+    return mStart + mSize - mHead;
+}
+
+size_t FrameHeap::doGetMaxAllocatableSize_(u32 alignment) const
+{
+    u8* const addr = reinterpret_cast<u8*>(alignUp(uintptr_t(mHead), alignment));
+    u8* const end = mStart + mSize;
+    if (addr >= end)
+        return 0;
+
+    return size_t(end - addr) & ~size_t(cMinAlignment - 1);
+}
+
+u32 FrameHeap::doGetFreeBlockNum_() const
+{
+    return mHead < mStart + mSize ? 1 : 0;
+}
+
+}
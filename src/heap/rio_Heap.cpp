@@ -0,0 +1,143 @@
+#include <heap/rio_Heap.h>
+#include <heap/rio_HeapMgr.h>
+#include <misc/rio_MemUtil.h>
+
+namespace rio {
+
+Heap::Heap(const char* name, Heap* parent, void* start, size_t size)
+    : mName(name ? name : "")
+    , mParent(parent)
+    , mStart(static_cast<u8*>(start))
+    , mSize(size)
+    , mAllocNum(0)
+{
+}
+
+Heap::~Heap()
+{
+}
+
+void Heap::destroy()
+{
+    if (mAllocNum > 0)
+        RIO_LOG("Heap::destroy(): \"%s\" still has %u allocation(s).\n", mName.c_str(), mAllocNum);
+
+    HeapMgr* mgr = HeapMgr::instance();
+    if (mgr)
+        mgr->unregisterHeap_(this);
+
+    if (mParent)
+        mParent->free(mStart);
+    else
+        MemUtil::freeSystem(mStart);
+
+    delete this;
+}
+
+void* Heap::tryAlloc(size_t size, u32 alignment)
+{
+    RIO_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    if (alignment < cMinAlignment)
+        alignment = cMinAlignment;
+
+    std::lock_guard<std::mutex> lock(mCS);
+
+    void* ptr = doAlloc_(size, alignment);
+    if (ptr)
+        mAllocNum++;
+
+    return ptr;
+}
+
+void Heap::free(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    RIO_ASSERT(isInclude(ptr));
+
+    std::lock_guard<std::mutex> lock(mCS);
+
+    RIO_ASSERT(mAllocNum > 0);
+
+    doFree_(ptr);
+    mAllocNum--;
+}
+
+void Heap::freeAll()
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    doFreeAll_();
+    mAllocNum = 0;
+}
+
+size_t Heap::getFreeSize() const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+    return doGetFreeSize_();
+}
+
+size_t Heap::getMaxAllocatableSize(u32 alignment) const
+{
+    RIO_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    if (alignment < cMinAlignment)
+        alignment = cMinAlignment;
+
+    std::lock_guard<std::mutex> lock(mCS);
+    return doGetMaxAllocatableSize_(alignment);
+}
+
+void Heap::getStats(Stats* stats) const
+{
+    RIO_ASSERT(stats);
+
+    std::lock_guard<std::mutex> lock(mCS);
+
+    stats->size = mSize;
+    stats->free_size = doGetFreeSize_();
+    stats->max_allocatable_size = doGetMaxAllocatableSize_(cMinAlignment);
+    stats->free_block_num = doGetFreeBlockNum_();
+    stats->alloc_num = mAllocNum;
+    stats->fragmentation = doGetFragmentation_();
+}
+
+void Heap::printStats() const
+{
+    Stats stats;
+    getStats(&stats);
+
+    RIO_LOG("%s \"%s\": %zu/%zu byte(s) free in %u block(s) (Largest: %zu, fragmentation: %.1f%%), %u allocation(s)\n",
+            getKindName(), mName.c_str(), stats.free_size, stats.size, stats.free_block_num,
+            stats.max_allocatable_size, stats.fragmentation * 100.0f, stats.alloc_num);
+}
+
+f32 Heap::doGetFragmentation_() const
+{
+    const size_t free_size = doGetFreeSize_();
+    if (free_size == 0)
+        return 0.0f;
+
+    return 1.0f - f32(doGetMaxAllocatableSize_(cMinAlignment)) / f32(free_size);
+}
+
+void* Heap::allocBlock_(Heap* parent, size_t size, u32 alignment)
+{
+    if (parent)
+        return parent->tryAlloc(size, alignment);
+
+    return MemUtil::allocSystem(size, alignment);
+}
+
+void Heap::register_(Heap* heap)
+{
+    HeapMgr* mgr = HeapMgr::instance();
+    RIO_ASSERT(mgr);
+
+    if (mgr)
+        mgr->registerHeap_(heap);
+}
+
+}
@@ -0,0 +1,143 @@
+#include <heap/rio_ExpHeap.h>
+#include <heap/rio_HeapMgr.h>
+#include <heap/rio_MemTracker.h>
+
+#include <algorithm>
+
+namespace {
+
+// Current heap set on each thread (Null = the root heap)
+static thread_local rio::Heap* sCurrentHeap = nullptr;
+
+}
+
+namespace rio {
+
+HeapMgr* HeapMgr::sInstance = nullptr;
+
+bool HeapMgr::createSingleton(size_t root_heap_size)
+{
+    if (sInstance)
+        return false;
+
+    sInstance = new HeapMgr();
+
+#if RIO_MEM_TRACKING
+    MemTracker::createSingleton();
+#endif // RIO_MEM_TRACKING
+
+    if (root_heap_size > 0)
+    {
+        sInstance->mRootHeap = ExpHeap::create(root_heap_size, "rio::HeapMgr::RootHeap");
+        if (!sInstance->mRootHeap)
+        {
+#if RIO_MEM_TRACKING
+            MemTracker::destroySingleton();
+#endif // RIO_MEM_TRACKING
+            delete sInstance;
+            sInstance = nullptr;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void HeapMgr::destroySingleton()
+{
+    if (!sInstance)
+        return;
+
+#if RIO_MEM_TRACKING
+    // Everything should have been freed by now
+    MemTracker::instance()->reportLeaks();
+    MemTracker::destroySingleton();
+#endif // RIO_MEM_TRACKING
+
+    if (sInstance->mRootHeap)
+    {
+        sInstance->mRootHeap->destroy();
+        sInstance->mRootHeap = nullptr;
+    }
+
+    delete sInstance;
+    sInstance = nullptr;
+}
+
+HeapMgr::HeapMgr()
+    : mRootHeap(nullptr)
+{
+}
+
+HeapMgr::~HeapMgr()
+{
+    for ([[maybe_unused]] Heap* heap : mHeaps)
+        RIO_LOG("HeapMgr: Heap \"%s\" has not been destroyed.\n", heap->getName());
+}
+
+Heap* HeapMgr::getCurrentHeap()
+{
+    Heap* heap = sCurrentHeap;
+    if (heap)
+        return heap;
+
+    if (sInstance)
+        return sInstance->mRootHeap;
+
+    return nullptr;
+}
+
+Heap* HeapMgr::setCurrentHeap(Heap* heap)
+{
+    Heap* prev_heap = sCurrentHeap;
+    sCurrentHeap = heap;
+    return prev_heap;
+}
+
+Heap* HeapMgr::findContainHeap(const void* ptr) const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    // Child heaps are inside their parent's block, so the innermost heap is the smallest one
+    Heap* found = nullptr;
+    for (Heap* heap : mHeaps)
+        if (heap->isInclude(ptr) && (!found || heap->getSize() < found->getSize()))
+            found = heap;
+
+    return found;
+}
+
+u32 HeapMgr::getHeapNum() const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+    return mHeaps.size();
+}
+
+void HeapMgr::printStats() const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    for (const Heap* heap : mHeaps)
+        heap->printStats();
+}
+
+void HeapMgr::registerHeap_(Heap* heap)
+{
+    std::lock_guard<std::mutex> lock(mCS);
+    mHeaps.push_back(heap);
+}
+
+void HeapMgr::unregisterHeap_(Heap* heap)
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    std::vector<Heap*>::iterator it = std::find(mHeaps.begin(), mHeaps.end(), heap);
+    if (it != mHeaps.end())
+        mHeaps.erase(it);
+
+    // Only the calling thread's current heap can be reset
+    if (sCurrentHeap == heap)
+        sCurrentHeap = nullptr;
+}
+
+}
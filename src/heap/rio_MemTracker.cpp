@@ -0,0 +1,256 @@
+#include <heap/rio_MemTracker.h>
+
+#if RIO_MEM_TRACKING
+
+#include <cstring>
+
+namespace {
+
+// Current tag of each thread (Null = rio::MemTracker::cUntagged)
+static thread_local const char* sCurrentTag = nullptr;
+
+}
+
+namespace rio {
+
+MemTracker* MemTracker::sInstance = nullptr;
+
+bool MemTracker::createSingleton()
+{
+    if (sInstance)
+        return false;
+
+    sInstance = new MemTracker();
+    return true;
+}
+
+void MemTracker::destroySingleton()
+{
+    if (!sInstance)
+        return;
+
+    delete sInstance;
+    sInstance = nullptr;
+}
+
+MemTracker::MemTracker()
+    : mLiveSize(0)
+    , mPeakSize(0)
+    , mFrame(0)
+{
+    findTag_(cUntagged);
+}
+
+MemTracker::~MemTracker()
+{
+}
+
+const char* MemTracker::getCurrentTag()
+{
+    const char* tag = sCurrentTag;
+    return tag ? tag : cUntagged;
+}
+
+const char* MemTracker::setCurrentTag(const char* tag)
+{
+    const char* prev_tag = sCurrentTag;
+    sCurrentTag = tag;
+    return prev_tag;
+}
+
+u32 MemTracker::findTag_(const char* name)
+{
+    // Few tags exist, and most lookups find the same literal
+    for (u32 i = 0; i < mTags.size(); i++)
+    {
+        const char* tag_name = mTags[i].stats.name;
+        if (tag_name == name || std::strcmp(tag_name, name) == 0)
+            return i;
+    }
+
+    Tag tag = {};
+    tag.stats.name = name;
+    mTags.push_back(tag);
+
+    return mTags.size() - 1;
+}
+
+void MemTracker::addAlloc_(u32 index, size_t size)
+{
+    Tag& tag = mTags[index];
+
+    tag.stats.live_size += size;
+    tag.stats.live_num++;
+    tag.stats.total_alloc_num++;
+    if (tag.stats.live_size > tag.stats.peak_size)
+        tag.stats.peak_size = tag.stats.live_size;
+
+    tag.frame_alloc_num++;
+    tag.frame_alloc_size += size;
+
+    mLiveSize += size;
+    if (mLiveSize > mPeakSize)
+        mPeakSize = mLiveSize;
+}
+
+void MemTracker::removeAlloc_(u32 index, size_t size)
+{
+    Tag& tag = mTags[index];
+
+    RIO_ASSERT(tag.stats.live_size >= size && tag.stats.live_num > 0);
+
+    tag.stats.live_size -= size;
+    tag.stats.live_num--;
+
+    mLiveSize -= size;
+}
+
+void MemTracker::recordAlloc(const void* ptr, size_t size)
+{
+    const char* const tag_name = getCurrentTag();
+
+    std::lock_guard<std::mutex> lock(mCS);
+
+    const u32 tag = findTag_(tag_name);
+    addAlloc_(tag, size);
+
+    mRecords[ptr] = { size, tag, mFrame };
+}
+
+void MemTracker::recordFree(const void* ptr)
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    // Memory allocated before the tracker was created is not recorded
+    std::unordered_map<const void*, Record>::iterator it = mRecords.find(ptr);
+    if (it == mRecords.end())
+        return;
+
+    removeAlloc_(it->second.tag, it->second.size);
+    mRecords.erase(it);
+}
+
+void MemTracker::recordExternalAlloc(const char* tag, size_t size)
+{
+    std::lock_guard<std::mutex> lock(mCS);
+    addAlloc_(findTag_(tag), size);
+}
+
+void MemTracker::recordExternalFree(const char* tag, size_t size)
+{
+    std::lock_guard<std::mutex> lock(mCS);
+    removeAlloc_(findTag_(tag), size);
+}
+
+void MemTracker::endFrame()
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    for (Tag& tag : mTags)
+    {
+        tag.stats.frame_alloc_num = tag.frame_alloc_num;
+        tag.stats.frame_alloc_size = tag.frame_alloc_size;
+        tag.frame_alloc_num = 0;
+        tag.frame_alloc_size = 0;
+    }
+
+    mFrame++;
+}
+
+bool MemTracker::getTagStats(const char* name, TagStats* stats) const
+{
+    RIO_ASSERT(stats);
+
+    std::lock_guard<std::mutex> lock(mCS);
+
+    for (const Tag& tag : mTags)
+    {
+        if (std::strcmp(tag.stats.name, name) == 0)
+        {
+            *stats = tag.stats;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void MemTracker::getAllTagStats(std::vector<TagStats>* stats) const
+{
+    RIO_ASSERT(stats);
+
+    std::lock_guard<std::mutex> lock(mCS);
+
+    stats->clear();
+    for (const Tag& tag : mTags)
+        stats->push_back(tag.stats);
+}
+
+size_t MemTracker::getLiveSize() const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+    return mLiveSize;
+}
+
+size_t MemTracker::getPeakSize() const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+    return mPeakSize;
+}
+
+void MemTracker::printStats() const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    RIO_LOG("MemTracker: %zu byte(s) live (Peak: %zu) at frame %u:\n", mLiveSize, mPeakSize, mFrame);
+
+    for (const Tag& tag : mTags)
+    {
+        const TagStats& stats = tag.stats;
+        RIO_LOG("  %-20s live: %10zu in %6u, peak: %10zu, last frame: %6u allocation(s) of %zu byte(s)\n",
+                stats.name, stats.live_size, stats.live_num, stats.peak_size, stats.frame_alloc_num, stats.frame_alloc_size);
+    }
+}
+
+u32 MemTracker::reportLeaks() const
+{
+    // Number of allocations printed for each tag
+    static constexpr u32 cPrintMax = 8;
+
+    std::lock_guard<std::mutex> lock(mCS);
+
+    if (mLiveSize == 0 && mRecords.empty())
+        return 0;
+
+    RIO_LOG("MemTracker: %zu byte(s) not freed:\n", mLiveSize);
+
+    for (u32 i = 0; i < mTags.size(); i++)
+    {
+        const TagStats& stats = mTags[i].stats;
+        if (stats.live_num == 0)
+            continue;
+
+        RIO_LOG("  %s: %u allocation(s), %zu byte(s)\n", stats.name, stats.live_num, stats.live_size);
+
+        u32 print_num = 0;
+        for (const std::pair<const void* const, Record>& it : mRecords)
+        {
+            if (it.second.tag != i)
+                continue;
+
+            if (print_num++ == cPrintMax)
+            {
+                RIO_LOG("    ...\n");
+                break;
+            }
+
+            RIO_LOG("    %p: %zu byte(s), allocated at frame %u\n", it.first, it.second.size, it.second.frame);
+        }
+    }
+
+    return mRecords.size();
+}
+
+}
+
+#endif // RIO_MEM_TRACKING
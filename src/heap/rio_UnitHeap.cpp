@@ -0,0 +1,121 @@
+#include <heap/rio_UnitHeap.h>
+
+namespace {
+
+static inline size_t alignUp(size_t x, size_t y)
+{
+    RIO_ASSERT(((y - 1) & y) == 0);
+    return (x + y - 1) & ~(y - 1);
+}
+
+}
+
+namespace rio {
+
+UnitHeap* UnitHeap::create(size_t unit_size, u32 unit_num, const char* name, Heap* parent, u32 alignment)
+{
+    RIO_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    if (alignment < cMinAlignment)
+        alignment = cMinAlignment;
+
+    unit_size = alignUp(unit_size > sizeof(FreeUnit) ? unit_size : sizeof(FreeUnit), alignment);
+    if (unit_num == 0)
+    {
+        RIO_LOG("UnitHeap::create(): \"%s\": Unit number is zero.\n", name);
+        return nullptr;
+    }
+
+    const size_t size = unit_size * unit_num;
+
+    void* start = allocBlock_(parent, size, alignment);
+    if (!start)
+    {
+        RIO_LOG("UnitHeap::create(): \"%s\": Could not allocate %zu byte(s).\n", name, size);
+        return nullptr;
+    }
+
+    UnitHeap* heap = new UnitHeap(name, parent, start, size, unit_size, unit_num, alignment);
+    register_(heap);
+    return heap;
+}
+
+UnitHeap::UnitHeap(const char* name, Heap* parent, void* start, size_t size, size_t unit_size, u32 unit_num, u32 alignment)
+    : Heap(name, parent, start, size)
+    , mUnitSize(unit_size)
+    , mUnitNum(unit_num)
+    , mUnitAlignment(alignment)
+    , mFreeList(nullptr)
+    , mFreeUnitNum(0)
+{
+    doFreeAll_();
+}
+
+u32 UnitHeap::getFreeUnitNum() const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+    return mFreeUnitNum;
+}
+
+void* UnitHeap::doAlloc_(size_t size, u32 alignment)
+{
+    if (size > mUnitSize || alignment > mUnitAlignment)
+    {
+        RIO_LOG("UnitHeap::alloc(): \"%s\": Size %zu (Alignment %u) does not fit a unit of %zu (Alignment %u).\n",
+                mName.c_str(), size, alignment, mUnitSize, mUnitAlignment);
+        return nullptr;
+    }
+
+    FreeUnit* unit = mFreeList;
+    if (!unit)
+        return nullptr;
+
+    mFreeList = unit->next;
+    mFreeUnitNum--;
+
+    return unit;
+}
+
+void UnitHeap::doFree_(void* ptr)
+{
+    RIO_ASSERT((static_cast<u8*>(ptr) - mStart) % mUnitSize == 0);
+
+    FreeUnit* unit = static_cast<FreeUnit*>(ptr);
+    unit->next = mFreeList;
+    mFreeList = unit;
+    mFreeUnitNum++;
+}
+
+void UnitHeap::doFreeAll_()
+{
+    // Units are handed out in address order
+    mFreeList = nullptr;
+    for (u32 i = mUnitNum; i > 0; i--)
+    {
+        FreeUnit* unit = reinterpret_cast<FreeUnit*>(mStart + (i - 1) * mUnitSize);
+        unit->next = mFreeList;
+        mFreeList = unit;
+    }
+
+    mFreeUnitNum = mUnitNum;
+}
+
+size_t UnitHeap::doGetFreeSize_() const
+{
+    return mFreeUnitNum * mUnitSize;
+}
+
+size_t UnitHeap::doGetMaxAllocatableSize_(u32 alignment) const
+{
+    if (mFreeUnitNum == 0 || alignment > mUnitAlignment)
+        return 0;
+
+    return mUnitSize;
+}
+
+u32 UnitHeap::doGetFreeBlockNum_() const
+{
+    return mFreeUnitNum;
+}
+
+}
@@ -0,0 +1,60 @@
+#include <heap/rio_HeapMgr.h>
+#include <heap/rio_MemTracker.h>
+#include <misc/rio_MemUtil.h>
+
+namespace rio {
+
+void* MemUtil::alloc(size_t size, u32 alignment)
+{
+    RIO_ASSERT(size && alignment);
+    RIO_ASSERT((alignment & (alignment - 1)) == 0);
+
+    void* ptr;
+
+    Heap* heap = HeapMgr::getCurrentHeap();
+    if (!heap)
+    {
+        ptr = allocSystem(size, alignment);
+    }
+    else
+    {
+        ptr = heap->tryAlloc(size, alignment);
+        if (!ptr)
+            RIO_LOG("MemUtil::alloc(): Heap \"%s\" is out of memory (%zu byte(s), alignment %u).\n", heap->getName(), size, alignment);
+    }
+
+#if RIO_MEM_TRACKING
+    MemTracker* tracker = MemTracker::instance();
+    if (ptr && tracker)
+        tracker->recordAlloc(ptr, size);
+#endif // RIO_MEM_TRACKING
+
+    return ptr;
+}
+
+void MemUtil::free(void* ptr)
+{
+    RIO_ASSERT(ptr);
+
+#if RIO_MEM_TRACKING
+    // Before the memory can be allocated again
+    MemTracker* tracker = MemTracker::instance();
+    if (tracker)
+        tracker->recordFree(ptr);
+#endif // RIO_MEM_TRACKING
+
+    HeapMgr* mgr = HeapMgr::instance();
+    if (mgr)
+    {
+        Heap* heap = mgr->findContainHeap(ptr);
+        if (heap)
+        {
+            heap->free(ptr);
+            return;
+        }
+    }
+
+    freeSystem(ptr);
+}
+
+}
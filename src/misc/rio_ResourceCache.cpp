@@ -0,0 +1,290 @@
+#include <misc/rio_ResourceCache.h>
+
+namespace rio {
+
+ResourceCache* ResourceCache::sInstance = nullptr;
+
+bool ResourceCache::createSingleton(size_t budget)
+{
+    if (sInstance)
+        return false;
+
+    sInstance = new ResourceCache(budget);
+    return true;
+}
+
+void ResourceCache::destroySingleton()
+{
+    if (!sInstance)
+        return;
+
+    delete sInstance;
+    sInstance = nullptr;
+}
+
+ResourceCache::ResourceCache(size_t budget)
+    : mSize(0)
+    , mBudget(budget)
+    , mHitNum(0)
+    , mMissNum(0)
+    , mEvictionNum(0)
+{
+}
+
+ResourceCache::~ResourceCache()
+{
+    EntryArray entries;
+    entries.reserve(mEntries.size());
+
+    for (const auto& it : mEntries)
+    {
+        Entry* entry = it.second;
+        if (entry->ref_num > 0)
+            RIO_LOG("ResourceCache: \"%s\" is still referenced %u time(s).\n", it.first.c_str(), entry->ref_num);
+
+        entry->lru_node.erase();
+        entries.push_back(entry);
+    }
+
+    // Paths are not used by destroy_()
+    mEntries.clear();
+    mResources.clear();
+    mSize = 0;
+
+    destroy_(entries);
+}
+
+void* ResourceCache::acquire(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    auto it = mEntries.find(path);
+    if (it == mEntries.end())
+    {
+        mMissNum++;
+        return nullptr;
+    }
+
+    Entry* entry = it->second;
+    if (entry->ref_num++ == 0)
+        entry->lru_node.erase();
+
+    mHitNum++;
+    return entry->resource;
+}
+
+void* ResourceCache::add(const std::string& path, void* resource, size_t size, DestroyFunc destroy_func)
+{
+    RIO_ASSERT(resource && destroy_func);
+
+    EntryArray evicted;
+    void* ret;
+
+    {
+        std::lock_guard<std::mutex> lock(mCS);
+
+        auto it = mEntries.try_emplace(path, nullptr);
+        if (!it.second)
+        {
+            // Already cached, keep the cached resource
+            Entry* entry = it.first->second;
+            if (entry->ref_num++ == 0)
+                entry->lru_node.erase();
+
+            ret = entry->resource;
+        }
+        else
+        {
+            Entry* entry = new Entry;
+            entry->path = &it.first->first;
+            entry->resource = resource;
+            entry->size = size;
+            entry->destroy_func = destroy_func;
+            entry->ref_num = 1;
+
+            it.first->second = entry;
+            mResources.try_emplace(resource, entry);
+            mSize += size;
+
+            evict_(mBudget, &evicted);
+
+            ret = resource;
+        }
+    }
+
+    if (ret != resource)
+        (*destroy_func)(resource);
+
+    destroy_(evicted);
+    return ret;
+}
+
+void ResourceCache::release(const void* resource, bool evict)
+{
+    if (!resource)
+        return;
+
+    EntryArray evicted;
+
+    {
+        std::lock_guard<std::mutex> lock(mCS);
+
+        auto it = mResources.find(resource);
+        if (it == mResources.end())
+        {
+            RIO_LOG("ResourceCache::release(): %p is not cached.\n", resource);
+            RIO_ASSERT(false);
+            return;
+        }
+
+        Entry* entry = it->second;
+        RIO_ASSERT(entry->ref_num > 0);
+
+        if (--entry->ref_num > 0)
+            return;
+
+        if (evict)
+        {
+            remove_(entry, &evicted);
+        }
+        else
+        {
+            mLRUList.pushBack(&entry->lru_node);
+            evict_(mBudget, &evicted);
+        }
+    }
+
+    destroy_(evicted);
+}
+
+void* ResourceCache::find(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    auto it = mEntries.find(path);
+    if (it == mEntries.end())
+        return nullptr;
+
+    return it->second->resource;
+}
+
+void ResourceCache::setBudget(size_t budget)
+{
+    EntryArray evicted;
+
+    {
+        std::lock_guard<std::mutex> lock(mCS);
+
+        mBudget = budget;
+        evict_(mBudget, &evicted);
+    }
+
+    destroy_(evicted);
+}
+
+size_t ResourceCache::getBudget() const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+    return mBudget;
+}
+
+void ResourceCache::purge()
+{
+    EntryArray evicted;
+
+    {
+        std::lock_guard<std::mutex> lock(mCS);
+        evict_(0, &evicted);
+    }
+
+    destroy_(evicted);
+}
+
+void ResourceCache::purge(DestroyFunc destroy_func)
+{
+    EntryArray evicted;
+
+    {
+        std::lock_guard<std::mutex> lock(mCS);
+
+        TList<Entry*>::iterator it = mLRUList.begin();
+        while (it != mLRUList.end())
+        {
+            Entry* entry = *it;
+            ++it;
+
+            if (entry->destroy_func == destroy_func)
+                remove_(entry, &evicted);
+        }
+    }
+
+    destroy_(evicted);
+}
+
+void ResourceCache::evict_(size_t budget, EntryArray* evicted)
+{
+    // With a budget of 0, no unreferenced resource is kept (Even if its size is 0)
+    while ((mSize > budget || budget == 0) && !mLRUList.isEmpty())
+        remove_(*mLRUList.begin(), evicted);
+}
+
+void ResourceCache::remove_(Entry* entry, EntryArray* evicted)
+{
+    RIO_ASSERT(entry->ref_num == 0);
+
+    entry->lru_node.erase();
+
+    mSize -= entry->size;
+    mEvictionNum++;
+
+    mResources.erase(entry->resource);
+    mEntries.erase(*entry->path);
+    entry->path = nullptr;
+
+    evicted->push_back(entry);
+}
+
+void ResourceCache::destroy_(const EntryArray& entries)
+{
+    for (Entry* entry : entries)
+    {
+        (*entry->destroy_func)(entry->resource);
+        delete entry;
+    }
+}
+
+void ResourceCache::getStats(Stats* stats) const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    stats->hit_num = mHitNum;
+    stats->miss_num = mMissNum;
+    stats->eviction_num = mEvictionNum;
+    stats->resource_num = mEntries.size();
+    stats->unreferenced_num = mLRUList.size();
+    stats->size = mSize;
+    stats->budget = mBudget;
+}
+
+void ResourceCache::printStats() const
+{
+    Stats stats;
+    getStats(&stats);
+
+    RIO_LOG("ResourceCache: %u resource(s) (%u unreferenced), %zu byte(s)", stats.resource_num, stats.unreferenced_num, stats.size);
+    if (stats.budget != cBudgetUnlimited)
+        RIO_LOG(" of %zu", stats.budget);
+
+    RIO_LOG("\n  Hits: %u, Misses: %u, Evictions: %u\n", stats.hit_num, stats.miss_num, stats.eviction_num);
+}
+
+void ResourceCache::resetStats()
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    mHitNum = 0;
+    mMissNum = 0;
+    mEvictionNum = 0;
+}
+
+}
@@ -2,18 +2,392 @@
 
 #include <audio/rio_AudioMgr.h>
 #include <controller/rio_ControllerMgr.h>
+#include <filedevice/rio_Decompressor.h>
 #include <filedevice/rio_FileDeviceMgr.h>
 #include <gfx/lyr/rio_Renderer.h>
 #include <gfx/mdl/res/rio_ModelCacher.h>
 #include <gfx/rio_PrimitiveRenderer.h>
 #include <gfx/rio_Window.h>
+#include <heap/rio_FrameAllocator.h>
+#include <heap/rio_HeapMgr.h>
+#include <heap/rio_MemTracker.h>
+#include <misc/rio_ResourceCache.h>
 #include <task/rio_TaskMgr.h>
+#include <thread/rio_JobSystem.h>
 
 #if RIO_IS_CAFE
 #include <whb/crash.h>
 #include <whb/log_cafe.h>
 #include <whb/log_udp.h>
-#endif // RIO_IS_CAFE
+#elif RIO_IS_WIN
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+static rio::HeadlessMode sHeadlessMode = rio::HEADLESS_MODE_NONE;
+static u32 sHeadlessFrameNum = 0;
+static std::string sHeadlessReportPath;
+
+static void EndFrame()
+{
+    rio::FrameAllocator* const frame_allocator = rio::FrameAllocator::instance();
+    if (frame_allocator)
+        frame_allocator->flip();
+
+#if RIO_MEM_TRACKING
+    rio::MemTracker* const mem_tracker = rio::MemTracker::instance();
+    if (mem_tracker)
+        mem_tracker->endFrame();
+#endif // RIO_MEM_TRACKING
+}
+
+#if RIO_IS_WIN
+
+static bool sPipelinedMainLoop = false;
+
+class RenderThread
+{
+    // Thread rendering all layers and swapping the window's buffers, one frame per kick().
+    // The window's context is current on the render thread only while it renders.
+
+public:
+    RenderThread()
+        : mRequest(false)
+        , mExit(false)
+    {
+        mThread = std::thread(&RenderThread::threadMain_, this);
+    }
+
+    ~RenderThread()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mCS);
+            mExit = true;
+        }
+        mCond.notify_all();
+        mThread.join();
+    }
+
+private:
+    RenderThread(const RenderThread&);
+    RenderThread& operator=(const RenderThread&);
+
+public:
+    // Render the last published frame (The calling thread must have released the context)
+    void kick()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mCS);
+            RIO_ASSERT(!mRequest);
+            mRequest = true;
+        }
+        mCond.notify_all();
+    }
+
+    // Wait until the frame is rendered and the context is released
+    void waitIdle()
+    {
+        std::unique_lock<std::mutex> lock(mCS);
+        mCond.wait(lock, [this] { return !mRequest; });
+    }
+
+private:
+    void threadMain_()
+    {
+        rio::Window* const window = rio::Window::instance();
+
+        std::unique_lock<std::mutex> lock(mCS);
+
+        while (true)
+        {
+            mCond.wait(lock, [this] { return mExit || mRequest; });
+            if (mExit)
+                break;
+
+            lock.unlock();
+
+            window->makeContextCurrent();
+            rio::lyr::Renderer::instance()->render();
+            window->swapBuffers();
+            window->releaseContext();
+
+            lock.lock();
+
+            mRequest = false;
+            mCond.notify_all();
+        }
+    }
+
+private:
+    std::thread             mThread;
+    std::mutex              mCS;
+    std::condition_variable mCond;
+    bool                    mRequest;
+    bool                    mExit;
+};
+
+static void EnterPipelinedMainLoop()
+{
+    rio::Window* const window = rio::Window::instance();
+    rio::TaskMgr* const task_mgr = rio::TaskMgr::instance();
+    rio::lyr::Renderer* const renderer = rio::lyr::Renderer::instance();
+
+    // Frame N is rendered on the render thread while frame N + 1 is calculated on this thread.
+    // Everything that may use the GPU (Window events, entering and destroying tasks) happens
+    // in between, while this thread holds the context and the render thread is idle.
+
+    renderer->setPipelined(true);
+    window->setPollEventsOnSwap(false);
+
+    {
+        RenderThread render_thread;
+
+        task_mgr->calcPrepare();
+        window->releaseContext();
+
+        while (window->isRunning())
+        {
+            // Calculate frame N + 1 (Overlaps the rendering of frame N)
+            task_mgr->calcActive();
+
+            render_thread.waitIdle();
+            window->makeContextCurrent();
+
+            window->pollEvents();
+            task_mgr->calcDestroy();
+
+            // Capture frame N + 1 for the render thread
+            renderer->publish();
+
+            task_mgr->calcPrepare();
+
+            // Frame N has been rendered, so frame N + 2 can reuse its transient allocations
+            // (Done while the render thread is idle, as it may allocate when rendering)
+            EndFrame();
+
+            window->releaseContext();
+            render_thread.kick();
+        }
+
+        render_thread.waitIdle();
+    }
+
+    window->makeContextCurrent();
+    window->setPollEventsOnSwap(true);
+    renderer->setPipelined(false);
+}
+
+#endif // RIO_IS_WIN
+
+struct FrameTimes
+{
+    f64 calc;       // TaskMgr::calc()
+    f64 render;     // Renderer::render() and Window::swapBuffers() (Renderer::publish() with null graphics)
+    f64 total;
+};
+
+static void ReportFrameTimes(const char* name, std::vector<f64>& times)
+{
+    // Sorts "times"
+    std::sort(times.begin(), times.end());
+
+    f64 sum = 0.0;
+    for (f64 time : times)
+        sum += time;
+
+    const size_t num = times.size();
+    const auto percentile = [&times, num](u32 p) { return times[std::min(num - 1, num * p / 100)]; };
+
+    std::printf("  %-8s min: %8.3f, avg: %8.3f, p50: %8.3f, p95: %8.3f, p99: %8.3f, max: %8.3f\n",
+            name, times.front(), sum / num, percentile(50), percentile(95), percentile(99), times.back());
+}
+
+static void WriteFrameTimes(const std::vector<FrameTimes>& frames)
+{
+    rio::FileHandle handle;
+    if (!rio::FileDeviceMgr::instance()->tryOpen(&handle, sHeadlessReportPath, rio::FileDevice::FILE_OPEN_FLAG_CREATE))
+    {
+        RIO_LOG("rio::EnterMainLoop: Could not open \"%s\".\n", sHeadlessReportPath.c_str());
+        return;
+    }
+
+    std::string text = "frame,calc_ms,render_ms,total_ms\n";
+    char line[128];
+
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        std::snprintf(line, sizeof(line), "%u,%.4f,%.4f,%.4f\n", u32(i), frames[i].calc, frames[i].render, frames[i].total);
+        text += line;
+    }
+
+    handle.write(reinterpret_cast<const u8*>(text.data()), text.size());
+}
+
+class StartupTimer
+{
+    // Measures the time taken by each step of rio::Initialize()
+
+    typedef std::chrono::steady_clock Clock;
+    typedef std::chrono::duration<f64, std::milli> DurationMs;
+
+public:
+    StartupTimer()
+        : mBegin(Clock::now())
+        , mLast(mBegin)
+        , mStepNum(0)
+    {
+    }
+
+    // End the current step
+    void step(const char* name)
+    {
+        const Clock::time_point now = Clock::now();
+
+        if (mStepNum < cStepMax)
+        {
+            mSteps[mStepNum].name = name;
+            mSteps[mStepNum].ms = DurationMs(now - mLast).count();
+            mStepNum++;
+        }
+
+        mLast = now;
+    }
+
+    void print() const
+    {
+        // Printed in release builds as well, unlike RIO_LOG()
+        std::printf("rio::Initialize: Startup took %.3f ms:\n", DurationMs(mLast - mBegin).count());
+
+        for (u32 i = 0; i < mStepNum; i++)
+            std::printf("  %-20s %8.3f ms\n", mSteps[i].name, mSteps[i].ms);
+
+        const u32 preload_num = rio::FileDeviceMgr::instance()->getPreloadNum();
+        if (preload_num > 0)
+            std::printf("  %u preloaded file(s) not taken yet\n", preload_num);
+    }
+
+private:
+    static constexpr u32 cStepMax = 16;
+
+    struct Step
+    {
+        const char* name;
+        f64         ms;
+    };
+
+    Clock::time_point   mBegin;
+    Clock::time_point   mLast;
+    Step                mSteps[cStepMax];
+    u32                 mStepNum;
+};
+
+static void StartPreloads(const rio::InitializeArg& arg)
+{
+    // Read files needed by the managers on background threads, while the main thread creates the window
+    // and its context (Which cannot be moved off the main thread). They are taken by the managers' own loads.
+
+    rio::FileDeviceMgr* const file_device_mgr = rio::FileDeviceMgr::instance();
+    if (!arg.startup.preload)
+        return;
+
+    if (arg.headless.mode != rio::HEADLESS_MODE_NULL)
+    {
+        // Same paths as Shader::load()
+        const std::string base_path = std::string("shaders/") + arg.primitive_renderer.shader_path;
+#if RIO_IS_CAFE
+        file_device_mgr->preload(base_path + ".gsh");
+#elif RIO_IS_WIN
+        file_device_mgr->preload(base_path + ".vert");
+        file_device_mgr->preload(base_path + ".frag");
+#endif
+    }
+
+#if RIO_IS_WIN
+    file_device_mgr->preload("gamecontrollerdb.txt");
+#endif // RIO_IS_WIN
+
+    for (u32 i = 0; i < arg.startup.preload_path_num; i++)
+        file_device_mgr->preload(arg.startup.preload_paths[i]);
+}
+
+static void EnterHeadlessMainLoop()
+{
+    typedef std::chrono::steady_clock Clock;
+    typedef std::chrono::duration<f64, std::milli> DurationMs;
+
+    rio::Window* const window = rio::Window::instance();
+    rio::TaskMgr* const task_mgr = rio::TaskMgr::instance();
+    rio::lyr::Renderer* const renderer = rio::lyr::Renderer::instance();
+
+    const bool null_graphics = window->isNull();
+
+    std::vector<FrameTimes> frames;
+    frames.reserve(sHeadlessFrameNum);
+
+    for (u32 i = 0; i < sHeadlessFrameNum && window->isRunning(); i++)
+    {
+        const Clock::time_point begin = Clock::now();
+
+        task_mgr->calc();
+
+        const Clock::time_point calc_end = Clock::now();
+
+        if (null_graphics)
+        {
+            renderer->publish();
+        }
+        else
+        {
+            renderer->render();
+            window->swapBuffers();
+        }
+
+        EndFrame();
+
+        const Clock::time_point end = Clock::now();
+
+        frames.push_back({
+            DurationMs(calc_end - begin).count(),
+            DurationMs(end - calc_end).count(),
+            DurationMs(end - begin).count()
+        });
+    }
+
+    if (frames.empty())
+        return;
+
+    // Printed in release builds as well, unlike RIO_LOG()
+    std::printf("rio::EnterMainLoop: Headless run of %u frame(s) (ms per frame):\n", u32(frames.size()));
+    {
+        std::vector<f64> times(frames.size());
+
+        for (size_t i = 0; i < frames.size(); i++)
+            times[i] = frames[i].calc;
+        ReportFrameTimes("calc", times);
+
+        for (size_t i = 0; i < frames.size(); i++)
+            times[i] = frames[i].render;
+        ReportFrameTimes(null_graphics ? "publish" : "render", times);
+
+        for (size_t i = 0; i < frames.size(); i++)
+            times[i] = frames[i].total;
+        ReportFrameTimes("total", times);
+    }
+
+    if (!sHeadlessReportPath.empty())
+        WriteFrameTimes(frames);
+}
+
+}
 
 namespace rio {
 
@@ -28,83 +402,200 @@ bool Initialize(const InitializeArg& arg)
     WHBLogUdpInit();
 #endif
 
+    StartupTimer timer;
+
+    // Create the heap manager
+    if (!HeapMgr::createSingleton(arg.heap.root_size))
+        return false;
+
+    // Create the per-frame allocator
+    if (arg.heap.frame_size > 0 && !FrameAllocator::createSingleton(arg.heap.frame_size))
+    {
+        HeapMgr::destroySingleton();
+        return false;
+    }
+
     // Create the file device manager
-    if (!FileDeviceMgr::createSingleton())
+    if (!FileDeviceMgr::createSingleton(arg.file_device_mgr.load_thread_num))
+    {
+        FrameAllocator::destroySingleton();
+        HeapMgr::destroySingleton();
         return false;
+    }
+
+    StartPreloads(arg);
+    timer.step("FileDeviceMgr");
 
     // Create the window
-    if (!Window::createSingleton(
-        arg.window.width, arg.window.height
+    if (arg.headless.mode == HEADLESS_MODE_NULL
+        ? !Window::createSingletonNull(arg.window.width, arg.window.height)
+        : !Window::createSingleton(
+            arg.window.width, arg.window.height
 #if RIO_IS_WIN
-        , arg.window.resizable
-        , arg.window.gl_major
-        , arg.window.gl_minor
+            , arg.window.resizable
+            , arg.window.gl_major
+            , arg.window.gl_minor
+            , arg.headless.mode == HEADLESS_MODE_NONE
 #endif // RIO_IS_WIN
-    ))
+        ))
     {
         FileDeviceMgr::destroySingleton();
+        FrameAllocator::destroySingleton();
+        HeapMgr::destroySingleton();
         return false;
     }
 
+    // Do not wait for the display when measuring frame times
+    if (arg.headless.mode == HEADLESS_MODE_OFFSCREEN)
+        Window::instance()->setSwapInterval(0);
+
+    timer.step("Window");
+
+    // Create the job system
+    if (!JobSystem::createSingleton(arg.job_system.worker_num))
+    {
+        Window::destroySingleton();
+        FileDeviceMgr::destroySingleton();
+        FrameAllocator::destroySingleton();
+        HeapMgr::destroySingleton();
+        return false;
+    }
+
+    timer.step("JobSystem");
+
     // Create the task manager
-    if (!TaskMgr::createSingleton())
+    if (!TaskMgr::createSingleton(arg.task_mgr.loader_thread_num))
     {
+        JobSystem::destroySingleton();
         Window::destroySingleton();
         FileDeviceMgr::destroySingleton();
+        FrameAllocator::destroySingleton();
+        HeapMgr::destroySingleton();
         return false;
     }
 
+    timer.step("TaskMgr");
+
     // Create the controller manager
     if (!ControllerMgr::createSingleton())
     {
         TaskMgr::destroySingleton();
+        JobSystem::destroySingleton();
         Window::destroySingleton();
         FileDeviceMgr::destroySingleton();
+        FrameAllocator::destroySingleton();
+        HeapMgr::destroySingleton();
         return false;
     }
 
-    // Create the primitive renderer
-    if (!PrimitiveRenderer::createSingleton(arg.primitive_renderer.shader_path))
+    timer.step("ControllerMgr");
+
+    // Create the primitive renderer (Not with null graphics)
+    if (arg.headless.mode != HEADLESS_MODE_NULL && !PrimitiveRenderer::createSingleton(arg.primitive_renderer.shader_path))
     {
         ControllerMgr::destroySingleton();
         TaskMgr::destroySingleton();
+        JobSystem::destroySingleton();
         Window::destroySingleton();
         FileDeviceMgr::destroySingleton();
+        FrameAllocator::destroySingleton();
+        HeapMgr::destroySingleton();
         return false;
     }
 
+    timer.step("PrimitiveRenderer");
+
     // Create the renderer instance
     if (!lyr::Renderer::createSingleton())
     {
         PrimitiveRenderer::destroySingleton();
         ControllerMgr::destroySingleton();
         TaskMgr::destroySingleton();
+        JobSystem::destroySingleton();
         Window::destroySingleton();
         FileDeviceMgr::destroySingleton();
+        FrameAllocator::destroySingleton();
+        HeapMgr::destroySingleton();
+        return false;
+    }
+
+    timer.step("lyr::Renderer");
+
+    // Create the resource cache instance
+    if (!ResourceCache::createSingleton(arg.resource_cache.budget))
+    {
+        lyr::Renderer::destroySingleton();
+        PrimitiveRenderer::destroySingleton();
+        ControllerMgr::destroySingleton();
+        TaskMgr::destroySingleton();
+        JobSystem::destroySingleton();
+        Window::destroySingleton();
+        FileDeviceMgr::destroySingleton();
+        FrameAllocator::destroySingleton();
+        HeapMgr::destroySingleton();
         return false;
     }
 
     // Create the model cacher instance
     if (!mdl::res::ModelCacher::createSingleton())
     {
+        ResourceCache::destroySingleton();
         lyr::Renderer::destroySingleton();
         PrimitiveRenderer::destroySingleton();
         ControllerMgr::destroySingleton();
         TaskMgr::destroySingleton();
+        JobSystem::destroySingleton();
         Window::destroySingleton();
         FileDeviceMgr::destroySingleton();
+        FrameAllocator::destroySingleton();
+        HeapMgr::destroySingleton();
         return false;
     }
 
+    timer.step("ModelCacher");
+
     // Create the audio manager instance
     if (!AudioMgr::createSingleton())
         RIO_LOG("rio::Initialize: Failed to create AudioMgr.\n");
 
+    timer.step("AudioMgr");
+
+    if (arg.startup.print_report)
+        timer.print();
+
+    // Enabled once nothing can destroy the job system before Exit()
+    Decompressor::setParallel(arg.job_system.parallel_decompression);
+
+    sHeadlessMode = arg.headless.mode;
+    sHeadlessFrameNum = arg.headless.frame_num;
+    sHeadlessReportPath = arg.headless.report_path ? arg.headless.report_path : "";
+
+#if RIO_IS_WIN
+    sPipelinedMainLoop = arg.main_loop.pipelined && sHeadlessMode == HEADLESS_MODE_NONE;
+#else
+    if (arg.main_loop.pipelined)
+        RIO_LOG("rio::Initialize: Pipelined main loop is not supported on this platform.\n");
+#endif // RIO_IS_WIN
+
     return true;
 }
 
 void EnterMainLoop()
 {
+    if (sHeadlessMode != HEADLESS_MODE_NONE)
+    {
+        EnterHeadlessMainLoop();
+        return;
+    }
+
+#if RIO_IS_WIN
+    if (sPipelinedMainLoop)
+    {
+        EnterPipelinedMainLoop();
+        return;
+    }
+#endif // RIO_IS_WIN
+
     // Get window instance
     Window* window = Window::instance();
 
@@ -119,6 +610,9 @@ void EnterMainLoop()
 
         // Swap the front and back buffers
         window->swapBuffers();
+
+        // Start the next frame's transient allocations and allocation counters
+        EndFrame();
     }
 }
 
@@ -137,6 +631,9 @@ void Exit()
     // Destroy the model cacher instance upon quitting
     mdl::res::ModelCacher::destroySingleton();
 
+    // Destroy the resource cache instance upon quitting
+    ResourceCache::destroySingleton();
+
     // Destroy the renderer instance upon quitting
     lyr::Renderer::destroySingleton();
 
@@ -149,11 +646,27 @@ void Exit()
     // Destroy the task manager upon quitting
     TaskMgr::destroySingleton();
 
+    // Loads still running may be decompressing on the job system
+    if (Decompressor::isParallel())
+    {
+        Decompressor::setParallel(false);
+        FileDeviceMgr::instance()->waitPreloads();
+    }
+
+    // Destroy the job system upon quitting
+    JobSystem::destroySingleton();
+
     // Destroy the window upon quitting
     Window::destroySingleton();
 
     // Destroy the file device manager upon quitting
     FileDeviceMgr::destroySingleton();
+
+    // Destroy the per-frame allocator upon quitting
+    FrameAllocator::destroySingleton();
+
+    // Destroy the heap manager upon quitting
+    HeapMgr::destroySingleton();
 }
 
 } // namespace rio
@@ -6,6 +6,12 @@ ITask::ITask(const char* name)
     : mTaskListNode(this)
     , mName(name)
     , mState(STATE_CREATED)
+    , mFlags(0)
+    , mAsyncPrepareState(ASYNC_PREPARE_NONE)
+    , mDependencies()
+    , mDependents()
+    , mGraphIndex(-1)
+    , mPool(nullptr)
 {
 }
 
@@ -1,15 +1,22 @@
+#include <filedevice/rio_FileDeviceMgr.h>
 #include <task/rio_TaskMgr.h>
+#include <task/rio_TaskProfiler.h>
+#include <thread/rio_JobSystem.h>
+#include <thread/rio_WorkQueue.h>
+
+#include <algorithm>
 
 namespace rio {
 
 TaskMgr* TaskMgr::sInstance = nullptr;
+std::atomic<u32> TaskMgr::sTaskTypeNum(0);
 
-bool TaskMgr::createSingleton()
+bool TaskMgr::createSingleton(u32 loader_thread_num)
 {
     if (sInstance)
         return false;
 
-    sInstance = new TaskMgr;
+    sInstance = new TaskMgr(loader_thread_num);
     return true;
 }
 
@@ -22,13 +29,120 @@ void TaskMgr::destroySingleton()
     sInstance = nullptr;
 }
 
+TaskMgr::TaskMgr(u32 loader_thread_num)
+    : mGraphDirty(true)
+    , mLoaderQueue(nullptr)
+{
+    if (loader_thread_num > 0)
+        mLoaderQueue = new WorkQueue(loader_thread_num, "rio::TaskMgr::Loader");
+
+#ifdef RIO_TASK_PROFILE
+    TaskProfiler::createSingleton();
+#endif // RIO_TASK_PROFILE
+}
+
+TaskMgr::~TaskMgr()
+{
+    if (mLoaderQueue)
+    {
+        delete mLoaderQueue;
+        mLoaderQueue = nullptr;
+    }
+
+#ifdef RIO_TASK_PROFILE
+    TaskProfiler::destroySingleton();
+#endif // RIO_TASK_PROFILE
+
+    for (TaskPool* pool : mTaskPools)
+    {
+        if (!pool)
+            continue;
+
+        // Tasks that were never destroyed keep their storage
+        const u32 used_num = pool->getUsedNum();
+        if (used_num > 0)
+        {
+            TaskPool::Stats stats;
+            pool->getStats(&stats);
+            RIO_LOG("TaskMgr: %u task(s) of pool \"%s\" were not destroyed\n", used_num, stats.name ? stats.name : "");
+            continue;
+        }
+
+        delete pool;
+    }
+
+    mTaskPools.clear();
+}
+
+u32 TaskMgr::getTaskPoolNum() const
+{
+    std::lock_guard<std::mutex> lock(mPoolCS);
+    return mTaskPools.size();
+}
+
+bool TaskMgr::getTaskPoolStats(u32 index, TaskPool::Stats* stats) const
+{
+    RIO_ASSERT(stats);
+
+    std::lock_guard<std::mutex> lock(mPoolCS);
+
+    if (index >= mTaskPools.size() || !mTaskPools[index])
+        return false;
+
+    mTaskPools[index]->getStats(stats);
+    return true;
+}
+
+void TaskMgr::printTaskPoolStats() const
+{
+    std::lock_guard<std::mutex> lock(mPoolCS);
+
+    RIO_LOG("TaskMgr: task pools\n");
+
+    for (const TaskPool* pool : mTaskPools)
+    {
+        if (!pool)
+            continue;
+
+        TaskPool::Stats stats;
+        pool->getStats(&stats);
+
+        RIO_LOG("  %-32s size: %5u, used: %5u / %5u (peak: %5u), chunks: %u\n",
+                stats.name ? stats.name : "", stats.object_size, stats.used_num,
+                stats.capacity, stats.peak_used_num, stats.chunk_num);
+    }
+}
+
+TaskPool* TaskMgr::getTaskPool_(u32 type_index, size_t size, size_t alignment)
+{
+    std::lock_guard<std::mutex> lock(mPoolCS);
+
+    if (type_index >= mTaskPools.size())
+        mTaskPools.resize(type_index + 1, nullptr);
+
+    TaskPool*& pool = mTaskPools[type_index];
+    if (!pool)
+        pool = new TaskPool(size, alignment);
+
+    return pool;
+}
+
+void TaskMgr::freeTask_(ITask* task)
+{
+    TaskPool* pool = task->mPool;
+    RIO_ASSERT(pool);
+
+    task->~ITask();
+    pool->free(task);
+}
+
 bool TaskMgr::destroyTask(ITask* task)
 {
     if (changeTaskState_(task, ITask::STATE_DESTROYABLE))
     {
         if (changeTaskState_(task, ITask::STATE_DEAD))
         {
-            delete task;
+            freeTask_(task);
             return true;
         }
     }
@@ -41,31 +155,367 @@ bool TaskMgr::requestDestroyTask(ITask* task)
     return changeTaskState_(task, ITask::STATE_DESTROYABLE);
 }
 
+bool TaskMgr::addDependency(ITask* task, ITask* dependency)
+{
+    RIO_ASSERT(task && dependency);
+
+    if (task == dependency)
+    {
+        RIO_ASSERT(false);
+        return false;
+    }
+
+    for (const ITask* dep : task->mDependencies)
+        if (dep == dependency)
+            return false;
+
+    task->mDependencies.push_back(dependency);
+    dependency->mDependents.push_back(task);
+
+    mGraphDirty = true;
+    return true;
+}
+
+bool TaskMgr::removeDependency(ITask* task, ITask* dependency)
+{
+    RIO_ASSERT(task && dependency);
+
+    std::vector<ITask*>& dependencies = task->mDependencies;
+    std::vector<ITask*>::iterator it = std::find(dependencies.begin(), dependencies.end(), dependency);
+    if (it == dependencies.end())
+        return false;
+
+    dependencies.erase(it);
+
+    std::vector<ITask*>& dependents = dependency->mDependents;
+    dependents.erase(std::find(dependents.begin(), dependents.end(), task));
+
+    mGraphDirty = true;
+    return true;
+}
+
+void TaskMgr::unlinkDependencies_(ITask* task)
+{
+    if (task->mDependencies.empty() && task->mDependents.empty())
+        return;
+
+    for (ITask* dependency : task->mDependencies)
+    {
+        std::vector<ITask*>& dependents = dependency->mDependents;
+        dependents.erase(std::find(dependents.begin(), dependents.end(), task));
+    }
+
+    for (ITask* dependent : task->mDependents)
+    {
+        std::vector<ITask*>& dependencies = dependent->mDependencies;
+        dependencies.erase(std::find(dependencies.begin(), dependencies.end(), task));
+    }
+
+    task->mDependencies.clear();
+    task->mDependents.clear();
+
+    mGraphDirty = true;
+}
+
 void TaskMgr::calc()
 {
-    for (ITask::List::iterator it = mPrepareList.begin(); it != mPrepareList.end(); )
+    calcPrepare();
+    calcActive();
+    calcDestroy();
+}
+
+void TaskMgr::calcPrepare()
+{
+    RIO_TASK_PROFILE_SCOPE("TaskMgr::calcPrepare", STAGE_FRAME);
+
+    // Complete asynchronous file loads first, so that their callbacks can create tasks prepared right away
+    FileDeviceMgr* file_device_mgr = FileDeviceMgr::instance();
+    if (file_device_mgr)
+        file_device_mgr->calcLoadAsync();
+
+    // Loader threads can create tasks while the list is walked, so it is walked under lock
+    ITask::List::iterator it = mPrepareList.end();
     {
-        ITask* task = *it;
-        task->prepare_();
-        ++it;
+        std::lock_guard<std::mutex> lock(mListCS);
+        it = mPrepareList.begin();
+    }
+
+    while (true)
+    {
+        ITask* task;
+        {
+            std::lock_guard<std::mutex> lock(mListCS);
+            if (it == mPrepareList.end())
+                break;
+
+            task = *it;
+            ++it;
+        }
+
+        if (task->isAsyncPrepare() && mLoaderQueue)
+        {
+            switch (task->mAsyncPrepareState.load(std::memory_order_acquire))
+            {
+            case ITask::ASYNC_PREPARE_NONE:
+                task->mAsyncPrepareState.store(ITask::ASYNC_PREPARE_QUEUED, std::memory_order_relaxed);
+                mLoaderQueue->push(&TaskMgr::prepareAsync_, task);
+                continue;
+            case ITask::ASYNC_PREPARE_QUEUED:
+                continue;
+            default:
+                break;
+            }
+        }
+        else
+        {
+            RIO_TASK_PROFILE_SCOPE(task->getName(), STAGE_PREPARE);
+            task->prepare_();
+        }
 
         changeTaskState_(task, ITask::STATE_RUNNING);
     }
+}
 
-    for (ITask::List::iterator it = mActiveList.begin(); it != mActiveList.end(); ++it)
-        (*it)->calc_();
+void TaskMgr::calcActive()
+{
+    RIO_TASK_PROFILE_SCOPE("TaskMgr::calcActive", STAGE_FRAME);
 
-    for (ITask::List::iterator it = mDestroyableList.begin(); it != mDestroyableList.end(); )
+    // Serial tasks are calculated in list order, parallel tasks are gathered for later
+    mParallelTasks.clear();
+
+    for (ITask::List::iterator it = mActiveList.begin(); it != mActiveList.end(); )
     {
+        // Advance first, calc_() may request the task's own destruction
         ITask* task = *it;
         ++it;
 
-        if (changeTaskState_(task, ITask::STATE_DEAD))
+        if (task->isParallelCalc())
+            mParallelTasks.push_back(task);
+
+        else
         {
-            task->~ITask();
-            delete task;
+            RIO_TASK_PROFILE_SCOPE(task->getName(), STAGE_CALC);
+            task->calc_();
         }
     }
+
+    if (!mParallelTasks.empty())
+        calcParallel_();
+}
+
+void TaskMgr::calcDestroy()
+{
+    {
+        RIO_TASK_PROFILE_SCOPE("TaskMgr::calcDestroy", STAGE_FRAME);
+
+        for (ITask::List::iterator it = mDestroyableList.begin(); it != mDestroyableList.end(); )
+        {
+            ITask* task = *it;
+            ++it;
+
+            if (changeTaskState_(task, ITask::STATE_DEAD))
+                freeTask_(task);
+        }
+    }
+
+#ifdef RIO_TASK_PROFILE
+    TaskProfiler::instance()->endFrame();
+#endif // RIO_TASK_PROFILE
+}
+
+void TaskMgr::prepareAsync_(void* arg)
+{
+    ITask* task = static_cast<ITask*>(arg);
+    {
+        RIO_TASK_PROFILE_SCOPE(task->getName(), STAGE_PREPARE);
+        task->prepare_();
+    }
+    task->mAsyncPrepareState.store(ITask::ASYNC_PREPARE_DONE, std::memory_order_release);
+}
+
+void TaskMgr::buildGraph_()
+{
+    mGraphDirty = false;
+    mGraphTasks = mParallelTasks;
+
+    const u32 task_num = mGraphTasks.size();
+    for (u32 i = 0; i < task_num; i++)
+        mGraphTasks[i]->mGraphIndex = i;
+
+    const auto get_graph_index = [this, task_num](const ITask* task) -> s32
+    {
+        const s32 index = task->mGraphIndex;
+        if (index >= 0 && u32(index) < task_num && mGraphTasks[index] == task)
+            return index;
+
+        return -1;
+    };
+
+    // Count the dependencies within the graph
+    // (Dependencies on serial or non-running tasks are already satisfied)
+    std::vector<u32> dependency_num(task_num, 0);
+    for (u32 i = 0; i < task_num; i++)
+        for (const ITask* dependency : mGraphTasks[i]->mDependencies)
+            if (get_graph_index(dependency) >= 0)
+                dependency_num[i]++;
+
+#ifdef RIO_DEBUG
+    for (ITask::List::iterator it = mActiveList.begin(); it != mActiveList.end(); ++it)
+    {
+        const ITask* task = *it;
+        if (task->isParallelCalc())
+            continue;
+
+        for (const ITask* dependency : task->mDependencies)
+            if (get_graph_index(dependency) >= 0)
+                RIO_LOG("TaskMgr::buildGraph_(): Serial task \"%s\" cannot run after parallel task \"%s\".\n", task->getName(), dependency->getName());
+    }
+#endif // RIO_DEBUG
+
+    // Topologically level the graph (Kahn's algorithm)
+    std::vector<u32> level(task_num, 0);
+    std::vector<u32> ready;
+    ready.reserve(task_num);
+
+    for (u32 i = 0; i < task_num; i++)
+        if (dependency_num[i] == 0)
+            ready.push_back(i);
+
+    u32 level_num = task_num > 0 ? 1 : 0;
+
+    for (u32 i = 0; i < ready.size(); i++)
+    {
+        const u32 index = ready[i];
+
+        for (const ITask* dependent : mGraphTasks[index]->mDependents)
+        {
+            const s32 dependent_index = get_graph_index(dependent);
+            if (dependent_index < 0)
+                continue;
+
+            if (level[dependent_index] < level[index] + 1)
+            {
+                level[dependent_index] = level[index] + 1;
+                if (level_num < level[dependent_index] + 1)
+                    level_num = level[dependent_index] + 1;
+            }
+
+            if (--dependency_num[dependent_index] == 0)
+                ready.push_back(dependent_index);
+        }
+    }
+
+    if (ready.size() < task_num)
+    {
+        // Tasks in a cycle are calculated one after another, after everything else
+        RIO_LOG("TaskMgr::buildGraph_(): Dependency cycle between %u task(s).\n", u32(task_num - ready.size()));
+        RIO_ASSERT(false);
+
+        for (u32 i = 0; i < task_num; i++)
+            if (dependency_num[i] > 0)
+                level[i] = level_num++;
+    }
+
+    // Sort the tasks by level, keeping list order within a level
+    mLevelTasks.clear();
+    mLevelTasks.reserve(task_num);
+
+    std::vector<u32> level_offsets(level_num + 1, 0);
+    for (u32 i = 0; i < task_num; i++)
+        level_offsets[level[i] + 1]++;
+
+    for (u32 i = 0; i < level_num; i++)
+        level_offsets[i + 1] += level_offsets[i];
+
+    mLevelTasks.resize(task_num);
+    {
+        std::vector<u32> insert_offsets(level_offsets.begin(), level_offsets.end() - 1);
+        for (u32 i = 0; i < task_num; i++)
+            mLevelTasks[insert_offsets[level[i]]++] = mGraphTasks[i];
+    }
+
+    // Split each level into batches
+    JobSystem* const job_system = JobSystem::instance();
+    const u32 thread_num = job_system ? job_system->getThreadNum() : 1;
+
+    mParallelBatches.clear();
+    mLevelBatchOffsets.clear();
+
+    for (u32 i = 0; i < level_num; i++)
+    {
+        mLevelBatchOffsets.push_back(mParallelBatches.size());
+
+        const u32 level_task_num = level_offsets[i + 1] - level_offsets[i];
+
+        u32 batch_size = level_task_num / thread_num;
+        if (batch_size == 0)
+            batch_size = 1;
+        else if (batch_size > cParallelCalcBatchSize)
+            batch_size = cParallelCalcBatchSize;
+
+        for (u32 j = 0; j < level_task_num; j += batch_size)
+        {
+            const u32 num = level_task_num - j < batch_size ? level_task_num - j
+                                                            : batch_size;
+            mParallelBatches.push_back({ mLevelTasks.data() + level_offsets[i] + j, num });
+        }
+    }
+
+    mLevelBatchOffsets.push_back(mParallelBatches.size());
+}
+
+void TaskMgr::calcParallel_()
+{
+    // Rebuild the graph only if tasks or dependencies changed
+    if (mGraphDirty || mParallelTasks != mGraphTasks)
+        buildGraph_();
+
+    JobSystem* const job_system = JobSystem::instance();
+
+    if (!job_system || job_system->getThreadNum() == 1)
+    {
+        for (ITask* task : mLevelTasks)
+        {
+            RIO_TASK_PROFILE_SCOPE(task->getName(), STAGE_CALC);
+            task->calc_();
+        }
+
+        return;
+    }
+
+    JobSystem::Counter counter;
+
+    const u32 level_num = mLevelBatchOffsets.size() - 1;
+    for (u32 i = 0; i < level_num; i++)
+    {
+        const u32 batch_begin = mLevelBatchOffsets[i];
+        const u32 batch_end = mLevelBatchOffsets[i + 1];
+
+        if (batch_end - batch_begin == 1)
+        {
+            calcParallelBatch_(&mParallelBatches[batch_begin]);
+            continue;
+        }
+
+        for (u32 j = batch_begin; j < batch_end; j++)
+            job_system->push(&TaskMgr::calcParallelBatch_, &mParallelBatches[j], &counter);
+
+        // Join the level before starting the next one (and before the render phase)
+        job_system->wait(&counter);
+    }
+}
+
+void TaskMgr::calcParallelBatch_(void* arg)
+{
+    const ParallelCalcBatch& batch = *static_cast<const ParallelCalcBatch*>(arg);
+
+    for (u32 i = 0; i < batch.num; i++)
+    {
+        ITask* task = batch.tasks[i];
+
+        RIO_TASK_PROFILE_SCOPE(task->getName(), STAGE_CALC);
+        task->calc_();
+    }
 }
 
 bool TaskMgr::changeTaskState_(ITask* task, ITask::State state)
@@ -80,8 +530,11 @@ bool TaskMgr::changeTaskState_(ITask* task, ITask::State state)
         RIO_ASSERT(curr_state == ITask::STATE_CREATED);
 
         task->mState = ITask::STATE_PREPARE;
-        task->mTaskListNode.erase();
-        mPrepareList.pushBack(&task->mTaskListNode);
+        {
+            std::lock_guard<std::mutex> lock(mListCS);
+            task->mTaskListNode.erase();
+            mPrepareList.pushBack(&task->mTaskListNode);
+        }
 
         break;
 
@@ -89,28 +542,47 @@ bool TaskMgr::changeTaskState_(ITask* task, ITask::State state)
         RIO_ASSERT(curr_state == ITask::STATE_PREPARE);
 
         task->mState = ITask::STATE_RUNNING;
-        task->mTaskListNode.erase();
-        mActiveList.pushBack(&task->mTaskListNode);
+        {
+            std::lock_guard<std::mutex> lock(mListCS);
+            task->mTaskListNode.erase();
+            mActiveList.pushBack(&task->mTaskListNode);
+        }
 
-        task->enter_();
+        {
+            RIO_TASK_PROFILE_SCOPE(task->getName(), STAGE_ENTER);
+            task->enter_();
+        }
 
         break;
 
     case ITask::STATE_DESTROYABLE:
-        if (curr_state != ITask::STATE_RUNNING)
-            return false;
-
-        task->mState = ITask::STATE_DESTROYABLE;
-        task->mTaskListNode.erase();
-        mDestroyableList.pushBack(&task->mTaskListNode);
+        {
+            // Several parallel calc_() may request it at once, only the first one moves the task
+            ITask::State running = ITask::STATE_RUNNING;
+            if (!task->mState.compare_exchange_strong(running, ITask::STATE_DESTROYABLE))
+                return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mListCS);
+            task->mTaskListNode.erase();
+            mDestroyableList.pushBack(&task->mTaskListNode);
+        }
 
         break;
 
     case ITask::STATE_DEAD:
-        task->exit_();
+        {
+            RIO_TASK_PROFILE_SCOPE(task->getName(), STAGE_EXIT);
+            task->exit_();
+        }
+
+        unlinkDependencies_(task);
 
         task->mState = ITask::STATE_DEAD;
-        task->mTaskListNode.erase();
+        {
+            std::lock_guard<std::mutex> lock(mListCS);
+            task->mTaskListNode.erase();
+        }
 
         break;
 
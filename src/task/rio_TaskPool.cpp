@@ -0,0 +1,118 @@
+#include <heap/rio_MemTracker.h>
+#include <misc/rio_MemUtil.h>
+#include <task/rio_TaskPool.h>
+
+namespace {
+
+static inline u32 align(u32 x, u32 y)
+{
+    RIO_ASSERT(((y - 1) & y) == 0);
+    return (x + y - 1) & -y;
+}
+
+}
+
+namespace rio {
+
+TaskPool::TaskPool(size_t object_size, size_t alignment)
+    : mObjectSize(align(object_size < sizeof(FreeNode) ? sizeof(FreeNode) : object_size, alignment))
+    , mAlignment(alignment)
+    , mName(nullptr)
+    , mFreeList(nullptr)
+    , mChunks()
+    , mCapacity(0)
+    , mUsedNum(0)
+    , mPeakUsedNum(0)
+{
+}
+
+TaskPool::~TaskPool()
+{
+    for (void* chunk : mChunks)
+        MemUtil::free(chunk);
+
+    mChunks.clear();
+}
+
+void* TaskPool::alloc()
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    if (!mFreeList)
+        allocChunk_();
+
+    FreeNode* node = mFreeList;
+    mFreeList = node->next;
+
+    if (++mUsedNum > mPeakUsedNum)
+        mPeakUsedNum = mUsedNum;
+
+    return node;
+}
+
+void TaskPool::free(void* ptr)
+{
+    RIO_ASSERT(ptr);
+
+    std::lock_guard<std::mutex> lock(mCS);
+
+    RIO_ASSERT(mUsedNum > 0);
+    mUsedNum--;
+
+    FreeNode* node = static_cast<FreeNode*>(ptr);
+    node->next = mFreeList;
+    mFreeList = node;
+}
+
+u32 TaskPool::getUsedNum() const
+{
+    std::lock_guard<std::mutex> lock(mCS);
+    return mUsedNum;
+}
+
+void TaskPool::allocChunk_()
+{
+    // Chunks double in size (1, 2, 4, ...) so that pools of rarely created tasks stay small
+    const u32 chunk_index = mChunks.size();
+    const u32 object_num = chunk_index < 8 ? 1u << chunk_index : cChunkObjectNumMax;
+
+    ScopedMemTag mem_tag("Task");
+
+    u8* const chunk = static_cast<u8*>(MemUtil::alloc(mObjectSize * object_num, mAlignment));
+    RIO_ASSERT(chunk);
+
+    mChunks.push_back(chunk);
+    mCapacity += object_num;
+
+    // Link the slots in address order
+    for (u32 i = object_num; i > 0; i--)
+    {
+        FreeNode* node = reinterpret_cast<FreeNode*>(chunk + (i - 1) * mObjectSize);
+        node->next = mFreeList;
+        mFreeList = node;
+    }
+}
+
+void TaskPool::setName(const char* name)
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    if (!mName)
+        mName = name;
+}
+
+void TaskPool::getStats(Stats* stats) const
+{
+    RIO_ASSERT(stats);
+
+    std::lock_guard<std::mutex> lock(mCS);
+
+    stats->name = mName;
+    stats->object_size = mObjectSize;
+    stats->capacity = mCapacity;
+    stats->used_num = mUsedNum;
+    stats->peak_used_num = mPeakUsedNum;
+    stats->chunk_num = mChunks.size();
+}
+
+}
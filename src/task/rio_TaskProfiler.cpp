@@ -0,0 +1,296 @@
+#include <task/rio_TaskProfiler.h>
+
+#ifdef RIO_TASK_PROFILE
+
+#include <filedevice/rio_FileDeviceMgr.h>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+static std::atomic<u32> sProfilerID(0);
+
+// Buffer of the current thread, valid while sThreadBufferOwner matches the profiler's ID
+static thread_local void* sThreadBuffer = nullptr;
+static thread_local u32 sThreadBufferOwner = 0;
+
+}
+
+namespace rio {
+
+TaskProfiler* TaskProfiler::sInstance = nullptr;
+
+bool TaskProfiler::createSingleton()
+{
+    if (sInstance)
+        return false;
+
+    sInstance = new TaskProfiler();
+    return true;
+}
+
+void TaskProfiler::destroySingleton()
+{
+    if (!sInstance)
+        return;
+
+    delete sInstance;
+    sInstance = nullptr;
+}
+
+TaskProfiler::TaskProfiler()
+    : mID(sProfilerID.fetch_add(1, std::memory_order_relaxed) + 1)
+    , mStartTime(now_())
+    , mDroppedEventNum(0)
+    , mFrameNum(0)
+    , mTraceFirstEvent(true)
+{
+    // The creating thread (Main thread) gets the first thread ID
+    getThreadBuffer_();
+
+    mDrainBuffer.reserve(cThreadEventCapacity);
+}
+
+TaskProfiler::~TaskProfiler()
+{
+    stopTrace();
+
+    for (ThreadBuffer* buffer : mThreadBuffers)
+        delete buffer;
+
+    mThreadBuffers.clear();
+}
+
+TaskProfiler::ThreadBuffer* TaskProfiler::getThreadBuffer_()
+{
+    if (sThreadBufferOwner == mID)
+        return static_cast<ThreadBuffer*>(sThreadBuffer);
+
+    // First event of this thread: allocate its buffer once
+    ThreadBuffer* buffer = new ThreadBuffer;
+    buffer->num = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mThreadBufferCS);
+        buffer->index = mThreadBuffers.size();
+        mThreadBuffers.push_back(buffer);
+    }
+
+    sThreadBuffer = buffer;
+    sThreadBufferOwner = mID;
+    return buffer;
+}
+
+void TaskProfiler::record(const char* name, Stage stage, u64 begin_ns, u64 end_ns)
+{
+    ThreadBuffer* buffer = getThreadBuffer_();
+
+    std::lock_guard<std::mutex> lock(buffer->cs);
+
+    if (buffer->num == cThreadEventCapacity)
+    {
+        mDroppedEventNum.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Event& event = buffer->events[buffer->num++];
+    event.name = name;
+    event.stage = stage;
+    event.begin_ns = begin_ns;
+    event.end_ns = end_ns;
+}
+
+void TaskProfiler::endFrame()
+{
+    mFrameNum++;
+
+    std::vector<ThreadBuffer*> buffers;
+    {
+        std::lock_guard<std::mutex> lock(mThreadBufferCS);
+        buffers = mThreadBuffers;
+    }
+
+    for (ThreadBuffer* buffer : buffers)
+    {
+        // Copy out, to hold the lock as briefly as possible
+        {
+            std::lock_guard<std::mutex> lock(buffer->cs);
+            mDrainBuffer.assign(buffer->events, buffer->events + buffer->num);
+            buffer->num = 0;
+        }
+
+        for (const Event& event : mDrainBuffer)
+        {
+            const StatsKey key = { event.name, event.stage };
+
+            std::unordered_map<StatsKey, StatsEntry, StatsKeyHash>::iterator it = mStats.find(key);
+            if (it == mStats.end())
+            {
+                StatsEntry entry;
+                entry.stats.name = event.name;
+                entry.stats.stage = Stage(event.stage);
+                entry.stats.frame_num = 0;
+                entry.stats.call_num = 0;
+                entry.stats.last_ns = 0;
+                entry.stats.min_ns = UINT64_MAX;
+                entry.stats.max_ns = 0;
+                entry.stats.total_ns = 0;
+                entry.frame_ns = 0;
+                entry.frame_call_num = 0;
+
+                it = mStats.emplace(key, entry).first;
+            }
+
+            StatsEntry& entry = it->second;
+            if (entry.frame_call_num == 0)
+                mFrameStats.push_back(&entry);
+
+            entry.frame_ns += event.end_ns - event.begin_ns;
+            entry.frame_call_num++;
+        }
+
+        if (isTracing())
+            writeTrace_(mDrainBuffer.data(), mDrainBuffer.size(), buffer->index);
+    }
+
+    for (StatsEntry* entry : mFrameStats)
+    {
+        Stats& stats = entry->stats;
+        const u64 frame_ns = entry->frame_ns;
+
+        stats.frame_num++;
+        stats.call_num += entry->frame_call_num;
+        stats.last_ns = frame_ns;
+        stats.min_ns = std::min(stats.min_ns, frame_ns);
+        stats.max_ns = std::max(stats.max_ns, frame_ns);
+        stats.total_ns += frame_ns;
+
+        entry->frame_ns = 0;
+        entry->frame_call_num = 0;
+    }
+
+    mFrameStats.clear();
+}
+
+void TaskProfiler::getStats(std::vector<Stats>* stats) const
+{
+    RIO_ASSERT(stats);
+
+    stats->clear();
+    stats->reserve(mStats.size());
+
+    for (const auto& it : mStats)
+        stats->push_back(it.second.stats);
+
+    std::sort(stats->begin(), stats->end(), [](const Stats& lhs, const Stats& rhs)
+    {
+        return lhs.total_ns * rhs.frame_num > rhs.total_ns * lhs.frame_num;
+    });
+}
+
+void TaskProfiler::printStats() const
+{
+    std::vector<Stats> stats;
+    getStats(&stats);
+
+    RIO_LOG("TaskProfiler: %u frame(s), %u dropped event(s)\n", mFrameNum, getDroppedEventNum());
+    RIO_LOG("  %-32s %-8s %8s %10s %10s %10s %10s\n", "Task", "Stage", "Frames", "Calls", "Min (us)", "Avg (us)", "Max (us)");
+
+    for (const Stats& s : stats)
+    {
+        [[maybe_unused]] const f64 avg_ns = f64(s.total_ns) / s.frame_num;
+
+        RIO_LOG("  %-32s %-8s %8u %10u %10.1f %10.1f %10.1f\n",
+                s.name ? s.name : "", getStageName(s.stage), s.frame_num, s.call_num,
+                s.min_ns / 1000.0, avg_ns / 1000.0, s.max_ns / 1000.0);
+    }
+}
+
+void TaskProfiler::resetStats()
+{
+    mStats.clear();
+    mFrameStats.clear();
+    mFrameNum = 0;
+    mDroppedEventNum.store(0, std::memory_order_relaxed);
+}
+
+bool TaskProfiler::startTrace(const std::string& path)
+{
+    stopTrace();
+
+    if (!FileDeviceMgr::instance()->tryOpen(&mTraceHandle, path, FileDevice::FILE_OPEN_FLAG_CREATE))
+    {
+        RIO_LOG("TaskProfiler::startTrace(): Could not open \"%s\".\n", path.c_str());
+        return false;
+    }
+
+    static const char header[] = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    mTraceHandle.write(reinterpret_cast<const u8*>(header), sizeof(header) - 1);
+
+    mTraceBuffer.resize(256 * cThreadEventCapacity);
+    mTraceFirstEvent = true;
+    return true;
+}
+
+void TaskProfiler::stopTrace()
+{
+    if (!isTracing())
+        return;
+
+    static const char footer[] = "\n]}\n";
+    mTraceHandle.write(reinterpret_cast<const u8*>(footer), sizeof(footer) - 1);
+    mTraceHandle.close();
+
+    mTraceBuffer.clear();
+    mTraceBuffer.shrink_to_fit();
+}
+
+void TaskProfiler::writeTrace_(const Event* events, u32 num, u32 thread_index)
+{
+    char* const buffer = mTraceBuffer.data();
+    const size_t capacity = mTraceBuffer.size();
+    size_t size = 0;
+
+    for (u32 i = 0; i < num; i++)
+    {
+        const Event& event = events[i];
+
+        // Complete event ("X"), timestamps in microseconds relative to the profiler's creation
+        const f64 ts = (event.begin_ns - mStartTime) / 1000.0;
+        const f64 dur = (event.end_ns - event.begin_ns) / 1000.0;
+
+        const s32 len = std::snprintf(buffer + size, capacity - size,
+                                      "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u}",
+                                      mTraceFirstEvent ? "" : ",\n",
+                                      event.name ? event.name : "", getStageName(Stage(event.stage)),
+                                      ts, dur, thread_index);
+
+        // Names are not escaped and must not contain quotes or backslashes
+        if (len < 0 || size_t(len) >= capacity - size)
+            break;
+
+        size += len;
+        mTraceFirstEvent = false;
+    }
+
+    if (size > 0)
+        mTraceHandle.write(reinterpret_cast<const u8*>(buffer), size);
+}
+
+const char* TaskProfiler::getStageName(Stage stage)
+{
+    switch (stage)
+    {
+    case STAGE_PREPARE: return "prepare";
+    case STAGE_ENTER:   return "enter";
+    case STAGE_CALC:    return "calc";
+    case STAGE_EXIT:    return "exit";
+    case STAGE_FRAME:   return "frame";
+    default:            return "";
+    }
+}
+
+}
+
+#endif // RIO_TASK_PROFILE
@@ -0,0 +1,231 @@
+#include <thread/rio_JobSystem.h>
+
+namespace {
+
+static thread_local s32 sThreadIndex = -1;
+
+}
+
+namespace rio {
+
+JobSystem* JobSystem::sInstance = nullptr;
+
+bool JobSystem::createSingleton(u32 worker_num)
+{
+    if (sInstance)
+        return false;
+
+    if (worker_num == cWorkerNumAuto)
+    {
+        const u32 hw_thread_num = std::thread::hardware_concurrency();
+        worker_num = hw_thread_num > 1 ? hw_thread_num - 1 : 0;
+    }
+
+    sInstance = new JobSystem(worker_num);
+    return true;
+}
+
+void JobSystem::destroySingleton()
+{
+    if (!sInstance)
+        return;
+
+    delete sInstance;
+    sInstance = nullptr;
+}
+
+JobSystem::JobDeque::JobDeque()
+    : mBuffer(64)
+    , mHead(0)
+    , mNum(0)
+{
+}
+
+void JobSystem::JobDeque::push(const Job& job)
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    const u32 capacity = mBuffer.size();
+    if (mNum == capacity)
+    {
+        // Grow, unrolling the ring to the start of the new buffer
+        std::vector<Job> buffer(capacity * 2);
+        for (u32 i = 0; i < mNum; i++)
+            buffer[i] = mBuffer[(mHead + i) & (capacity - 1)];
+
+        mBuffer.swap(buffer);
+        mHead = 0;
+    }
+
+    mBuffer[(mHead + mNum) & (mBuffer.size() - 1)] = job;
+    mNum++;
+}
+
+bool JobSystem::JobDeque::pop(Job* job)
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    if (mNum == 0)
+        return false;
+
+    mNum--;
+    *job = mBuffer[(mHead + mNum) & (mBuffer.size() - 1)];
+    return true;
+}
+
+bool JobSystem::JobDeque::steal(Job* job)
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    if (mNum == 0)
+        return false;
+
+    *job = mBuffer[mHead];
+    mHead = (mHead + 1) & (mBuffer.size() - 1);
+    mNum--;
+    return true;
+}
+
+JobSystem::JobSystem(u32 worker_num)
+    : mPendingNum(0)
+    , mExternalPushIndex(0)
+    , mExit(false)
+{
+    mDeques.reserve(1 + worker_num);
+    for (u32 i = 0; i < 1 + worker_num; i++)
+        mDeques.push_back(new JobDeque);
+
+    // The creating thread is the owner thread
+    sThreadIndex = 0;
+
+    mWorkers.reserve(worker_num);
+    for (u32 i = 0; i < worker_num; i++)
+        mWorkers.emplace_back(&JobSystem::workerMain_, this, 1 + i);
+
+    RIO_LOG("JobSystem: %u worker thread(s)\n", worker_num);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(mSleepCS);
+        mExit = true;
+    }
+    mSleepCond.notify_all();
+
+    for (std::thread& worker : mWorkers)
+        worker.join();
+
+    mWorkers.clear();
+
+    for (JobDeque* deque : mDeques)
+        delete deque;
+
+    mDeques.clear();
+
+    sThreadIndex = -1;
+}
+
+s32 JobSystem::getCurrentThreadIndex()
+{
+    return sThreadIndex;
+}
+
+void JobSystem::push(JobFunc func, void* arg, Counter* counter)
+{
+    RIO_ASSERT(func);
+
+    s32 thread_index = sThreadIndex;
+    RIO_ASSERT(thread_index < s32(mDeques.size()));
+
+    // Not part of the job system
+    if (thread_index < 0)
+        thread_index = mExternalPushIndex.fetch_add(1, std::memory_order_relaxed) % mDeques.size();
+
+    if (counter)
+        counter->mValue.fetch_add(1, std::memory_order_relaxed);
+
+    mDeques[thread_index]->push({ func, arg, counter });
+    mPendingNum.fetch_add(1, std::memory_order_release);
+
+    if (mWorkers.empty())
+        return;
+
+    {
+        // Lock to not miss a worker that is about to sleep
+        std::lock_guard<std::mutex> lock(mSleepCS);
+    }
+    mSleepCond.notify_one();
+}
+
+void JobSystem::wait(Counter* counter)
+{
+    RIO_ASSERT(counter);
+
+    const s32 thread_index = sThreadIndex;
+    RIO_ASSERT(thread_index < s32(mDeques.size()));
+
+    while (!counter->isDone())
+    {
+        if (!tryExecuteOne_(thread_index))
+            std::this_thread::yield();
+    }
+}
+
+bool JobSystem::tryExecuteOne_(s32 thread_index)
+{
+    Job job;
+    bool found = false;
+
+    const u32 thread_num = mDeques.size();
+
+    if (thread_index >= 0)
+    {
+        // Own deque first (LIFO for locality)...
+        found = mDeques[thread_index]->pop(&job);
+
+        // ... then steal from the others (FIFO)
+        for (u32 i = 1; i < thread_num && !found; i++)
+            found = mDeques[(thread_index + i) % thread_num]->steal(&job);
+    }
+    else
+    {
+        // Not part of the job system, steal only
+        for (u32 i = 0; i < thread_num && !found; i++)
+            found = mDeques[i]->steal(&job);
+    }
+
+    if (!found)
+        return false;
+
+    mPendingNum.fetch_sub(1, std::memory_order_relaxed);
+    execute_(job);
+    return true;
+}
+
+void JobSystem::execute_(const Job& job)
+{
+    (*job.func)(job.arg);
+
+    if (job.counter)
+        job.counter->mValue.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::workerMain_(u32 thread_index)
+{
+    sThreadIndex = thread_index;
+
+    while (true)
+    {
+        if (tryExecuteOne_(thread_index))
+            continue;
+
+        std::unique_lock<std::mutex> lock(mSleepCS);
+        mSleepCond.wait(lock, [this] { return mExit || mPendingNum.load(std::memory_order_acquire) > 0; });
+
+        if (mExit)
+            break;
+    }
+}
+
+}
@@ -0,0 +1,98 @@
+#include <thread/rio_WorkQueue.h>
+
+namespace rio {
+
+WorkQueue::WorkQueue(u32 thread_num, const char* name)
+    : mName(name)
+    , mRunningNum(0)
+    , mExit(false)
+{
+    RIO_ASSERT(thread_num > 0);
+
+    mThreads.reserve(thread_num);
+    for (u32 i = 0; i < thread_num; i++)
+        mThreads.emplace_back(&WorkQueue::threadMain_, this);
+}
+
+WorkQueue::~WorkQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(mCS);
+        mExit = true;
+        mItems.clear();
+    }
+    mItemCond.notify_all();
+
+    for (std::thread& thread : mThreads)
+        thread.join();
+
+    mThreads.clear();
+}
+
+void WorkQueue::push(WorkFunc func, void* arg, s32 priority)
+{
+    RIO_ASSERT(func);
+
+    {
+        std::lock_guard<std::mutex> lock(mCS);
+
+        // After all items of the same or higher priority
+        std::deque<Item>::iterator it = mItems.end();
+        while (it != mItems.begin() && (it - 1)->priority < priority)
+            --it;
+
+        mItems.insert(it, { func, arg, priority });
+    }
+    mItemCond.notify_one();
+}
+
+bool WorkQueue::cancel(WorkFunc func, void* arg)
+{
+    std::lock_guard<std::mutex> lock(mCS);
+
+    for (std::deque<Item>::iterator it = mItems.begin(); it != mItems.end(); ++it)
+    {
+        if (it->func == func && it->arg == arg)
+        {
+            mItems.erase(it);
+
+            if (mRunningNum == 0 && mItems.empty())
+                mIdleCond.notify_all();
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkQueue::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(mCS);
+    mIdleCond.wait(lock, [this] { return mItems.empty() && mRunningNum == 0; });
+}
+
+void WorkQueue::threadMain_()
+{
+    std::unique_lock<std::mutex> lock(mCS);
+
+    while (true)
+    {
+        mItemCond.wait(lock, [this] { return mExit || !mItems.empty(); });
+        if (mExit)
+            break;
+
+        const Item item = mItems.front();
+        mItems.pop_front();
+        mRunningNum++;
+
+        lock.unlock();
+        (*item.func)(item.arg);
+        lock.lock();
+
+        if (--mRunningNum == 0 && mItems.empty())
+            mIdleCond.notify_all();
+    }
+}
+
+}
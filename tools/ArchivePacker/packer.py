@@ -0,0 +1,131 @@
+# Built-in libraries
+import os
+import sys
+
+from struct import pack as f_pack
+
+
+# Must match rio::ArchiveFileDevice
+MAGIC = b'rioarchv'
+CURRENT_VERSION = 0x01000000
+
+HEADER_SIZE = 0x20
+ENTRY_SIZE = 0x10
+
+# Default data alignment (Enough for rio::FileDevice::cBufferMinAlignment and vertex buffers on both platforms)
+DEFAULT_ALIGNMENT = 0x40
+
+
+def align(x, y):
+    return ((x - 1) | (y - 1)) + 1
+
+
+def fnv1a(data):
+    # Must match rio::Hash::calcFNV1a()
+    hash = 0x811C9DC5
+    for byte in data:
+        hash = ((hash ^ byte) * 0x01000193) & 0xFFFFFFFF
+
+    return hash
+
+
+def collect(root):
+    # Paths relative to the root, with '/' separators, as passed to rio::FileDeviceMgr (without drive)
+    files = []
+    for dirpath, _, filenames in os.walk(root):
+        for filename in filenames:
+            fullpath = os.path.join(dirpath, filename)
+            path = os.path.relpath(fullpath, root).replace(os.sep, '/')
+            files.append((path, fullpath))
+
+    return files
+
+
+def pack(files, endianness, alignment):
+    entries = []
+    for path, fullpath in files:
+        encodedPath = path.encode('utf-8')
+        with open(fullpath, 'rb') as inf:
+            entries.append((fnv1a(encodedPath), encodedPath, inf.read()))
+
+    # Sorted by hash, then by path (Looked up by binary search)
+    entries.sort(key=lambda entry: (entry[0], entry[1]))
+
+    entriesPos = HEADER_SIZE
+    pathsPos = entriesPos + ENTRY_SIZE * len(entries)
+
+    paths = bytearray()
+    pathOffsets = []
+    for _, encodedPath, _ in entries:
+        pathOffsets.append(len(paths))
+        paths += encodedPath + b'\0'
+
+    dataPos = align(pathsPos + len(paths), alignment)
+
+    dataOffsets = []
+    curDataPos = dataPos
+    for _, _, fileData in entries:
+        curDataPos = align(curDataPos, alignment)
+        dataOffsets.append(curDataPos)
+        curDataPos += len(fileData)
+
+    fileSize = curDataPos
+
+    data = bytearray(MAGIC)
+    data += f_pack(endianness + "H", 0xFEFF)
+    data += f_pack(endianness + "H", 0)
+    data += f_pack(endianness + "I", CURRENT_VERSION)
+    data += f_pack(endianness + "I", fileSize)
+    data += f_pack(endianness + "I", len(entries))
+    data += f_pack(endianness + "I", entriesPos)
+    data += f_pack(endianness + "I", pathsPos)
+
+    assert len(data) == entriesPos
+    for (hash, _, fileData), pathOffset, dataOffset in zip(entries, pathOffsets, dataOffsets):
+        data += f_pack(endianness + "4I", hash, pathOffset, dataOffset, len(fileData))
+
+    assert len(data) == pathsPos
+    data += paths
+
+    for (_, _, fileData), dataOffset in zip(entries, dataOffsets):
+        data += b'\0' * (dataOffset - len(data))
+        data += fileData
+
+    assert len(data) == fileSize
+    return bytes(data)
+
+
+def main():
+    # Usage: packer.py [-be] [-align N] input_dir output_file
+    # (-be: big endian, for Wii U; little endian, for Windows, otherwise)
+    args = sys.argv[1:]
+
+    endianness = '<'
+    alignment = DEFAULT_ALIGNMENT
+
+    while len(args) > 2:
+        arg = args.pop(0)
+        if arg == '-be':
+            endianness = '>'
+
+        elif arg == '-align':
+            alignment = int(args.pop(0), 0)
+            assert alignment > 0 and alignment & (alignment - 1) == 0
+
+        else:
+            raise RuntimeError("Unknown option: %s" % arg)
+
+    if len(args) != 2 or not os.path.isdir(args[0]):
+        raise RuntimeError("Usage: packer.py [-be] [-align N] input_dir output_file")
+
+    root, output = args
+
+    files = collect(root)
+    with open(output, 'wb') as outf:
+        outf.write(pack(files, endianness, alignment))
+
+    print("Packed %d file(s) into %s" % (len(files), output))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,193 @@
+# Built-in libraries
+import os
+import sys
+
+from struct import pack as f_pack
+
+
+# Must match rio::Decompressor
+MAGIC = b'riocmprs'
+CURRENT_VERSION = 0x01000000
+
+CODEC_LZ4 = 1
+
+HEADER_SIZE = 0x20
+CHUNK_STORED = 0x80000000
+
+DEFAULT_CHUNK_SIZE = 0x10000
+
+# LZ4 block format constraints
+MIN_MATCH = 4
+LAST_LITERALS = 5       # The last 5 bytes are always literals
+MF_LIMIT = 12           # The last match must start at least 12 bytes before the end
+MAX_OFFSET = 0xFFFF
+HASH_LOG = 16
+
+
+def writeLength(out, length):
+    # Continuation of a length of 15 or more
+    length -= 15
+    while length >= 255:
+        out.append(255)
+        length -= 255
+
+    out.append(length)
+
+
+def writeSequence(out, literals, matchLen, offset):
+    literalLen = len(literals)
+    token = min(literalLen, 15) << 4
+    if matchLen:
+        token |= min(matchLen - MIN_MATCH, 15)
+
+    out.append(token)
+    if literalLen >= 15:
+        writeLength(out, literalLen)
+
+    out += literals
+
+    if matchLen:
+        out += f_pack("<H", offset)
+        if matchLen - MIN_MATCH >= 15:
+            writeLength(out, matchLen - MIN_MATCH)
+
+
+def compressLZ4(data):
+    # Greedy LZ4 block compression, with a hash table of the last position of each 4-byte sequence
+    size = len(data)
+    out = bytearray()
+
+    table = {}
+    anchor = 0
+    pos = 0
+    matchLimit = size - LAST_LITERALS
+
+    while pos < size - MF_LIMIT:
+        sequence = data[pos:pos + MIN_MATCH]
+        key = ((int.from_bytes(sequence, 'little') * 2654435761) & 0xFFFFFFFF) >> (32 - HASH_LOG)
+        ref = table.get(key)
+        table[key] = pos
+
+        if ref is None or pos - ref > MAX_OFFSET or data[ref:ref + MIN_MATCH] != sequence:
+            pos += 1
+            continue
+
+        matchLen = MIN_MATCH
+        while pos + matchLen < matchLimit and data[ref + matchLen] == data[pos + matchLen]:
+            matchLen += 1
+
+        writeSequence(out, data[anchor:pos], matchLen, pos - ref)
+
+        pos += matchLen
+        anchor = pos
+
+    writeSequence(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def compress(data, endianness, chunkSize):
+    chunks = []
+    for pos in range(0, len(data), chunkSize):
+        chunk = data[pos:pos + chunkSize]
+        compressed = compressLZ4(chunk)
+
+        # Chunks which do not compress are stored
+        if len(compressed) >= len(chunk):
+            chunks.append((len(chunk) | CHUNK_STORED, chunk))
+        else:
+            chunks.append((len(compressed), compressed))
+
+    out = bytearray(MAGIC)
+    out += f_pack(endianness + "H", 0xFEFF)
+    out += f_pack(endianness + "H", CODEC_LZ4)
+    out += f_pack(endianness + "I", CURRENT_VERSION)
+    out += f_pack(endianness + "I", len(data))
+    out += f_pack(endianness + "I", chunkSize)
+    out += f_pack(endianness + "I", len(chunks))
+    out += f_pack(endianness + "I", 0)
+
+    assert len(out) == HEADER_SIZE
+    for size, _ in chunks:
+        out += f_pack(endianness + "I", size)
+
+    for _, chunk in chunks:
+        out += chunk
+
+    return bytes(out)
+
+
+def compressFile(input, output, endianness, chunkSize):
+    with open(input, 'rb') as inf:
+        data = inf.read()
+
+    if not data:
+        raise RuntimeError("Empty file: %s" % input)
+
+    compressed = compress(data, endianness, chunkSize)
+
+    # Files which do not compress are copied as is (Loaded as usual)
+    if len(compressed) >= len(data):
+        compressed = data
+
+    with open(output, 'wb') as outf:
+        outf.write(compressed)
+
+    return len(data), len(compressed)
+
+
+def main():
+    # Usage: compress.py [-be] [-chunk N] input output
+    # (-be: big endian, for Wii U; little endian, for Windows, otherwise)
+    # If input is a directory, every file in it is compressed to the same path in the output directory.
+    args = sys.argv[1:]
+
+    endianness = '<'
+    chunkSize = DEFAULT_CHUNK_SIZE
+
+    while len(args) > 2:
+        arg = args.pop(0)
+        if arg == '-be':
+            endianness = '>'
+
+        elif arg == '-chunk':
+            chunkSize = int(args.pop(0), 0)
+            assert 0 < chunkSize < CHUNK_STORED
+
+        else:
+            raise RuntimeError("Unknown option: %s" % arg)
+
+    if len(args) != 2 or not os.path.exists(args[0]):
+        raise RuntimeError("Usage: compress.py [-be] [-chunk N] input output")
+
+    input, output = args
+
+    if os.path.isdir(input):
+        files = []
+        for dirpath, _, filenames in os.walk(input):
+            for filename in filenames:
+                fullpath = os.path.join(dirpath, filename)
+                files.append((fullpath, os.path.join(output, os.path.relpath(fullpath, input))))
+
+    else:
+        files = [(input, output)]
+
+    totalSize = 0
+    totalCompressedSize = 0
+
+    for inPath, outPath in files:
+        outDir = os.path.dirname(outPath)
+        if outDir:
+            os.makedirs(outDir, exist_ok=True)
+
+        size, compressedSize = compressFile(inPath, outPath, endianness, chunkSize)
+        totalSize += size
+        totalCompressedSize += compressedSize
+
+        print("%s: %d -> %d bytes (%.1f%%)" % (inPath, size, compressedSize, 100.0 * compressedSize / size))
+
+    if len(files) > 1 and totalSize:
+        print("Total: %d -> %d bytes (%.1f%%)" % (totalSize, totalCompressedSize, 100.0 * totalCompressedSize / totalSize))
+
+
+if __name__ == '__main__':
+    main()